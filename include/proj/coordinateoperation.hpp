@@ -2078,6 +2078,10 @@ class PROJ_GCC_DLL CoordinateOperationContext {
     PROJ_DLL const util::optional<common::DataEpoch> &
     getTargetCoordinateEpoch() const;
 
+    PROJ_DLL void setThreadCount(int threadCount);
+
+    PROJ_DLL int getThreadCount() const;
+
     PROJ_DLL static CoordinateOperationContextNNPtr
     create(const io::AuthorityFactoryPtr &authorityFactory,
            const metadata::ExtentPtr &extent, double accuracy);
@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * Project:  PROJ
+ * Purpose:  Map for concurrent lookups and rare insertions
+ *
+ ******************************************************************************
+ * Copyright (c) 2024, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef SNAPSHOT_MAP_HH_INCLUDED
+#define SNAPSHOT_MAP_HH_INCLUDED
+
+//! @cond Doxygen_Suppress
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "proj/util.hpp"
+
+NS_PROJ_START
+
+namespace internal {
+
+/** Map for frequent concurrent lookups and rare insertions.
+ *
+ * The content of the map is an immutable snapshot. Lookups atomically load
+ * the pointer to the current snapshot and search it without any lock held by
+ * the map, so they do not wait for writers. Writers copy the whole map,
+ * modify the copy and atomically publish it, so insertions are O(n).
+ *
+ * Note that std::atomic_load() on a shared_ptr is not necessarily
+ * lock-free: the standard library may guard it with a short internal lock.
+ */
+template <class Key, class Value> class SnapshotMap {
+  public:
+    typedef std::map<Key, Value> Map;
+
+    SnapshotMap() = default;
+    SnapshotMap(const SnapshotMap &) = delete;
+    SnapshotMap &operator=(const SnapshotMap &) = delete;
+
+    /** Returns the current content of the map. */
+    std::shared_ptr<const Map> snapshot() const {
+        return std::atomic_load(&map_);
+    }
+
+    /** Returns whether the map contains key. */
+    bool contains(const Key &key) const {
+        const auto map = snapshot();
+        return map->find(key) != map->end();
+    }
+
+    /** Copies the value associated with key to valueOut. */
+    bool find(const Key &key, Value &valueOut) const {
+        const auto map = snapshot();
+        const auto iter = map->find(key);
+        if (iter == map->end())
+            return false;
+        valueOut = iter->second;
+        return true;
+    }
+
+    /** Inserts or replaces the value associated with key. */
+    void insert(const Key &key, const Value &value) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        auto newMap = std::make_shared<Map>(*snapshot());
+        (*newMap)[key] = value;
+        std::atomic_store(&map_,
+                          std::shared_ptr<const Map>(std::move(newMap)));
+    }
+
+    /** Removes all entries. Snapshots still in use keep the previous content
+     * alive. */
+    void clear() {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        std::atomic_store(&map_, std::make_shared<const Map>());
+    }
+
+  private:
+    // Serializes writers, so that no insertion is lost. Never taken by
+    // lookups.
+    std::mutex writeMutex_{};
+    // Only accessed through std::atomic_load() and std::atomic_store()
+    std::shared_ptr<const Map> map_ = std::make_shared<const Map>();
+};
+
+} // namespace internal
+
+NS_PROJ_END
+
+//! @endcond
+
+#endif // SNAPSHOT_MAP_HH_INCLUDED
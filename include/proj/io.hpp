@@ -806,6 +806,8 @@ class PROJ_GCC_DLL WKTParser {
 
     PROJ_DLL WKTParser &setUnsetIdentifiersIfIncompatibleDef(bool unset);
 
+    PROJ_DLL WKTParser &setValidateGrammar(bool validate);
+
     PROJ_DLL util::BaseObjectNNPtr
     createFromWKT(const std::string &wkt); // throw(ParsingException)
 
@@ -923,6 +925,18 @@ class PROJ_GCC_DLL DatabaseContext {
 
     PROJ_DLL unsigned int getQueryCounter() const;
 
+    /** Execution statistics of a SQL query */
+    struct QueryStatistics {
+        std::string sql{};
+        unsigned long long count = 0;
+        unsigned long long rowCount = 0;
+        double totalTimeMs = 0;
+    };
+
+    PROJ_DLL void setQueryProfilingEnabled(bool enable);
+
+    PROJ_DLL std::vector<QueryStatistics> getQueryStatistics() const;
+
     PROJ_INTERNAL std::string
     getProjGridName(const std::string &oldProjGridName);
 
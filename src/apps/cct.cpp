@@ -82,6 +82,17 @@ Thomas Knudsen, thokn@sdfe.dk, 2016-05-25/2017-10-26
 #include <cstdint>
 #include <fstream> // std::ifstream
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(MSDOS) || defined(OS2) || defined(WIN32) || defined(__WIN32__)
+#include <fcntl.h>
+#include <io.h>
+#define SET_BINARY_MODE(file) _setmode(_fileno(file), O_BINARY)
+#else
+#define SET_BINARY_MODE(file)
+#endif
 
 #include "optargpm.h"
 #include "proj.h"
@@ -133,6 +144,10 @@ static const char usage[] = {
     "    --verbose         Alias for -v\n"
     "    --inverse         Alias for -I\n"
     "    --skip-lines      Alias for -s\n"
+    "    --binary          Read and write binary records of 4 little-endian\n"
+    "                      float64 values (x, y, z, t) instead of text\n"
+    "    --threads n       Transform coordinates with n threads. Input is\n"
+    "                      then processed in blocks, and output in order\n"
     "    --help            Alias for -h\n"
     "    --version         Print version number\n"
     "--------------------------------------------------------------------------"
@@ -215,6 +230,114 @@ static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...) {
     free(msg_buf);
 }
 
+/* Call fn(W, begin, end) on consecutive slices of [0, n), each slice being
+   processed by its own worker in its own thread, or in the calling thread if
+   the thread cannot be started */
+template <class Fn>
+static void for_each_slice(const std::vector<PJ *> &workers, size_t n,
+                           const Fn &fn) {
+    const size_t nworkers = std::min(workers.size(), n);
+    if (nworkers <= 1) {
+        fn(workers[0], 0, n);
+        return;
+    }
+    const size_t slice = (n + nworkers - 1) / nworkers;
+    std::vector<std::thread> threads;
+    for (size_t j = 1; j < nworkers; j++) {
+        const size_t begin = std::min(n, j * slice);
+        const size_t end = std::min(n, begin + slice);
+        try {
+            threads.emplace_back([&fn, &workers, j, begin, end]() {
+                fn(workers[j], begin, end);
+            });
+        } catch (const std::exception &) {
+            fn(workers[j], begin, end);
+        }
+    }
+    fn(workers[0], 0, slice);
+    for (auto &thread : threads)
+        thread.join();
+}
+
+/* Binary records are stored as little-endian float64 */
+static void swap_if_big_endian(PJ_COORD *coords, size_t n) {
+    const uint16_t byte_order_test = 1;
+    if (reinterpret_cast<const unsigned char *>(&byte_order_test)[0] == 1)
+        return;
+    unsigned char *data = reinterpret_cast<unsigned char *>(coords);
+    for (size_t i = 0; i < 4 * n; i++) {
+        std::reverse(data + 8 * i, data + 8 * i + 8);
+    }
+}
+
+/* Transform binary xyzt records in blocks. Returns false on read error. */
+static bool binary_input_loop(OPTARGS *o, const std::vector<PJ *> &workers,
+                              int skip_records, double fixed_z,
+                              double fixed_time, bool *gotError) {
+    PJ *P = workers[0];
+    const bool angular_input = proj_angular_input(P, PJ_FWD) != 0;
+    const bool angular_output = proj_angular_output(P, PJ_FWD) != 0;
+    constexpr size_t BLOCK_SIZE = 65536;
+    std::vector<PJ_COORD> block(BLOCK_SIZE);
+    bool ok = true;
+
+    while (opt_input_loop(o, optargs_file_format_binary, gotError)) {
+        if (o->input == stdin) {
+            SET_BINARY_MODE(stdin);
+        }
+        const size_t nbytes =
+            fread(block.data(), 1, BLOCK_SIZE * sizeof(PJ_COORD), o->input);
+        if (nbytes % sizeof(PJ_COORD) != 0) {
+            print(PJ_LOG_ERROR, "%s: Truncated record at end of file '%s'",
+                  o->progname, opt_filename(o));
+            ok = false;
+        }
+        size_t n = nbytes / sizeof(PJ_COORD);
+        if (n == 0)
+            continue;
+        swap_if_big_endian(block.data(), n);
+
+        PJ_COORD *coords = block.data();
+        if (skip_records > 0) {
+            const size_t skipped =
+                std::min(n, static_cast<size_t>(skip_records));
+            skip_records -= static_cast<int>(skipped);
+            coords += skipped;
+            n -= skipped;
+        }
+
+        for_each_slice(workers, n, [=](PJ *W, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (fixed_z != HUGE_VAL)
+                    coords[i].xyzt.z = fixed_z;
+                if (fixed_time != HUGE_VAL)
+                    coords[i].xyzt.t = fixed_time;
+                if (angular_input) {
+                    coords[i].lpzt.lam = proj_torad(coords[i].lpzt.lam);
+                    coords[i].lpzt.phi = proj_torad(coords[i].lpzt.phi);
+                }
+            }
+            /* Points that fail to transform are set to HUGE_VAL */
+            proj_trans_array(W, PJ_FWD, end - begin, coords + begin);
+            if (angular_output) {
+                for (size_t i = begin; i < end; i++) {
+                    if (coords[i].xyzt.x == HUGE_VAL)
+                        continue;
+                    coords[i].lpzt.lam = proj_todeg(coords[i].lpzt.lam);
+                    coords[i].lpzt.phi = proj_todeg(coords[i].lpzt.phi);
+                }
+            }
+        });
+
+        swap_if_big_endian(coords, n);
+        if (fwrite(coords, sizeof(PJ_COORD), n, fout) != n) {
+            print(PJ_LOG_ERROR, "%s: Write error", o->progname);
+            return false;
+        }
+    }
+    return ok;
+}
+
 int main(int argc, char **argv) {
     PJ *P = nullptr;
     PJ_COORD point;
@@ -227,11 +350,12 @@ int main(int argc, char **argv) {
     int decimals_angles = 10;
     int decimals_distances = 4;
     int columns_xyzt[] = {1, 2, 3, 4};
-    const char *longflags[] = {"v=verbose", "h=help", "I=inverse", "version",
-                               nullptr};
-    const char *longkeys[] = {"o=output", "c=columns", "d=decimals",
-                              "z=height", "t=time",    "s=skip-lines",
-                              nullptr};
+    int nthreads = 1;
+    const char *longflags[] = {"v=verbose", "h=help", "I=inverse",
+                               "version",   "binary", nullptr};
+    const char *longkeys[] = {"o=output", "c=columns",    "d=decimals",
+                              "z=height", "t=time",       "s=skip-lines",
+                              "threads",  nullptr};
 
     fout = stdout;
 
@@ -261,8 +385,12 @@ int main(int argc, char **argv) {
         return 0;
     }
 
-    if (opt_given(o, "o"))
-        fout = fopen(opt_arg(o, "output"), "wt");
+    const bool binary = opt_given(o, "binary") != 0;
+    if (opt_given(o, "o")) {
+        fout = fopen(opt_arg(o, "output"), binary ? "wb" : "wt");
+    } else if (binary) {
+        SET_BINARY_MODE(stdout);
+    }
     if (nullptr == fout) {
         print(PJ_LOG_ERROR, "%s: Cannot open '%s' for output", o->progname,
               opt_arg(o, "output"));
@@ -292,6 +420,27 @@ int main(int argc, char **argv) {
         skip_lines = atoi(opt_arg(o, "s"));
     }
 
+    if (opt_given(o, "threads")) {
+        nthreads = atoi(opt_arg(o, "threads"));
+        if (nthreads < 1) {
+            print(PJ_LOG_ERROR, "%s: Invalid number of threads: '%s'",
+                  o->progname, opt_arg(o, "threads"));
+            free(o);
+            if (stdout != fout)
+                fclose(fout);
+            return 1;
+        }
+    }
+
+    if (binary && opt_given(o, "c")) {
+        print(PJ_LOG_ERROR, "%s: --columns cannot be used with --binary",
+              o->progname);
+        free(o);
+        if (stdout != fout)
+            fclose(fout);
+        return 1;
+    }
+
     if (opt_given(o, "c")) {
         int ncols;
         /* reset column numbers to ease comment output later on */
@@ -429,11 +578,50 @@ int main(int argc, char **argv) {
     }
     direction = PJ_FWD;
 
+    /* Each additional thread transforms with its own copy of the operation,
+       in its own context */
+    std::vector<PJ *> workers{P};
+    for (int j = 1; j < nthreads; j++) {
+        PJ_CONTEXT *ctx = proj_context_create();
+        PJ *W = ctx ? proj_clone(ctx, P) : nullptr;
+        if (W == nullptr) {
+            print(PJ_LOG_DEBUG,
+                  "%s: Cannot clone the operation. Using %d thread(s)",
+                  o->progname, j);
+            proj_context_destroy(ctx);
+            break;
+        }
+        proj_log_level(ctx, proj_log_level(PJ_DEFAULT_CTX, PJ_LOG_TELL));
+        proj_log_func(ctx, (void *)fout, logger);
+        W->inverted = P->inverted;
+        workers.push_back(W);
+    }
+    const auto destroy_workers = [&workers]() {
+        for (size_t j = 1; j < workers.size(); j++) {
+            PJ_CONTEXT *ctx = workers[j]->ctx;
+            proj_destroy(workers[j]);
+            proj_context_destroy(ctx);
+        }
+    };
+
+    if (binary) {
+        bool gotError = false;
+        const bool ok = binary_input_loop(o, workers, skip_lines, fixed_z,
+                                          fixed_time, &gotError);
+        destroy_workers();
+        proj_destroy(P);
+        if (stdout != fout)
+            fclose(fout);
+        free(o);
+        return ok && !gotError ? 0 : 1;
+    }
+
     /* Allocate input buffer */
     constexpr int BUFFER_SIZE = 10000;
     char *buf = static_cast<char *>(calloc(1, BUFFER_SIZE));
     if (nullptr == buf) {
         print(PJ_LOG_ERROR, "%s: Out of memory", o->progname);
+        destroy_workers();
         proj_destroy(P);
         free(o);
         if (stdout != fout)
@@ -441,11 +629,116 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    /* Records are transformed once a block of them has been read. With a
+       single thread, the block is made of a single record so that cct can
+       be used interactively */
+    enum class RecordType { ECHO, UNREADABLE, POINT };
+    struct Record {
+        RecordType type = RecordType::ECHO;
+        std::string line{};
+        std::string filename{};
+        int record_index = 0;
+        PJ_COORD point{};
+        int err = 0;
+    };
+    const size_t block_size = workers.size() > 1 ? 10000 : 1;
+    std::vector<Record> records;
+
+    const auto flush_records = [&]() {
+        const bool angular_input = proj_angular_input(P, direction) != 0;
+        for_each_slice(workers, records.size(),
+                       [&records, angular_input](PJ *W, size_t begin,
+                                                 size_t end) {
+                           for (size_t j = begin; j < end; j++) {
+                               auto &rec = records[j];
+                               if (rec.type != RecordType::POINT)
+                                   continue;
+                               if (angular_input) {
+                                   rec.point.lpzt.lam =
+                                       proj_torad(rec.point.lpzt.lam);
+                                   rec.point.lpzt.phi =
+                                       proj_torad(rec.point.lpzt.phi);
+                               }
+                               const int err = proj_errno_reset(W);
+                               /* coverity[returned_value] */
+                               rec.point = proj_trans(W, PJ_FWD, rec.point);
+                               rec.err = proj_errno(W);
+                               proj_errno_restore(W, err);
+                           }
+                       });
+
+        for (auto &rec : records) {
+            char *bufptr = &rec.line[0];
+            point = rec.point;
+
+            if (rec.type == RecordType::ECHO) {
+                fprintf(fout, "%s", bufptr);
+                continue;
+            }
+
+            if (rec.type == RecordType::UNREADABLE) {
+                /* otherwise, it must be a syntax error */
+                print(PJ_LOG_NONE, "# Record %d UNREADABLE: %s",
+                      rec.record_index, bufptr);
+                print(PJ_LOG_ERROR, "%s: Could not parse file '%s' line %d",
+                      o->progname, rec.filename.c_str(),
+                      rec.record_index + 1);
+                continue;
+            }
+
+            if (HUGE_VAL == point.xyzt.x) {
+                /* transformation error */
+                print(PJ_LOG_NONE, "# Record %d TRANSFORMATION ERROR: %s (%s)",
+                      rec.record_index, bufptr, proj_errno_string(rec.err));
+                continue;
+            }
+
+            /* handle comment string */
+            char *comment = column(bufptr, nfields + 1);
+            if (opt_given(o, "c")) {
+                /* what number is the last coordinate column in the input
+                 * data? */
+                int colmax = 0;
+                for (i = 0; i < 4; i++)
+                    colmax = MAX(colmax, columns_xyzt[i]);
+                comment = column(bufptr, colmax + 1);
+            }
+            /* remove the line feed from comment, as logger() above, invoked
+               by print() below (output), will add one */
+            size_t len = strlen(comment);
+            if (len >= 1)
+                comment[len - 1] = '\0';
+            const char *comment_delimiter =
+                *comment ? whitespace : blank_comment;
+
+            /* Time to print the result */
+            /* use same arguments to printf format string for both radians and
+               degrees; convert radians to degrees before printing */
+            if (proj_angular_output(P, direction) ||
+                proj_degree_output(P, direction)) {
+                if (proj_angular_output(P, direction)) {
+                    point.lpzt.lam = proj_todeg(point.lpzt.lam);
+                    point.lpzt.phi = proj_todeg(point.lpzt.phi);
+                }
+                print(PJ_LOG_NONE, "%14.*f  %14.*f  %12.*f  %12.4f%s%s",
+                      decimals_angles, point.xyzt.x, decimals_angles,
+                      point.xyzt.y, decimals_distances, point.xyzt.z,
+                      point.xyzt.t, comment_delimiter, comment);
+            } else
+                print(PJ_LOG_NONE, "%13.*f  %13.*f  %12.*f  %12.4f%s%s",
+                      decimals_distances, point.xyzt.x, decimals_distances,
+                      point.xyzt.y, decimals_distances, point.xyzt.z,
+                      point.xyzt.t, comment_delimiter, comment);
+            if (fout == stdout)
+                fflush(stdout);
+        }
+        records.clear();
+    };
+
     /* Loop over all records of all input files */
     int previous_index = -1;
     bool gotError = false;
     while (opt_input_loop(o, optargs_file_format_text, &gotError)) {
-        int err;
         char *bufptr = fgets(buf, BUFFER_SIZE - 1, o->input);
         if (opt_eof(o)) {
             continue;
@@ -471,78 +764,28 @@ int main(int argc, char **argv) {
             continue;
         }
 
+        Record rec;
+        rec.line = bufptr;
+        rec.record_index = (int)o->record_index;
+        rec.point = point;
+
         /* if it's a comment or blank line, we reflect it */
         const char *c = column(bufptr, 1);
         if (c && ((*c == '\0') || (*c == '#'))) {
-            fprintf(fout, "%s", bufptr);
-            continue;
+            rec.type = RecordType::ECHO;
+        } else if (HUGE_VAL == point.xyzt.x) {
+            rec.type = RecordType::UNREADABLE;
+            rec.filename = opt_filename(o);
+        } else {
+            rec.type = RecordType::POINT;
         }
-
-        if (HUGE_VAL == point.xyzt.x) {
-            /* otherwise, it must be a syntax error */
-            print(PJ_LOG_NONE, "# Record %d UNREADABLE: %s",
-                  (int)o->record_index, bufptr);
-            print(PJ_LOG_ERROR, "%s: Could not parse file '%s' line %d",
-                  o->progname, opt_filename(o), opt_record(o));
-            continue;
-        }
-
-        if (proj_angular_input(P, direction)) {
-            point.lpzt.lam = proj_torad(point.lpzt.lam);
-            point.lpzt.phi = proj_torad(point.lpzt.phi);
-        }
-        err = proj_errno_reset(P);
-        /* coverity[returned_value] */
-        point = proj_trans(P, direction, point);
-
-        if (HUGE_VAL == point.xyzt.x) {
-            /* transformation error */
-            print(PJ_LOG_NONE, "# Record %d TRANSFORMATION ERROR: %s (%s)",
-                  (int)o->record_index, bufptr,
-                  proj_errno_string(proj_errno(P)));
-            proj_errno_restore(P, err);
-            continue;
-        }
-        proj_errno_restore(P, err);
-
-        /* handle comment string */
-        char *comment = column(bufptr, nfields + 1);
-        if (opt_given(o, "c")) {
-            /* what number is the last coordinate column in the input data? */
-            int colmax = 0;
-            for (i = 0; i < 4; i++)
-                colmax = MAX(colmax, columns_xyzt[i]);
-            comment = column(bufptr, colmax + 1);
-        }
-        /* remove the line feed from comment, as logger() above, invoked
-           by print() below (output), will add one */
-        size_t len = strlen(comment);
-        if (len >= 1)
-            comment[len - 1] = '\0';
-        const char *comment_delimiter = *comment ? whitespace : blank_comment;
-
-        /* Time to print the result */
-        /* use same arguments to printf format string for both radians and
-           degrees; convert radians to degrees before printing */
-        if (proj_angular_output(P, direction) ||
-            proj_degree_output(P, direction)) {
-            if (proj_angular_output(P, direction)) {
-                point.lpzt.lam = proj_todeg(point.lpzt.lam);
-                point.lpzt.phi = proj_todeg(point.lpzt.phi);
-            }
-            print(PJ_LOG_NONE, "%14.*f  %14.*f  %12.*f  %12.4f%s%s",
-                  decimals_angles, point.xyzt.x, decimals_angles, point.xyzt.y,
-                  decimals_distances, point.xyzt.z, point.xyzt.t,
-                  comment_delimiter, comment);
-        } else
-            print(PJ_LOG_NONE, "%13.*f  %13.*f  %12.*f  %12.4f%s%s",
-                  decimals_distances, point.xyzt.x, decimals_distances,
-                  point.xyzt.y, decimals_distances, point.xyzt.z, point.xyzt.t,
-                  comment_delimiter, comment);
-        if (fout == stdout)
-            fflush(stdout);
+        records.push_back(std::move(rec));
+        if (records.size() >= block_size)
+            flush_records();
     }
+    flush_records();
 
+    destroy_workers();
     proj_destroy(P);
 
     if (stdout != fout)
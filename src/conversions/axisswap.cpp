@@ -154,6 +154,35 @@ static void pj_axisswap_reverse_4d(PJ_COORD &coo, PJ *P) {
     coo = out;
 }
 
+static bool pj_axisswap_get_axis_map(const PJ *P, PJ_DIRECTION direction,
+                                     PJ_AXIS_MAP &map) {
+    const struct pj_axisswap_data *Q =
+        (const struct pj_axisswap_data *)P->opaque;
+    unsigned int i;
+
+    /* Axes beyond the ones specified (flagged with indices 4-7) are left */
+    /* untouched. Swapping time with a spatial axis cannot be expressed   */
+    /* as a PJ_AXIS_MAP. */
+    for (i = 0; i < 4; i++) {
+        const unsigned int axis = Q->axis[i] > 3 ? i : Q->axis[i];
+        const double sign = Q->axis[i] > 3 ? 1.0 : Q->sign[i];
+        if ((i == 3) != (axis == 3))
+            return false;
+        if (i == 3) {
+            map.tsign = sign;
+        } else if (direction == PJ_FWD) {
+            map.axis[i] = static_cast<int>(axis);
+            map.factor[i] = sign;
+            map.divide[i] = false;
+        } else {
+            map.axis[axis] = static_cast<int>(i);
+            map.factor[axis] = sign;
+            map.divide[axis] = false;
+        }
+    }
+    return true;
+}
+
 /***********************************************************************/
 PJ *PJ_CONVERSION(axisswap, 0) {
     /***********************************************************************/
@@ -287,6 +316,7 @@ PJ *PJ_CONVERSION(axisswap, 0) {
         proj_log_error(P, _("axisswap: bad axis order"));
         return pj_default_destructor(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
     }
+    P->get_axis_map = pj_axisswap_get_axis_map;
 
     if (pj_param(P->ctx, P->params, "tangularunits").i) {
         P->left = PJ_IO_UNITS_RADIANS;
@@ -391,6 +391,28 @@ static void reverse_4d(PJ_COORD &coo, PJ *P) {
         coo.xyzt.t = time_units[Q->t_in_id].t_out(coo.xyzt.t);
 }
 
+/***********************************************************************/
+static bool get_axis_map(const PJ *P, PJ_DIRECTION direction,
+                         PJ_AXIS_MAP &map) {
+    /************************************************************************
+        Unit conversions of physical dimensions are scalings, done as in
+        forward_3d() and reverse_3d(), but time conversions are not
+        necessarily linear
+    ************************************************************************/
+    const struct pj_opaque_unitconvert *Q =
+        (const struct pj_opaque_unitconvert *)P->opaque;
+    if (Q->t_in_id >= 0 || Q->t_out_id >= 0)
+        return false;
+
+    for (int i = 0; i < 3; i++) {
+        map.axis[i] = i;
+        map.factor[i] = i < 2 ? Q->xy_factor : Q->z_factor;
+        map.divide[i] = direction != PJ_FWD;
+    }
+    map.tsign = 1.0;
+    return true;
+}
+
 /***********************************************************************/
 static double get_unit_conversion_factor(const char *name, int *p_is_linear,
                                          const char **p_normalized_name) {
@@ -458,6 +480,7 @@ PJ *PJ_CONVERSION(unitconvert, 0) {
     P->inv3d = reverse_3d;
     P->fwd = forward_2d;
     P->inv = reverse_2d;
+    P->get_axis_map = get_axis_map;
 
     P->left = PJ_IO_UNITS_WHATEVER;
     P->right = PJ_IO_UNITS_WHATEVER;
@@ -27,14 +27,18 @@
  *****************************************************************************/
 
 #define FROM_PROJ_CPP
+#define LRU11_DO_NOT_DEFINE_OUT_OF_CLASS_METHODS
 
 #include "proj.h"
 #include "proj_internal.h"
 #include <math.h>
 
 #include <algorithm>
+#include <memory>
 
 #include "proj/internal/internal.hpp"
+#include "proj/internal/lru_cache.hpp"
+#include "proj/io.hpp"
 
 using namespace NS_PROJ::internal;
 
@@ -315,6 +319,159 @@ static PJ *create_operation_geocentric_crs_to_geog_crs(PJ_CONTEXT *ctx,
     return op;
 }
 
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+
+/** Cache of the objects returned by proj_create_crs_to_crs() and
+ * proj_create_crs_to_crs_from_pj(), owned by a context. Entries are private
+ * clones: a cache hit returns a new clone of them, with proj_clone(), which
+ * instantiates again each alternative operation from its PROJ pipeline. */
+struct projCrsToCrsCache {
+    NS_PROJ::lru11::Cache<std::string, std::shared_ptr<PJ>,
+                          NS_PROJ::lru11::NullLock>
+        cache;
+
+    explicit projCrsToCrsCache(size_t maxSize) : cache(maxSize, 0) {}
+};
+
+void pj_delete_crs_to_crs_cache(projCrsToCrsCache *cache) { delete cache; }
+
+void pj_clear_crs_to_crs_cache(PJ_CONTEXT *ctx) {
+    pj_delete_crs_to_crs_cache(ctx->crsToCrsCache);
+    ctx->crsToCrsCache = nullptr;
+}
+
+/** Returns the key of the cache for a source/target pair, or an empty string
+ * if the cache is disabled. */
+static std::string crs_to_crs_cache_key(PJ_CONTEXT *ctx, const char *source,
+                                        const char *target, const PJ_AREA *area,
+                                        const char *const *options) {
+    if (ctx->crsToCrsCacheMaxSize <= 0 || source == nullptr ||
+        target == nullptr)
+        return std::string();
+    std::string key(source);
+    key += '\0';
+    key += target;
+    key += '\0';
+    if (area && area->bbox_set) {
+        key += toString(area->west_lon_degree, 17);
+        key += ',';
+        key += toString(area->south_lat_degree, 17);
+        key += ',';
+        key += toString(area->east_lon_degree, 17);
+        key += ',';
+        key += toString(area->north_lat_degree, 17);
+        key += ',';
+        key += area->name;
+    }
+    key += '\0';
+    for (auto iter = options; iter && iter[0]; ++iter) {
+        key += *iter;
+        key += '\0';
+    }
+    // Determines whether operations with missing grids are kept
+    key += proj_context_is_network_enabled(ctx) ? '1' : '0';
+    return key;
+}
+
+/** Returns the single-line PROJJSON export of a CRS, used in the key of the
+ * cache for proj_create_crs_to_crs_from_pj(), or an empty string if it cannot
+ * be exported. */
+static std::string crs_to_crs_cache_crs_json(const PJ *crs) {
+    auto exportable =
+        dynamic_cast<const NS_PROJ::io::IJSONExportable *>(crs->iso_obj.get());
+    if (!exportable)
+        return std::string();
+    try {
+        auto formatter = NS_PROJ::io::JSONFormatter::create();
+        formatter->setMultiLine(false);
+        return exportable->exportToJSON(formatter.get());
+    } catch (const std::exception &) {
+        return std::string();
+    }
+}
+
+static PJ *crs_to_crs_cache_get(PJ_CONTEXT *ctx, const std::string &key) {
+    std::shared_ptr<PJ> cached;
+    if (key.empty() || ctx->crsToCrsCache == nullptr ||
+        !ctx->crsToCrsCache->cache.tryGet(key, cached)) {
+        return nullptr;
+    }
+    return proj_clone(ctx, cached.get());
+}
+
+static void crs_to_crs_cache_insert(PJ_CONTEXT *ctx, const std::string &key,
+                                    const PJ *P) {
+    if (key.empty() || P == nullptr)
+        return;
+    std::shared_ptr<PJ> cached(proj_clone(ctx, P), proj_destroy);
+    if (!cached)
+        return;
+    if (ctx->crsToCrsCache == nullptr) {
+        ctx->crsToCrsCache = new projCrsToCrsCache(
+            static_cast<size_t>(ctx->crsToCrsCacheMaxSize));
+    }
+    ctx->crsToCrsCache->cache.insert(key, cached);
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** \brief Set the maximum number of entries of the cache of operations
+ * created by proj_create_crs_to_crs() and proj_create_crs_to_crs_from_pj()
+ * with this context.
+ *
+ * Requests with the same source and target CRS, area of interest and options
+ * as a previous one then return a clone of the cached operation, instead of
+ * looking up candidate operations again. Note that only the database lookup
+ * is saved: cloning instantiates again each candidate operation, so for pairs
+ * with many candidate operations a cache hit still has a significant cost.
+ * The cache is cleared when the database path, the resource search paths or
+ * the file finder of the context are changed, and by proj_cleanup() for the
+ * default context.
+ *
+ * The cache is disabled by default. A cloned context inherits the maximum
+ * number of entries, but not the entries themselves.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param max_entries Maximum number of entries, or 0 to disable and clear the
+ * cache.
+ * @since 9.6
+ */
+void proj_crs_to_crs_cache_set_max_size(PJ_CONTEXT *ctx, int max_entries) {
+    if (!ctx) {
+        ctx = pj_get_default_ctx();
+    }
+    pj_clear_crs_to_crs_cache(ctx);
+    ctx->crsToCrsCacheMaxSize = std::max(0, max_entries);
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Remove all entries from the cache of operations of
+ * proj_create_crs_to_crs().
+ *
+ * This should be called when grids have been installed or removed after the
+ * cache has been filled, for the next calls to take them into account.
+ *
+ * @param ctx PROJ context, or NULL
+ * @since 9.6
+ */
+void proj_crs_to_crs_cache_clear(PJ_CONTEXT *ctx) {
+    if (!ctx) {
+        ctx = pj_get_default_ctx();
+    }
+    pj_clear_crs_to_crs_cache(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
+static PJ *create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
+                                     const PJ *target_crs, PJ_AREA *area,
+                                     const char *const *options);
+
 /*****************************************************************************/
 PJ *proj_create_crs_to_crs(PJ_CONTEXT *ctx, const char *source_crs,
                            const char *target_crs, PJ_AREA *area) {
@@ -329,6 +486,16 @@ PJ *proj_create_crs_to_crs(PJ_CONTEXT *ctx, const char *source_crs,
         ctx = pj_get_default_ctx();
     }
 
+    std::string cacheKey;
+    try {
+        cacheKey = crs_to_crs_cache_key(ctx, source_crs, target_crs, area,
+                                        nullptr);
+    } catch (const std::exception &) {
+    }
+    if (PJ *cachedP = crs_to_crs_cache_get(ctx, cacheKey)) {
+        return cachedP;
+    }
+
     PJ *src;
     PJ *dst;
     try {
@@ -351,9 +518,10 @@ PJ *proj_create_crs_to_crs(PJ_CONTEXT *ctx, const char *source_crs,
         return nullptr;
     }
 
-    auto ret = proj_create_crs_to_crs_from_pj(ctx, src, dst, area, nullptr);
+    auto ret = create_crs_to_crs_from_pj(ctx, src, dst, area, nullptr);
     proj_destroy(src);
     proj_destroy(dst);
+    crs_to_crs_cache_insert(ctx, cacheKey, ret);
     return ret;
 }
 
@@ -490,6 +658,39 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
     if (!ctx) {
         ctx = pj_get_default_ctx();
     }
+
+    // CRS objects are keyed by their PROJJSON export, which is much cheaper
+    // than looking up operations
+    std::string cacheKey;
+    if (ctx->crsToCrsCacheMaxSize > 0 && source_crs && target_crs) {
+        const auto sourceJson = crs_to_crs_cache_crs_json(source_crs);
+        const auto targetJson = crs_to_crs_cache_crs_json(target_crs);
+        if (!sourceJson.empty() && !targetJson.empty()) {
+            try {
+                cacheKey = crs_to_crs_cache_key(ctx, sourceJson.c_str(),
+                                                targetJson.c_str(), area,
+                                                options);
+            } catch (const std::exception &) {
+            }
+        }
+    }
+    if (PJ *cachedP = crs_to_crs_cache_get(ctx, cacheKey)) {
+        return cachedP;
+    }
+
+    auto ret =
+        create_crs_to_crs_from_pj(ctx, source_crs, target_crs, area, options);
+    crs_to_crs_cache_insert(ctx, cacheKey, ret);
+    return ret;
+}
+
+/*****************************************************************************/
+static PJ *create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
+                                     const PJ *target_crs, PJ_AREA *area,
+                                     const char *const *options) {
+    /******************************************************************************
+        Implementation of proj_create_crs_to_crs_from_pj(), without the cache.
+    ******************************************************************************/
     pj_load_ini(
         ctx); // to set ctx->errorIfBestTransformationNotAvailableDefault
 
@@ -780,6 +981,8 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
     }
 
     P->alternativeCoordinateOperations = std::move(preparedOpList);
+    P->alternativeCoordinateOperationsIndex =
+        pj_create_coord_operation_index(P->alternativeCoordinateOperations);
     // The returned P is rather dummy
     P->descr = "Set of coordinate operations";
     P->over = forceOver;
@@ -68,6 +68,9 @@ PJ_CONTEXT *pj_get_ctx(PJ *pj)
 void proj_assign_context(PJ *pj, PJ_CONTEXT *ctx) {
     if (pj == nullptr)
         return;
+    // Bounds computed with the previous context, whose settings may differ
+    if (pj->ctx != ctx)
+        pj->transBoundsCache.reset();
     pj->ctx = ctx;
     if (pj->reassign_context) {
         pj->reassign_context(pj, ctx);
@@ -130,6 +133,8 @@ projCppContext *pj_ctx::get_cpp_context() {
 
 void pj_ctx::set_search_paths(const std::vector<std::string> &search_paths_in) {
     lookupedFiles.clear();
+    pj_clear_crs_to_crs_cache(this);
+    pj_clear_create_cache(this);
     search_paths = search_paths_in;
     delete[] c_compat_paths;
     c_compat_paths = nullptr;
@@ -177,7 +182,12 @@ pj_ctx::pj_ctx(const pj_ctx &other)
       defaultTmercAlgo(other.defaultTmercAlgo),
       // END ini file settings
       projStringParserCreateFromPROJStringRecursionCounter(0),
-      pipelineInitRecursiongCounter(0) {
+      pipelineInitRecursiongCounter(0),
+      crsToCrsCacheMaxSize(other.crsToCrsCacheMaxSize),
+      createCacheMaxSize(other.createCacheMaxSize),
+      gridMemoryMapping(other.gridMemoryMapping),
+      precomputedInverseGrids(other.precomputedInverseGrids),
+      gridReadAheadThreads(other.gridReadAheadThreads) {
     set_search_paths(other.search_paths);
 }
 
@@ -198,6 +208,10 @@ PJ_CONTEXT *pj_get_default_ctx()
 /************************************************************************/
 
 pj_ctx::~pj_ctx() {
+    // Cached operations may need the rest of the context to be destroyed
+    pj_delete_crs_to_crs_cache(crsToCrsCache);
+    pj_delete_create_cache(createCache);
+    pj_delete_grid_read_ahead_pool(gridReadAheadPool);
     delete[] c_compat_paths;
     proj_context_delete_cpp_context(cpp_context);
 }
@@ -230,7 +244,7 @@ int proj_context_errno(PJ_CONTEXT *ctx) {
     ******************************************************************************/
     if (nullptr == ctx)
         ctx = pj_get_default_ctx();
-    return ctx->last_errno;
+    return pj_ctx_last_errno(ctx);
 }
 
 /*****************************************************************************/
@@ -65,6 +65,7 @@
 #ifdef HAVE_LIBDL
 #include <dlfcn.h>
 #endif
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -89,6 +90,16 @@ File::~File() = default;
 
 // ---------------------------------------------------------------------------
 
+std::string File::contentIdentity() {
+    const auto pos = tell();
+    seek(0, SEEK_END);
+    const auto size = tell();
+    seek(pos);
+    return name_ + '\0' + std::to_string(size);
+}
+
+// ---------------------------------------------------------------------------
+
 std::string File::read_line(size_t maxLen, bool &maxLenReached,
                             bool &eofReached) {
     constexpr size_t MAX_MAXLEN = 1024 * 1024;
@@ -614,6 +625,8 @@ class FileWin32 : public File {
     // We may lie, but the real use case is only for network files
     bool hasChanged() const override { return false; }
 
+    std::string contentIdentity() override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access);
 };
@@ -624,6 +637,25 @@ FileWin32::~FileWin32() { CloseHandle(m_handle); }
 
 // ---------------------------------------------------------------------------
 
+std::string FileWin32::contentIdentity() {
+    BY_HANDLE_FILE_INFORMATION info;
+    if (!GetFileInformationByHandle(m_handle, &info))
+        return File::contentIdentity();
+    std::string ret(name_);
+    ret += '\0';
+    ret += std::to_string((static_cast<unsigned long long>(info.nFileSizeHigh)
+                           << 32) |
+                          info.nFileSizeLow);
+    ret += '\0';
+    ret += std::to_string(
+        (static_cast<unsigned long long>(info.ftLastWriteTime.dwHighDateTime)
+         << 32) |
+        info.ftLastWriteTime.dwLowDateTime);
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
 size_t FileWin32::read(void *buffer, size_t sizeBytes) {
     DWORD dwSizeRead = 0;
     size_t nResult = 0;
@@ -735,13 +767,18 @@ std::unique_ptr<File> FileWin32::open(PJ_CONTEXT *ctx, const char *filename,
 class FileStdio : public File {
     PJ_CONTEXT *m_ctx;
     FILE *m_fp;
+    bool m_readOnly;
+    bool m_mappingAttempted = false;
+    const unsigned char *m_mapping = nullptr;
+    size_t m_mappingSize = 0;
 
     FileStdio(const FileStdio &) = delete;
     FileStdio &operator=(const FileStdio &) = delete;
 
   protected:
-    FileStdio(const std::string &filename, PJ_CONTEXT *ctx, FILE *fp)
-        : File(filename), m_ctx(ctx), m_fp(fp) {}
+    FileStdio(const std::string &filename, PJ_CONTEXT *ctx, FILE *fp,
+              bool readOnly)
+        : File(filename), m_ctx(ctx), m_fp(fp), m_readOnly(readOnly) {}
 
   public:
     ~FileStdio() override;
@@ -755,13 +792,78 @@ class FileStdio : public File {
     // We may lie, but the real use case is only for network files
     bool hasChanged() const override { return false; }
 
+    const unsigned char *mappedData(unsigned long long &size) override;
+
+    std::string contentIdentity() override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access);
 };
 
 // ---------------------------------------------------------------------------
 
-FileStdio::~FileStdio() { fclose(m_fp); }
+FileStdio::~FileStdio() {
+    if (m_mapping) {
+        munmap(const_cast<unsigned char *>(m_mapping), m_mappingSize);
+    }
+    fclose(m_fp);
+}
+
+// ---------------------------------------------------------------------------
+
+std::string FileStdio::contentIdentity() {
+    struct stat sb;
+    if (fstat(fileno(m_fp), &sb) != 0)
+        return File::contentIdentity();
+    std::string ret(name_);
+    ret += '\0';
+    ret += std::to_string(static_cast<unsigned long long>(sb.st_size));
+    ret += '\0';
+    ret += std::to_string(static_cast<long long>(sb.st_mtime));
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
+// The file is mapped the first time this method is called, so that only
+// users that can take advantage of it (grids) pay for the mapping. Mapping is
+// only done when enabled with proj_context_set_enable_grid_memory_mapping().
+const unsigned char *FileStdio::mappedData(unsigned long long &size) {
+    if (!m_mappingAttempted && m_ctx->gridMemoryMapping) {
+        m_mappingAttempted = true;
+        struct stat sb;
+        if (m_readOnly && fstat(fileno(m_fp), &sb) == 0 &&
+            S_ISREG(sb.st_mode) && sb.st_size > 0 &&
+            static_cast<unsigned long long>(sb.st_size) <=
+                std::numeric_limits<size_t>::max()) {
+            const size_t mappingSize = static_cast<size_t>(sb.st_size);
+            // Changes made to the file afterwards may or may not be seen
+            // through the mapping (they are on Linux, even with MAP_PRIVATE),
+            // and accessing pages past its end once the file has been
+            // truncated raises SIGBUS. This is why mapping is opt-in, for
+            // grid files that are not modified in place.
+            void *mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE,
+                                 fileno(m_fp), 0);
+            // Make sure the file has not been truncated in the meantime. Later
+            // truncations are not detected.
+            if (mapping != MAP_FAILED &&
+                (fstat(fileno(m_fp), &sb) != 0 ||
+                 static_cast<unsigned long long>(sb.st_size) != mappingSize)) {
+                munmap(mapping, mappingSize);
+                mapping = MAP_FAILED;
+            }
+            if (mapping != MAP_FAILED) {
+                m_mapping = static_cast<const unsigned char *>(mapping);
+                m_mappingSize = mappingSize;
+            } else {
+                pj_log(m_ctx, PJ_LOG_DEBUG, "Cannot memory-map %s",
+                       name_.c_str());
+            }
+        }
+    }
+    size = m_mappingSize;
+    return m_mapping;
+}
 
 // ---------------------------------------------------------------------------
 
@@ -801,8 +903,9 @@ std::unique_ptr<File> FileStdio::open(PJ_CONTEXT *ctx, const char *filename,
     auto fp = fopen(filename, access == FileAccess::READ_ONLY     ? "rb"
                               : access == FileAccess::READ_UPDATE ? "r+b"
                                                                   : "w+b");
-    return std::unique_ptr<File>(fp ? new FileStdio(filename, ctx, fp)
-                                    : nullptr);
+    return std::unique_ptr<File>(
+        fp ? new FileStdio(filename, ctx, fp, access == FileAccess::READ_ONLY)
+           : nullptr);
 }
 
 #endif // _WIN32
@@ -922,6 +1025,11 @@ class FileMemory : public File {
 
     bool hasChanged() const override { return false; }
 
+    const unsigned char *mappedData(unsigned long long &size) override {
+        size = m_size;
+        return m_data;
+    }
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access,
                                       const unsigned char *data, size_t size) {
@@ -2098,6 +2206,8 @@ void proj_context_set_file_finder(PJ_CONTEXT *ctx, proj_file_finder finder,
         ctx = pj_get_default_ctx();
     if (!ctx)
         return;
+    pj_clear_crs_to_crs_cache(ctx);
+    pj_clear_create_cache(ctx);
     ctx->file_finder = finder;
     ctx->file_finder_user_data = user_data;
 }
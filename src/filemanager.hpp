@@ -29,7 +29,9 @@
 #define FILEMANAGER_HPP_INCLUDED
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "proj.h"
@@ -90,10 +92,38 @@ class File {
     virtual unsigned long long tell() = 0;
     virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
     virtual bool hasChanged() const = 0;
+
+    // Return a string identifying the content of the file: its name, size,
+    // and when available its modification time or ETag, so that a file
+    // replaced by another one under the same name gets another identity.
+    virtual std::string contentIdentity();
+
+    // Return a pointer to the whole content of the file, when it can be
+    // accessed directly in memory (memory-mapped or embedded file), or
+    // nullptr otherwise. The pointer is valid during the lifetime of the
+    // object.
+    virtual const unsigned char *mappedData(unsigned long long &size) {
+        size = 0;
+        return nullptr;
+    }
+
+    // Hint that the given (offset, size) byte ranges will be read soon.
+    // Implementations for which reads are costly, such as network files,
+    // may fetch them in advance.
+    virtual void
+    prefetch(const std::vector<std::pair<unsigned long long, size_t>> &) {}
+
     std::string PROJ_DLL read_line(size_t maxLen, bool &maxLenReached,
                                    bool &eofReached);
 
     const std::string &name() const { return name_; }
+
+    // Mutex serializing the accesses to the file, and to the caches of the
+    // grids read from it, by threads sharing a compiled transformation.
+    std::mutex &sharedAccessMutex() { return sharedAccessMutex_; }
+
+  private:
+    std::mutex sharedAccessMutex_{};
 };
 
 // ---------------------------------------------------------------------------
@@ -174,10 +174,10 @@ static void fwd_finalize(PJ *P, PJ_COORD &coo) {
 }
 
 static inline PJ_COORD error_or_coord(PJ *P, PJ_COORD coord, int last_errno) {
-    if (P->ctx->last_errno)
+    if (pj_ctx_last_errno(P->ctx))
         return proj_coord_error();
 
-    P->ctx->last_errno = last_errno;
+    pj_ctx_last_errno(P->ctx) = last_errno;
 
     return coord;
 }
@@ -186,8 +186,8 @@ PJ_XY pj_fwd(PJ_LP lp, PJ *P) {
     PJ_COORD coo = {{0, 0, 0, 0}};
     coo.lp = lp;
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_fwd_prepare)
         fwd_prepare(P, coo);
@@ -221,8 +221,8 @@ PJ_XYZ pj_fwd3d(PJ_LPZ lpz, PJ *P) {
     PJ_COORD coo = {{0, 0, 0, 0}};
     coo.lpz = lpz;
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_fwd_prepare)
         fwd_prepare(P, coo);
@@ -254,8 +254,8 @@ PJ_XYZ pj_fwd3d(PJ_LPZ lpz, PJ *P) {
 
 bool pj_fwd4d(PJ_COORD &coo, PJ *P) {
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_fwd_prepare)
         fwd_prepare(P, coo);
@@ -286,11 +286,57 @@ bool pj_fwd4d(PJ_COORD &coo, PJ *P) {
     if (!P->skip_fwd_finalize)
         fwd_finalize(P, coo);
 
-    if (P->ctx->last_errno) {
+    if (pj_ctx_last_errno(P->ctx)) {
         coo = proj_coord_error();
         return false;
     }
 
-    P->ctx->last_errno = last_errno;
+    pj_ctx_last_errno(P->ctx) = last_errno;
     return true;
 }
+
+/* Block-wise counterpart of pj_fwd4d(). Prepare and finalize are still done
+ * per coordinate, but the operator itself is applied to the whole block when
+ * P provides a batch kernel. Coordinates whose x component is HUGE_VAL on
+ * input are left untouched, so that a block can flow through the steps of a
+ * pipeline while failed coordinates drop out, as they do in the scalar
+ * path. */
+void pj_fwd4d_batch(PJ_COORD *coo, size_t n, PJ *P) {
+    if (!P->fwd4d_batch) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                pj_fwd4d(coo[i], P);
+        }
+        return;
+    }
+
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
+
+    if (!P->skip_fwd_prepare) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL == coo[i].v[0])
+                continue;
+            fwd_prepare(P, coo[i]);
+            if (HUGE_VAL == coo[i].v[0])
+                coo[i] = proj_coord_error();
+        }
+    }
+
+    P->fwd4d_batch(coo, n, P);
+
+    for (size_t i = 0; i < n; i++) {
+        if (HUGE_VAL == coo[i].v[0]) {
+            coo[i] = proj_coord_error();
+            continue;
+        }
+        if (!P->skip_fwd_finalize)
+            fwd_finalize(P, coo[i]);
+    }
+
+    /* Contrary to pj_fwd4d(), an error raised here cannot be attributed to
+     * a given coordinate: batch kernels flag their failures with HUGE_VAL,
+     * and we only keep the errno around for the caller. */
+    if (pj_ctx_last_errno(P->ctx) == 0)
+        pj_ctx_last_errno(P->ctx) = last_errno;
+}
@@ -42,9 +42,140 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#ifndef __MINGW32__
+#include <thread>
+#endif
+
+#ifdef TIFF_ENABLED
+
+// ---------------------------------------------------------------------------
+
+/** Worker threads of a context, that decode GeoTIFF grid blocks ahead of
+ * their use for all the grids opened with the context (see BlockReadAhead).
+ * Tasks are run most recent first. Tasks still queued when the pool is
+ * destroyed are dropped.
+ */
+struct projGridReadAheadPool {
+    projGridReadAheadPool(PJ_CONTEXT *ctx, int threadCount);
+    ~projGridReadAheadPool();
+
+    projGridReadAheadPool(const projGridReadAheadPool &) = delete;
+    projGridReadAheadPool &operator=(const projGridReadAheadPool &) = delete;
+
+    // Returns false if no worker could be started.
+    bool enqueue(std::function<void()> &&task);
+
+  private:
+    std::mutex mutex_{};
+    std::condition_variable taskAvailable_{};
+    bool stop_ = false;
+    std::deque<std::function<void()>> tasks_{};
+#ifndef __MINGW32__
+    std::vector<std::thread> threads_{};
+#endif
+
+    void run();
+};
+
+// ---------------------------------------------------------------------------
+
+projGridReadAheadPool::projGridReadAheadPool(PJ_CONTEXT *ctx,
+                                             int threadCount) {
+#ifndef __MINGW32__
+    for (int i = 0; i < threadCount; ++i) {
+        try {
+            threads_.emplace_back(&projGridReadAheadPool::run, this);
+        } catch (const std::exception &e) {
+            pj_log(ctx, PJ_LOG_DEBUG, "Cannot start read-ahead thread: %s",
+                   e.what());
+            break;
+        }
+    }
+#else
+    (void)ctx;
+    (void)threadCount;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+projGridReadAheadPool::~projGridReadAheadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    taskAvailable_.notify_all();
+#ifndef __MINGW32__
+    for (auto &thread : threads_)
+        thread.join();
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+bool projGridReadAheadPool::enqueue(std::function<void()> &&task) {
+#ifndef __MINGW32__
+    if (threads_.empty())
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    taskAvailable_.notify_one();
+    return true;
+#else
+    (void)task;
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+void projGridReadAheadPool::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock,
+                                [this]() { return stop_ || !tasks_.empty(); });
+            if (stop_)
+                break;
+            task = std::move(tasks_.back());
+            tasks_.pop_back();
+        }
+        task();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+#endif // TIFF_ENABLED
+
+// ---------------------------------------------------------------------------
+
+void pj_delete_grid_read_ahead_pool(projGridReadAheadPool *pool) {
+#ifdef TIFF_ENABLED
+    delete pool;
+#else
+    (void)pool;
+#endif
+}
+
+// ---------------------------------------------------------------------------
 
 NS_PROJ_START
 
@@ -167,14 +298,302 @@ bool NullVerticalShiftGrid::valueAt(int, int, float &out) const {
 
 // ---------------------------------------------------------------------------
 
+/** Process-wide, thread-safe, memory-bounded cache of decoded grid lines and
+ * blocks.
+ *
+ * Entries are keyed by file identity, sub-grid/IFD index and line/block
+ * number, so that all PJ objects and contexts that open the same grid file
+ * share the same decoded data. The cache is disabled (max size of 0) by
+ * default, in which case each grid keeps using its private cache.
+ * The cache is split into shards, each with its own lock and LRU list, to
+ * limit contention between threads. Each shard gets an equal part of the
+ * memory budget.
+ */
+class SharedGridCache {
+  public:
+    bool enabled() const {
+        return maxSize_.load(std::memory_order_relaxed) != 0;
+    }
+
+    uint64_t getFileId(File *fp);
+
+    std::shared_ptr<const void> get(uint64_t fileId, uint32_t idx,
+                                    uint32_t number);
+
+    void insert(uint64_t fileId, uint32_t idx, uint32_t number,
+                std::shared_ptr<const void> &&data, size_t sizeBytes);
+
+    void setMaxSize(size_t maxSize);
+
+    void clear();
+
+    void getStats(PJ_GRID_SHARED_CACHE_STATS &stats);
+
+  private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Key {
+        uint64_t fileId;
+        uint32_t idx;
+        uint32_t number;
+
+        bool operator==(const Key &other) const {
+            return fileId == other.fileId && idx == other.idx &&
+                   number == other.number;
+        }
+    };
+
+    struct KeyHasher {
+        std::size_t operator()(const Key &k) const {
+            return std::hash<uint64_t>{}(k.fileId) ^
+                   (std::hash<uint64_t>{}(
+                        (static_cast<uint64_t>(k.idx) << 32) | k.number)
+                    << 1);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const void> data;
+        size_t size;
+    };
+
+    struct Shard {
+        std::mutex mutex{};
+        std::list<Entry> lru{};
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHasher> map{};
+        size_t size = 0;
+    };
+
+    Shard shards_[SHARD_COUNT];
+    std::atomic<size_t> maxSize_{0};
+    std::atomic<unsigned long long> hits_{0};
+    std::atomic<unsigned long long> misses_{0};
+    std::atomic<unsigned long long> evictions_{0};
+
+    static constexpr size_t MAX_FILE_IDS = 1000;
+    std::mutex fileIdsMutex_{};
+    std::map<std::string, uint64_t> fileIds_{};
+    uint64_t lastFileId_ = 0;
+
+    Shard &shardFor(const Key &key) {
+        return shards_[KeyHasher{}(key) % SHARD_COUNT];
+    }
+
+    size_t shardMaxSize() const {
+        return maxSize_.load(std::memory_order_relaxed) / SHARD_COUNT;
+    }
+
+    void evict(Shard &shard, size_t maxSize);
+};
+
+// ---------------------------------------------------------------------------
+
+static SharedGridCache gSharedGridCache{};
+
+// ---------------------------------------------------------------------------
+
+/** Return a process-wide identifier for the content of the file, or 0 if
+ * the cache is disabled.
+ *
+ * Identifiers are never reused, so that forgetting the identity of a file
+ * only causes it to get a new identifier and miss its previous entries.
+ */
+uint64_t SharedGridCache::getFileId(File *fp) {
+    if (!enabled())
+        return 0;
+    const std::string identity(fp->contentIdentity());
+
+    std::lock_guard<std::mutex> lock(fileIdsMutex_);
+    auto iter = fileIds_.find(identity);
+    if (iter != fileIds_.end())
+        return iter->second;
+    if (fileIds_.size() >= MAX_FILE_IDS)
+        fileIds_.clear();
+    const uint64_t id = ++lastFileId_;
+    fileIds_[identity] = id;
+    return id;
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const void> SharedGridCache::get(uint64_t fileId, uint32_t idx,
+                                                 uint32_t number) {
+    const Key key{fileId, idx, number};
+    auto &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter == shard.map.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+    return iter->second->data;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedGridCache::insert(uint64_t fileId, uint32_t idx, uint32_t number,
+                             std::shared_ptr<const void> &&data,
+                             size_t sizeBytes) {
+    const size_t maxSize = shardMaxSize();
+    if (sizeBytes > maxSize)
+        return;
+    const Key key{fileId, idx, number};
+    auto &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter != shard.map.end()) {
+        // Another thread has decoded the same data in the meantime
+        shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+        return;
+    }
+    shard.lru.emplace_front(Entry{key, std::move(data), sizeBytes});
+    shard.map[key] = shard.lru.begin();
+    shard.size += sizeBytes;
+    evict(shard, maxSize);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedGridCache::evict(Shard &shard, size_t maxSize) {
+    while (shard.size > maxSize && !shard.lru.empty()) {
+        const auto &entry = shard.lru.back();
+        shard.size -= entry.size;
+        shard.map.erase(entry.key);
+        shard.lru.pop_back();
+        ++evictions_;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedGridCache::setMaxSize(size_t maxSize) {
+    maxSize_ = maxSize;
+    const size_t shardMax = maxSize / SHARD_COUNT;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        evict(shard, shardMax);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedGridCache::clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+        shard.lru.clear();
+        shard.size = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(fileIdsMutex_);
+        fileIds_.clear();
+    }
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedGridCache::getStats(PJ_GRID_SHARED_CACHE_STATS &stats) {
+    stats.max_size = maxSize_;
+    stats.size = 0;
+    stats.entry_count = 0;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.size += shard.size;
+        stats.entry_count += shard.map.size();
+    }
+    stats.hit_count = hits_;
+    stats.miss_count = misses_;
+    stats.eviction_count = evictions_;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Per-grid view on gSharedGridCache.
+ *
+ * Keeps a reference on the few most recently accessed entries, so that the
+ * pointers returned by get() remain valid even if the entry is evicted from
+ * the shared cache by another thread, and that repeated accesses to the same
+ * lines/blocks (as done by bilinear interpolation) do not need to lock.
+ */
+template <class T> class SharedGridCacheClient {
+  public:
+    void setFileId(uint64_t fileId) { fileId_ = fileId; }
+
+    bool enabled() const { return fileId_ != 0 && gSharedGridCache.enabled(); }
+
+    const std::vector<T> *get(uint32_t idx, uint32_t number);
+
+    void insert(uint32_t idx, uint32_t number, const std::vector<T> &data);
+
+  private:
+    static constexpr int RECENT_COUNT = 4;
+
+    struct Recent {
+        uint64_t key = std::numeric_limits<uint64_t>::max();
+        std::shared_ptr<const std::vector<T>> data{};
+    };
+
+    uint64_t fileId_ = 0;
+    Recent recent_[RECENT_COUNT]{};
+    int nextRecent_ = 0;
+
+    void remember(uint64_t key, std::shared_ptr<const std::vector<T>> &&data) {
+        recent_[nextRecent_].key = key;
+        recent_[nextRecent_].data = std::move(data);
+        nextRecent_ = (nextRecent_ + 1) % RECENT_COUNT;
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+template <class T>
+const std::vector<T> *SharedGridCacheClient<T>::get(uint32_t idx,
+                                                    uint32_t number) {
+    const uint64_t key = (static_cast<uint64_t>(idx) << 32) | number;
+    for (const auto &recent : recent_) {
+        if (recent.key == key)
+            return recent.data.get();
+    }
+    auto data = std::static_pointer_cast<const std::vector<T>>(
+        gSharedGridCache.get(fileId_, idx, number));
+    if (!data)
+        return nullptr;
+    const auto ret = data.get();
+    remember(key, std::move(data));
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
+template <class T>
+void SharedGridCacheClient<T>::insert(uint32_t idx, uint32_t number,
+                                      const std::vector<T> &data) {
+    auto copy = std::make_shared<const std::vector<T>>(data);
+    remember((static_cast<uint64_t>(idx) << 32) | number,
+             std::shared_ptr<const std::vector<T>>(copy));
+    gSharedGridCache.insert(fileId_, idx, number, std::move(copy),
+                            sizeof(T) * data.size());
+}
+
+// ---------------------------------------------------------------------------
+
 class FloatLineCache {
 
   private:
     typedef uint64_t Key;
     lru11::Cache<Key, std::vector<float>, lru11::NullLock> cache_;
+    SharedGridCacheClient<float> sharedCache_{};
 
   public:
-    explicit FloatLineCache(size_t maxSize) : cache_(maxSize) {}
+    FloatLineCache(size_t maxSize, File *fp) : cache_(maxSize) {
+        sharedCache_.setFileId(gSharedGridCache.getFileId(fp));
+    }
     void insert(uint32_t subgridIdx, uint32_t lineNumber,
                 const std::vector<float> &data);
     const std::vector<float> *get(uint32_t subgridIdx, uint32_t lineNumber);
@@ -184,6 +603,10 @@ class FloatLineCache {
 
 void FloatLineCache::insert(uint32_t subgridIdx, uint32_t lineNumber,
                             const std::vector<float> &data) {
+    if (sharedCache_.enabled()) {
+        sharedCache_.insert(subgridIdx, lineNumber, data);
+        return;
+    }
     cache_.insert((static_cast<uint64_t>(subgridIdx) << 32) | lineNumber, data);
 }
 
@@ -191,28 +614,43 @@ void FloatLineCache::insert(uint32_t subgridIdx, uint32_t lineNumber,
 
 const std::vector<float> *FloatLineCache::get(uint32_t subgridIdx,
                                               uint32_t lineNumber) {
+    if (sharedCache_.enabled())
+        return sharedCache_.get(subgridIdx, lineNumber);
     return cache_.getPtr((static_cast<uint64_t>(subgridIdx) << 32) |
                          lineNumber);
 }
 
 // ---------------------------------------------------------------------------
 
+// Last line of a grid read by a handle of a compiled transformation, so
+// that the threads sharing the grid do not lock while they stay on a line.
+struct FloatLineScratch : PJTransHandleScratch {
+    std::vector<float> line{};
+    int lineNumber = -1;
+};
+
+// ---------------------------------------------------------------------------
+
 class GTXVerticalShiftGrid : public VerticalShiftGrid {
     PJ_CONTEXT *m_ctx;
     std::unique_ptr<File> m_fp;
     std::unique_ptr<FloatLineCache> m_cache;
+    const unsigned char *m_data; // values, when the file is memory-mapped
     mutable std::vector<float> m_buffer{};
 
     GTXVerticalShiftGrid(const GTXVerticalShiftGrid &) = delete;
     GTXVerticalShiftGrid &operator=(const GTXVerticalShiftGrid &) = delete;
 
+    const std::vector<float> *readLine(int y) const;
+
   public:
     explicit GTXVerticalShiftGrid(PJ_CONTEXT *ctx, std::unique_ptr<File> &&fp,
                                   const std::string &nameIn, int widthIn,
                                   int heightIn, const ExtentAndRes &extentIn,
-                                  std::unique_ptr<FloatLineCache> &&cache)
+                                  std::unique_ptr<FloatLineCache> &&cache,
+                                  const unsigned char *data)
         : VerticalShiftGrid(nameIn, widthIn, heightIn, extentIn), m_ctx(ctx),
-          m_fp(std::move(fp)), m_cache(std::move(cache)) {}
+          m_fp(std::move(fp)), m_cache(std::move(cache)), m_data(data) {}
 
     ~GTXVerticalShiftGrid() override;
 
@@ -304,25 +742,37 @@ GTXVerticalShiftGrid *GTXVerticalShiftGrid::open(PJ_CONTEXT *ctx,
     extent.north = (yorigin + ystep * (rows - 1)) * DEG_TO_RAD;
     extent.computeInvRes();
 
+    // Local uncompressed files can be read directly from their mapping,
+    // without read() calls nor cache.
+    unsigned long long fileSize = 0;
+    const unsigned char *data = fp->mappedData(fileSize);
+    const unsigned long long dataSize =
+        static_cast<unsigned long long>(rows) * columns * sizeof(float);
+    if (data && fileSize >= sizeof(header) + dataSize) {
+        return new GTXVerticalShiftGrid(ctx, std::move(fp), name, columns,
+                                        rows, extent, nullptr,
+                                        data + sizeof(header));
+    }
+
     // Cache up to 1 megapixel per GTX file
     const int maxLinesInCache = 1024 * 1024 / columns;
-    auto cache = std::make_unique<FloatLineCache>(maxLinesInCache);
+    auto cache = std::make_unique<FloatLineCache>(maxLinesInCache, fp.get());
     return new GTXVerticalShiftGrid(ctx, std::move(fp), name, columns, rows,
-                                    extent, std::move(cache));
+                                    extent, std::move(cache), nullptr);
 }
 
 // ---------------------------------------------------------------------------
 
-bool GTXVerticalShiftGrid::valueAt(int x, int y, float &out) const {
-    assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
-
+// Return the line y, from the cache or read from the file, or nullptr in
+// case of error.
+const std::vector<float> *GTXVerticalShiftGrid::readLine(int y) const {
     const std::vector<float> *pBuffer = m_cache->get(0, y);
     if (pBuffer == nullptr) {
         try {
             m_buffer.resize(m_width);
         } catch (const std::exception &e) {
             pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            return false;
+            return nullptr;
         }
 
         const size_t nLineSizeInBytes = sizeof(float) * m_width;
@@ -330,24 +780,57 @@ bool GTXVerticalShiftGrid::valueAt(int x, int y, float &out) const {
         if (m_fp->read(&m_buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
             proj_context_errno_set(
                 m_ctx, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-            return false;
+            return nullptr;
         }
 
         if (IS_LSB) {
             swap_words(&m_buffer[0], sizeof(float), m_width);
         }
 
-        out = m_buffer[x];
+        pBuffer = &m_buffer;
         try {
             m_cache->insert(0, y, m_buffer);
         } catch (const std::exception &e) {
             // Should normally not happen
             pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
         }
-    } else {
-        out = (*pBuffer)[x];
+    }
+    return pBuffer;
+}
+
+// ---------------------------------------------------------------------------
+
+bool GTXVerticalShiftGrid::valueAt(int x, int y, float &out) const {
+    assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
+
+    if (m_data) {
+        memcpy(&out,
+               m_data + sizeof(float) * (static_cast<size_t>(y) * m_width + x),
+               sizeof(float));
+        if (IS_LSB) {
+            swap_words(&out, sizeof(float), 1);
+        }
+        return true;
+    }
+
+    if (auto scratch = pj_trans_handle_scratch<FloatLineScratch>(m_ctx, this)) {
+        if (scratch->lineNumber != y) {
+            std::lock_guard<std::mutex> lock(m_fp->sharedAccessMutex());
+            scratch->lineNumber = -1;
+            const std::vector<float> *pLine = readLine(y);
+            if (pLine == nullptr)
+                return false;
+            scratch->line = *pLine;
+            scratch->lineNumber = y;
+        }
+        out = scratch->line[x];
+        return true;
     }
 
+    const std::vector<float> *pLine = readLine(y);
+    if (pLine == nullptr)
+        return false;
+    out = (*pLine)[x];
     return true;
 }
 
@@ -406,6 +889,9 @@ constexpr uint16_t TIFFTAG_GDAL_NODATA = 42113;
 
 class BlockCache {
   public:
+    void setFile(File *fp) {
+        sharedCache_.setFileId(gSharedGridCache.getFileId(fp));
+    }
     void insert(uint32_t ifdIdx, uint32_t blockNumber,
                 const std::vector<unsigned char> &data);
     const std::vector<unsigned char> *get(uint32_t ifdIdx,
@@ -418,12 +904,17 @@ class BlockCache {
     static constexpr int MAX_SAMPLE_COUNT = 3;
     lru11::Cache<Key, std::vector<unsigned char>, lru11::NullLock> cache_{
         NUM_BLOCKS_AT_CROSSING_TILES * MAX_SAMPLE_COUNT};
+    SharedGridCacheClient<unsigned char> sharedCache_{};
 };
 
 // ---------------------------------------------------------------------------
 
 void BlockCache::insert(uint32_t ifdIdx, uint32_t blockNumber,
                         const std::vector<unsigned char> &data) {
+    if (sharedCache_.enabled()) {
+        sharedCache_.insert(ifdIdx, blockNumber, data);
+        return;
+    }
     cache_.insert((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber, data);
 }
 
@@ -431,16 +922,135 @@ void BlockCache::insert(uint32_t ifdIdx, uint32_t blockNumber,
 
 const std::vector<unsigned char> *BlockCache::get(uint32_t ifdIdx,
                                                   uint32_t blockNumber) {
+    if (sharedCache_.enabled())
+        return sharedCache_.get(ifdIdx, blockNumber);
     return cache_.getPtr((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber);
 }
 
 // ---------------------------------------------------------------------------
 
+// Decode the block of index blockId of the directory at dirOffset into
+// buffer, which is resized to the size of a block if it is empty. Errors are
+// not logged when ctx is nullptr.
+static bool readTIFFBlock(PJ_CONTEXT *ctx, TIFF *hTIFF, toff_t dirOffset,
+                          bool tiled, uint32_t blockId,
+                          std::vector<unsigned char> &buffer) {
+    if (TIFFCurrentDirOffset(hTIFF) != dirOffset &&
+        !TIFFSetSubDirectory(hTIFF, dirOffset)) {
+        return false;
+    }
+    if (buffer.empty()) {
+        const auto blockSize = static_cast<size_t>(
+            tiled ? TIFFTileSize64(hTIFF) : TIFFStripSize64(hTIFF));
+        try {
+            buffer.resize(blockSize);
+        } catch (const std::exception &e) {
+            if (ctx)
+                pj_log(ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+            return false;
+        }
+    }
+
+    if (tiled) {
+        return TIFFReadEncodedTile(hTIFF, blockId, buffer.data(),
+                                   buffer.size()) != -1;
+    }
+    return TIFFReadEncodedStrip(hTIFF, blockId, buffer.data(),
+                                buffer.size()) != -1;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Decodes ahead of time, on the worker threads of the context, the blocks
+ * of a GeoTIFF file that are likely to be read next, that is the neighbours
+ * of the blocks read by the transforming thread.
+ *
+ * Workers decode with the TIFF handle of the GTiffDataset, which the
+ * transforming thread must also only use while holding tiffMutex(). A block
+ * that is needed before a worker started decoding it is decoded by the
+ * transforming thread itself. Decoded blocks are kept until they are taken,
+ * or until more than MAX_BLOCKS blocks have been scheduled since.
+ */
+class BlockReadAhead : public std::enable_shared_from_this<BlockReadAhead> {
+  public:
+    BlockReadAhead(PJ_CONTEXT *ctx, TIFF *hTIFF) : ctx_(ctx), hTIFF_(hTIFF) {}
+
+    BlockReadAhead(const BlockReadAhead &) = delete;
+    BlockReadAhead &operator=(const BlockReadAhead &) = delete;
+
+    void reassign_context(PJ_CONTEXT *ctx) { ctx_ = ctx; }
+
+    std::mutex &tiffMutex() { return tiffMutex_; }
+
+    // Drop the blocks not decoded yet, and wait for the ones being decoded,
+    // so that the TIFF handle can be closed.
+    void close();
+
+    // Queue the decoding of a block. Returns false if it was already queued,
+    // or if the context has no worker thread.
+    bool schedule(toff_t dirOffset, bool tiled, uint32_t ifdIdx,
+                  uint32_t blockId);
+
+    // Move the content of a queued block into buffer, waiting for it if it
+    // is being decoded. Returns false if the block was not queued, if no
+    // worker started decoding it (it is then no longer queued), or if it
+    // could not be decoded.
+    bool take(uint32_t ifdIdx, uint32_t blockId,
+              std::vector<unsigned char> &buffer);
+
+  private:
+    typedef uint64_t Key;
+
+    static constexpr size_t MAX_BLOCKS = 16;
+
+    struct Job {
+        Key key;
+        toff_t dirOffset;
+        bool tiled;
+    };
+
+    struct Result {
+        bool started = false;
+        bool done = false;
+        bool ok = false;
+        std::vector<unsigned char> data{};
+    };
+
+    PJ_CONTEXT *ctx_; // context of the owning thread
+
+    std::mutex tiffMutex_{};
+    TIFF *hTIFF_; // nullptr once closed. Guarded by tiffMutex_
+
+    std::mutex mutex_{};
+    std::condition_variable resultAvailable_{};
+    std::deque<Job> jobs_{};         // not started yet
+    std::map<Key, Result> results_{}; // all the queued blocks
+    std::deque<Key> resultOrder_{};  // keys of results_, oldest first
+
+    static Key makeKey(uint32_t ifdIdx, uint32_t blockId) {
+        return (static_cast<uint64_t>(ifdIdx) << 32) | blockId;
+    }
+
+    void forget(Key key);
+    void run();
+};
+
+// ---------------------------------------------------------------------------
+
+// Last block of a GTiffGrid read by a handle of a compiled transformation.
+struct GTiffBlockScratch : PJTransHandleScratch {
+    std::vector<unsigned char> buffer{};
+    uint32_t blockId = std::numeric_limits<uint32_t>::max();
+};
+
+// ---------------------------------------------------------------------------
+
 class GTiffGrid : public Grid {
     PJ_CONTEXT *m_ctx;   // owned by the belonging GTiffDataset
     TIFF *m_hTIFF;       // owned by the belonging GTiffDataset
     BlockCache &m_cache; // owned by the belonging GTiffDataset
     File *m_fp;          // owned by the belonging GTiffDataset
+    BlockReadAhead *m_readAhead; // owned by the belonging GTiffDataset
     uint32_t m_ifdIdx;
     TIFFDataType m_dt;
     uint16_t m_samplesPerPixel;
@@ -463,18 +1073,29 @@ class GTiffGrid : public Grid {
     bool m_isSingleBlock = false;
     float m_noData = 0.0f;
     uint32_t m_subfileType = 0;
+    // Pointers to the blocks in the file mapping, when the file is
+    // memory-mapped and blocks can be used as stored.
+    std::vector<std::pair<const unsigned char *, size_t>> m_mappedBlocks{};
 
     GTiffGrid(const GTiffGrid &) = delete;
     GTiffGrid &operator=(const GTiffGrid &) = delete;
 
+    void initMappedBlocks();
+
+    const unsigned char *getBlockData(uint32_t blockId,
+                                      size_t &blockSize) const;
+
+    void scheduleNeighbourBlocks(uint32_t blockId) const;
+
     template <class T>
-    float readValue(const std::vector<unsigned char> &buffer,
+    float readValue(const unsigned char *blockData, size_t blockSize,
                     uint32_t offsetInBlock, uint16_t sample) const;
 
   public:
     GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
-              uint32_t ifdIdx, const std::string &nameIn, int widthIn,
-              int heightIn, const ExtentAndRes &extentIn, TIFFDataType dtIn,
+              BlockReadAhead *readAhead, uint32_t ifdIdx,
+              const std::string &nameIn, int widthIn, int heightIn,
+              const ExtentAndRes &extentIn, TIFFDataType dtIn,
               uint16_t samplesPerPixelIn, uint16_t planarConfig,
               bool bottomUpIn);
 
@@ -495,6 +1116,8 @@ class GTiffGrid : public Grid {
 
     uint32_t subfileType() const { return m_subfileType; }
 
+    void prefetch(int xMin, int yMin, int xMax, int yMax) const;
+
     void reassign_context(PJ_CONTEXT *ctx) { m_ctx = ctx; }
 
     bool hasChanged() const override { return m_fp->hasChanged(); }
@@ -503,12 +1126,14 @@ class GTiffGrid : public Grid {
 // ---------------------------------------------------------------------------
 
 GTiffGrid::GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
-                     uint32_t ifdIdx, const std::string &nameIn, int widthIn,
-                     int heightIn, const ExtentAndRes &extentIn,
-                     TIFFDataType dtIn, uint16_t samplesPerPixelIn,
-                     uint16_t planarConfig, bool bottomUpIn)
+                     BlockReadAhead *readAhead, uint32_t ifdIdx,
+                     const std::string &nameIn, int widthIn, int heightIn,
+                     const ExtentAndRes &extentIn, TIFFDataType dtIn,
+                     uint16_t samplesPerPixelIn, uint16_t planarConfig,
+                     bool bottomUpIn)
     : Grid(nameIn, widthIn, heightIn, extentIn), m_ctx(ctx), m_hTIFF(hTIFF),
-      m_cache(cache), m_fp(fp), m_ifdIdx(ifdIdx), m_dt(dtIn),
+      m_cache(cache), m_fp(fp), m_readAhead(readAhead), m_ifdIdx(ifdIdx),
+      m_dt(dtIn),
       m_samplesPerPixel(samplesPerPixelIn),
       m_planarConfig(samplesPerPixelIn == 1 ? static_cast<uint16_t>(-1)
                                             : planarConfig),
@@ -535,6 +1160,8 @@ GTiffGrid::GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
     m_blocksPerCol = (m_height + m_blockHeight - 1) / m_blockHeight;
     m_blocks = m_blocksPerRow * m_blocksPerCol;
 
+    initMappedBlocks();
+
     const char *text = nullptr;
     // Poor-man XML parsing of TIFFTAG_GDAL_METADATA tag. Hopefully good
     // enough for our purposes.
@@ -635,11 +1262,235 @@ GTiffGrid::~GTiffGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+// Uncompressed blocks of local files, in the native byte order, are read
+// directly from the file mapping, without libtiff calls nor cache.
+void GTiffGrid::initMappedBlocks() {
+    unsigned long long fileSize = 0;
+    const unsigned char *fileData = m_fp->mappedData(fileSize);
+    if (!fileData || TIFFIsByteSwapped(m_hTIFF))
+        return;
+
+    uint16_t compression = COMPRESSION_NONE;
+    if (!TIFFGetField(m_hTIFF, TIFFTAG_COMPRESSION, &compression))
+        compression = COMPRESSION_NONE;
+    if (compression != COMPRESSION_NONE)
+        return;
+
+    toff_t *offsets = nullptr;
+    toff_t *byteCounts = nullptr;
+    if (!TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEOFFSETS : TIFFTAG_STRIPOFFSETS,
+                      &offsets) ||
+        !TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEBYTECOUNTS
+                              : TIFFTAG_STRIPBYTECOUNTS,
+                      &byteCounts)) {
+        return;
+    }
+
+    unsigned dtSize = 0;
+    switch (m_dt) {
+    case TIFFDataType::Int16:
+    case TIFFDataType::UInt16:
+        dtSize = 2;
+        break;
+    case TIFFDataType::Int32:
+    case TIFFDataType::UInt32:
+    case TIFFDataType::Float32:
+        dtSize = 4;
+        break;
+    case TIFFDataType::Float64:
+        dtSize = 8;
+        break;
+    }
+
+    const unsigned blockCount = m_planarConfig == PLANARCONFIG_SEPARATE
+                                    ? m_blocks * m_samplesPerPixel
+                                    : m_blocks;
+    std::vector<std::pair<const unsigned char *, size_t>> blocks;
+    blocks.reserve(blockCount);
+    for (unsigned i = 0; i < blockCount; ++i) {
+        uint64_t blockSize;
+        if (m_tiled) {
+            blockSize = TIFFTileSize64(m_hTIFF);
+        } else {
+            // The last strip may be shorter than the others
+            const uint32_t firstRow = (i % m_blocks) * m_blockHeight;
+            blockSize = TIFFVStripSize64(
+                m_hTIFF, std::min(m_blockHeight,
+                                  static_cast<uint32_t>(m_height) - firstRow));
+        }
+        // Sparse or misaligned blocks must go through libtiff
+        if (offsets[i] == 0 || (offsets[i] % dtSize) != 0 ||
+            byteCounts[i] < blockSize || offsets[i] > fileSize ||
+            fileSize - offsets[i] < blockSize) {
+            return;
+        }
+        blocks.emplace_back(fileData + offsets[i],
+                            static_cast<size_t>(blockSize));
+    }
+    m_mappedBlocks = std::move(blocks);
+}
+
+// ---------------------------------------------------------------------------
+
+// Pass the byte ranges of the blocks intersecting the window of pixels
+// (y = 0 being the southern-most line) to File::prefetch().
+void GTiffGrid::prefetch(int xMin, int yMin, int xMax, int yMax) const {
+    if (!m_mappedBlocks.empty())
+        return;
+    std::unique_lock<std::mutex> tiffLock;
+    if (m_readAhead)
+        tiffLock = std::unique_lock<std::mutex>(m_readAhead->tiffMutex());
+    if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
+        !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
+        return;
+    }
+
+    toff_t *offsets = nullptr;
+    toff_t *byteCounts = nullptr;
+    if (!TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEOFFSETS : TIFFTAG_STRIPOFFSETS,
+                      &offsets) ||
+        !TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEBYTECOUNTS
+                              : TIFFTAG_STRIPBYTECOUNTS,
+                      &byteCounts)) {
+        return;
+    }
+
+    const int yTIFFMin = m_bottomUp ? yMin : m_height - 1 - yMax;
+    const int yTIFFMax = m_bottomUp ? yMax : m_height - 1 - yMin;
+    const unsigned planes =
+        m_planarConfig == PLANARCONFIG_SEPARATE ? m_samplesPerPixel : 1;
+    std::vector<std::pair<unsigned long long, size_t>> ranges;
+    for (unsigned plane = 0; plane < planes; ++plane) {
+        for (unsigned blockY = yTIFFMin / m_blockHeight;
+             blockY <= yTIFFMax / m_blockHeight; ++blockY) {
+            for (unsigned blockX = xMin / m_blockWidth;
+                 blockX <= xMax / m_blockWidth; ++blockX) {
+                const auto blockId =
+                    plane * m_blocks + blockY * m_blocksPerRow + blockX;
+                if (offsets[blockId] != 0 && byteCounts[blockId] != 0) {
+                    ranges.emplace_back(
+                        offsets[blockId],
+                        static_cast<size_t>(byteCounts[blockId]));
+                }
+            }
+        }
+    }
+    m_fp->prefetch(ranges);
+}
+
+// ---------------------------------------------------------------------------
+
+// Return the content of the block of index blockId, from the file mapping,
+// the cache or read from the file, or nullptr in case of error.
+const unsigned char *GTiffGrid::getBlockData(uint32_t blockId,
+                                             size_t &blockSize) const {
+    if (!m_mappedBlocks.empty()) {
+        blockSize = m_mappedBlocks[blockId].second;
+        return m_mappedBlocks[blockId].first;
+    }
+
+    auto scratch = pj_trans_handle_scratch<GTiffBlockScratch>(m_ctx, this);
+    if (scratch) {
+        // Shared by threads running a compiled transformation: they only
+        // lock to load a block that is not the last one they used.
+        if (scratch->blockId != blockId) {
+            std::lock_guard<std::mutex> lock(m_fp->sharedAccessMutex());
+            scratch->blockId = std::numeric_limits<uint32_t>::max();
+            const std::vector<unsigned char> *pCached =
+                m_cache.get(m_ifdIdx, blockId);
+            if (pCached) {
+                scratch->buffer = *pCached;
+            } else {
+                if (!readTIFFBlock(m_ctx, m_hTIFF, m_dirOffset, m_tiled,
+                                   blockId, scratch->buffer)) {
+                    return nullptr;
+                }
+                try {
+                    m_cache.insert(m_ifdIdx, blockId, scratch->buffer);
+                } catch (const std::exception &e) {
+                    // Should normally not happen
+                    pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+                }
+            }
+            scratch->blockId = blockId;
+        }
+        blockSize = scratch->buffer.size();
+        return scratch->buffer.data();
+    }
+
+    const std::vector<unsigned char> *pBuffer =
+        blockId == m_bufferBlockId ? &m_buffer : m_cache.get(m_ifdIdx, blockId);
+    if (pBuffer == nullptr) {
+        if (m_readAhead && m_readAhead->take(m_ifdIdx, blockId, m_buffer)) {
+            m_ctx->gridReadAheadStats.hit_count++;
+        } else {
+            std::unique_lock<std::mutex> tiffLock;
+            if (m_readAhead) {
+                m_ctx->gridReadAheadStats.miss_count++;
+                tiffLock = std::unique_lock<std::mutex>(
+                    m_readAhead->tiffMutex());
+            }
+            if (!readTIFFBlock(m_ctx, m_hTIFF, m_dirOffset, m_tiled, blockId,
+                               m_buffer)) {
+                return nullptr;
+            }
+        }
+        if (m_readAhead)
+            scheduleNeighbourBlocks(blockId);
+
+        pBuffer = &m_buffer;
+        try {
+            m_cache.insert(m_ifdIdx, blockId, m_buffer);
+            m_bufferBlockId = blockId;
+        } catch (const std::exception &e) {
+            // Should normally not happen
+            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+        }
+    }
+    blockSize = pBuffer->size();
+    return pBuffer->data();
+}
+
+// ---------------------------------------------------------------------------
+
+// Queue the decoding of the blocks around blockId, in the same plane, that
+// are not cached yet.
+void GTiffGrid::scheduleNeighbourBlocks(uint32_t blockId) const {
+    const unsigned plane = blockId / m_blocks;
+    const unsigned blockX = (blockId % m_blocks) % m_blocksPerRow;
+    const unsigned blockY = (blockId % m_blocks) / m_blocksPerRow;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const long x = static_cast<long>(blockX) + dx;
+            const long y = static_cast<long>(blockY) + dy;
+            if ((dx == 0 && dy == 0) || x < 0 || y < 0 ||
+                x >= static_cast<long>(m_blocksPerRow) ||
+                y >= static_cast<long>(m_blocksPerCol)) {
+                continue;
+            }
+            const auto neighbourId = static_cast<uint32_t>(
+                plane * m_blocks + y * m_blocksPerRow + x);
+            if (m_cache.get(m_ifdIdx, neighbourId) == nullptr &&
+                m_readAhead->schedule(m_dirOffset, m_tiled, m_ifdIdx,
+                                      neighbourId)) {
+                m_ctx->gridReadAheadStats.scheduled_count++;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 template <class T>
-float GTiffGrid::readValue(const std::vector<unsigned char> &buffer,
+float GTiffGrid::readValue(const unsigned char *blockData, size_t blockSize,
                            uint32_t offsetInBlock, uint16_t sample) const {
-    const auto ptr = reinterpret_cast<const T *>(buffer.data());
-    assert(offsetInBlock < buffer.size() / sizeof(T));
+    const auto ptr = reinterpret_cast<const T *>(blockData);
+    assert(offsetInBlock < blockSize / sizeof(T));
+    (void)blockSize;
     const auto val = ptr[offsetInBlock];
     if ((!m_hasNodata || static_cast<float>(val) != m_noData) &&
         sample < m_adfScale.size()) {
@@ -691,44 +1542,10 @@ bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
         blockId += sample * m_blocks;
     }
 
-    const std::vector<unsigned char> *pBuffer =
-        blockId == m_bufferBlockId ? &m_buffer : m_cache.get(m_ifdIdx, blockId);
-    if (pBuffer == nullptr) {
-        if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-            !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-            return false;
-        }
-        if (m_buffer.empty()) {
-            const auto blockSize = static_cast<size_t>(
-                m_tiled ? TIFFTileSize64(m_hTIFF) : TIFFStripSize64(m_hTIFF));
-            try {
-                m_buffer.resize(blockSize);
-            } catch (const std::exception &e) {
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                return false;
-            }
-        }
-
-        if (m_tiled) {
-            if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                    m_buffer.size()) == -1) {
-                return false;
-            }
-        } else {
-            if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                     m_buffer.size()) == -1) {
-                return false;
-            }
-        }
-
-        pBuffer = &m_buffer;
-        try {
-            m_cache.insert(m_ifdIdx, blockId, m_buffer);
-            m_bufferBlockId = blockId;
-        } catch (const std::exception &e) {
-            // Should normally not happen
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-        }
+    size_t blockSize = 0;
+    const unsigned char *blockData = getBlockData(blockId, blockSize);
+    if (blockData == nullptr) {
+        return false;
     }
 
     uint32_t offsetInBlock;
@@ -741,27 +1558,29 @@ bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
 
     switch (m_dt) {
     case TIFFDataType::Int16:
-        out = readValue<short>(*pBuffer, offsetInBlock, sample);
+        out = readValue<short>(blockData, blockSize, offsetInBlock, sample);
         break;
 
     case TIFFDataType::UInt16:
-        out = readValue<unsigned short>(*pBuffer, offsetInBlock, sample);
+        out = readValue<unsigned short>(blockData, blockSize, offsetInBlock,
+                                        sample);
         break;
 
     case TIFFDataType::Int32:
-        out = readValue<int>(*pBuffer, offsetInBlock, sample);
+        out = readValue<int>(blockData, blockSize, offsetInBlock, sample);
         break;
 
     case TIFFDataType::UInt32:
-        out = readValue<unsigned int>(*pBuffer, offsetInBlock, sample);
+        out = readValue<unsigned int>(blockData, blockSize, offsetInBlock,
+                                      sample);
         break;
 
     case TIFFDataType::Float32:
-        out = readValue<float>(*pBuffer, offsetInBlock, sample);
+        out = readValue<float>(blockData, blockSize, offsetInBlock, sample);
         break;
 
     case TIFFDataType::Float64:
-        out = readValue<double>(*pBuffer, offsetInBlock, sample);
+        out = readValue<double>(blockData, blockSize, offsetInBlock, sample);
         break;
     }
 
@@ -796,46 +1615,10 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
         blockYOff = yTIFF % 256;
         blockId = blockY * m_blocksPerRow + blockX;
 
-        const std::vector<unsigned char> *pBuffer =
-            blockId == m_bufferBlockId ? &m_buffer
-                                       : m_cache.get(m_ifdIdx, blockId);
-        if (pBuffer == nullptr) {
-            if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-                !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-                return false;
-            }
-            if (m_buffer.empty()) {
-                const auto blockSize =
-                    static_cast<size_t>(m_tiled ? TIFFTileSize64(m_hTIFF)
-                                                : TIFFStripSize64(m_hTIFF));
-                try {
-                    m_buffer.resize(blockSize);
-                } catch (const std::exception &e) {
-                    pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                    return false;
-                }
-            }
-
-            if (m_tiled) {
-                if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                        m_buffer.size()) == -1) {
-                    return false;
-                }
-            } else {
-                if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                         m_buffer.size()) == -1) {
-                    return false;
-                }
-            }
-
-            pBuffer = &m_buffer;
-            try {
-                m_cache.insert(m_ifdIdx, blockId, m_buffer);
-                m_bufferBlockId = blockId;
-            } catch (const std::exception &e) {
-                // Should normally not happen
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            }
+        size_t blockSize = 0;
+        const unsigned char *blockData = getBlockData(blockId, blockSize);
+        if (blockData == nullptr) {
+            return false;
         }
 
         uint32_t offsetInBlockStart = blockXOff + blockYOff * 256U;
@@ -849,7 +1632,7 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                         m_samplesPerPixel +
                     sample_idx[0];
                 memcpy(out,
-                       reinterpret_cast<const float *>(pBuffer->data()) +
+                       reinterpret_cast<const float *>(blockData) +
                            offsetInBlock,
                        sample_count_mul_x_count * sizeof(float));
                 out += sample_count_mul_x_count;
@@ -864,7 +1647,7 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                             m_samplesPerPixel +
                         sample_idx[0];
                     const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
+                        reinterpret_cast<const float *>(blockData) +
                         offsetInBlock;
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
@@ -881,7 +1664,7 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                             m_samplesPerPixel +
                         sample_idx[0];
                     const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
+                        reinterpret_cast<const float *>(blockData) +
                         offsetInBlock;
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
@@ -898,7 +1681,7 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                             m_samplesPerPixel +
                         sample_idx[0];
                     const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
+                        reinterpret_cast<const float *>(blockData) +
                         offsetInBlock;
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
@@ -956,6 +1739,8 @@ class GTiffDataset {
     toff_t m_nextDirOffset = 0;
     std::string m_filename{};
     BlockCache m_cache{};
+    // Shared with the tasks queued in the read-ahead pool of the context
+    std::shared_ptr<BlockReadAhead> m_readAhead{};
 
     GTiffDataset(const GTiffDataset &) = delete;
     GTiffDataset &operator=(const GTiffDataset &) = delete;
@@ -999,22 +1784,31 @@ class GTiffDataset {
 
   public:
     GTiffDataset(PJ_CONTEXT *ctx, std::unique_ptr<File> &&fp)
-        : m_ctx(ctx), m_fp(std::move(fp)) {}
+        : m_ctx(ctx), m_fp(std::move(fp)) {
+        m_cache.setFile(m_fp.get());
+    }
     virtual ~GTiffDataset();
 
     bool openTIFF(const std::string &filename);
 
     std::unique_ptr<GTiffGrid> nextGrid();
 
+    TIFF *tiff() const { return m_hTIFF; }
+
     void reassign_context(PJ_CONTEXT *ctx) {
         m_ctx = ctx;
         m_fp->reassign_context(ctx);
+        if (m_readAhead)
+            m_readAhead->reassign_context(ctx);
     }
 };
 
 // ---------------------------------------------------------------------------
 
 GTiffDataset::~GTiffDataset() {
+    // Make sure that no worker uses the TIFF handle once it is closed
+    if (m_readAhead)
+        m_readAhead->close();
     if (m_hTIFF)
         TIFFClose(m_hTIFF);
 }
@@ -1069,24 +1863,169 @@ TIFFExtendProc OneTimeTIFFTagInit::ParentExtender = nullptr;
 
 // ---------------------------------------------------------------------------
 
-bool GTiffDataset::openTIFF(const std::string &filename) {
-    static OneTimeTIFFTagInit oneTimeTIFFTagInit;
-    m_hTIFF =
-        TIFFClientOpen(filename.c_str(), "r", static_cast<thandle_t>(this),
-                       GTiffDataset::tiffReadProc, GTiffDataset::tiffWriteProc,
-                       GTiffDataset::tiffSeekProc, GTiffDataset::tiffCloseProc,
-                       GTiffDataset::tiffSizeProc, GTiffDataset::tiffMapProc,
-                       GTiffDataset::tiffUnmapProc);
+bool GTiffDataset::openTIFF(const std::string &filename) {
+    static OneTimeTIFFTagInit oneTimeTIFFTagInit;
+    m_hTIFF =
+        TIFFClientOpen(filename.c_str(), "r", static_cast<thandle_t>(this),
+                       GTiffDataset::tiffReadProc, GTiffDataset::tiffWriteProc,
+                       GTiffDataset::tiffSeekProc, GTiffDataset::tiffCloseProc,
+                       GTiffDataset::tiffSizeProc, GTiffDataset::tiffMapProc,
+                       GTiffDataset::tiffUnmapProc);
+
+    m_filename = filename;
+    m_hasNextGrid = true;
+    // Reading network files uses the context, which must only be used by
+    // its own thread
+    if (m_hTIFF && m_ctx->gridReadAheadThreads > 0 &&
+        !starts_with(m_fp->name(), "http://") &&
+        !starts_with(m_fp->name(), "https://")) {
+        m_readAhead = std::make_shared<BlockReadAhead>(m_ctx, m_hTIFF);
+    }
+    return m_hTIFF != nullptr;
+}
+// ---------------------------------------------------------------------------
+
+// Return the worker threads of the context, started the first time they are
+// needed, or nullptr if read-ahead is disabled.
+static projGridReadAheadPool *getGridReadAheadPool(PJ_CONTEXT *ctx) {
+    if (ctx->gridReadAheadPool == nullptr && ctx->gridReadAheadThreads > 0) {
+        ctx->gridReadAheadPool = new (std::nothrow)
+            projGridReadAheadPool(ctx, ctx->gridReadAheadThreads);
+    }
+    return ctx->gridReadAheadPool;
+}
+
+// ---------------------------------------------------------------------------
+
+void BlockReadAhead::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.clear();
+        results_.clear();
+        resultOrder_.clear();
+    }
+    std::lock_guard<std::mutex> lock(tiffMutex_);
+    hTIFF_ = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+// Remove a block from the queue. Must be called with mutex_ held.
+void BlockReadAhead::forget(Key key) {
+    results_.erase(key);
+    auto orderIter = std::find(resultOrder_.begin(), resultOrder_.end(), key);
+    if (orderIter != resultOrder_.end())
+        resultOrder_.erase(orderIter);
+    auto jobIter =
+        std::find_if(jobs_.begin(), jobs_.end(),
+                     [key](const Job &job) { return job.key == key; });
+    if (jobIter != jobs_.end())
+        jobs_.erase(jobIter);
+}
+
+// ---------------------------------------------------------------------------
+
+bool BlockReadAhead::schedule(toff_t dirOffset, bool tiled, uint32_t ifdIdx,
+                              uint32_t blockId) {
+    auto pool = getGridReadAheadPool(ctx_);
+    if (pool == nullptr)
+        return false;
+
+    const Key key = makeKey(ifdIdx, blockId);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (results_.find(key) != results_.end())
+            return false;
+        // Forget the oldest blocks
+        while (resultOrder_.size() >= MAX_BLOCKS)
+            forget(resultOrder_.front());
+        results_[key] = Result();
+        resultOrder_.push_back(key);
+        jobs_.push_back(Job{key, dirOffset, tiled});
+    }
+
+    // Each task decodes the most recent job, if any is left
+    auto self = shared_from_this();
+    if (!pool->enqueue([self]() { self->run(); })) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        forget(key);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool BlockReadAhead::take(uint32_t ifdIdx, uint32_t blockId,
+                          std::vector<unsigned char> &buffer) {
+    const Key key = makeKey(ifdIdx, blockId);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = results_.find(key);
+    if (iter == results_.end())
+        return false;
+    if (!iter->second.started) {
+        // The caller decodes it rather than waiting for a worker
+        forget(key);
+        return false;
+    }
+    resultAvailable_.wait(lock, [&iter]() { return iter->second.done; });
+    const bool ok = iter->second.ok;
+    if (ok)
+        buffer = std::move(iter->second.data);
+    forget(key);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+
+void BlockReadAhead::run() {
+    Job job{};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (jobs_.empty())
+            return;
+        // Most recent jobs first, as they are closer to where the
+        // transforming thread currently reads
+        job = jobs_.back();
+        jobs_.pop_back();
+        auto iter = results_.find(job.key);
+        if (iter == results_.end())
+            return;
+        iter->second.started = true;
+    }
 
-    m_filename = filename;
-    m_hasNextGrid = true;
-    return m_hTIFF != nullptr;
+    std::vector<unsigned char> data;
+    bool ok = false;
+    try {
+        std::lock_guard<std::mutex> lock(tiffMutex_);
+        ok = hTIFF_ != nullptr &&
+             readTIFFBlock(nullptr, hTIFF_, job.dirOffset, job.tiled,
+                           static_cast<uint32_t>(job.key), data);
+    } catch (const std::exception &) {
+        ok = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = results_.find(job.key);
+        if (iter != results_.end()) {
+            iter->second.done = true;
+            iter->second.ok = ok;
+            if (ok)
+                iter->second.data = std::move(data);
+        }
+    }
+    resultAvailable_.notify_all();
 }
+
 // ---------------------------------------------------------------------------
 
 std::unique_ptr<GTiffGrid> GTiffDataset::nextGrid() {
     if (!m_hasNextGrid)
         return nullptr;
+    std::unique_lock<std::mutex> tiffLock;
+    if (m_readAhead)
+        tiffLock = std::unique_lock<std::mutex>(m_readAhead->tiffMutex());
     if (m_nextDirOffset) {
         TIFFSetSubDirectory(m_hTIFF, m_nextDirOffset);
     }
@@ -1315,8 +2254,9 @@ std::unique_ptr<GTiffGrid> GTiffDataset::nextGrid() {
     }
 
     auto ret = std::unique_ptr<GTiffGrid>(new GTiffGrid(
-        m_ctx, m_hTIFF, m_cache, m_fp.get(), m_ifdIdx, m_filename, width,
-        height, extent, dt, samplesPerPixel, planarConfig, vRes < 0));
+        m_ctx, m_hTIFF, m_cache, m_fp.get(), m_readAhead.get(), m_ifdIdx,
+        m_filename, width, height, extent, dt, samplesPerPixel, planarConfig,
+        vRes < 0));
     m_ifdIdx++;
     m_hasNextGrid = TIFFReadDirectory(m_hTIFF) != 0;
     m_nextDirOffset = TIFFCurrentDirOffset(m_hTIFF);
@@ -1739,10 +2679,80 @@ void VerticalShiftGridSet::reassign_context(PJ_CONTEXT *ctx) {
 
 // ---------------------------------------------------------------------------
 
+// Process-wide limit, and current value, of the memory used by the tiles of
+// the inverses of horizontal shift grids. Once it is reached, the inverse
+// shifts of the regions without a tile are iterated.
+static constexpr size_t MAX_INVERSE_GRID_TILES_SIZE = 64 * 1024 * 1024;
+static std::atomic<size_t> gInverseGridTilesSize{0};
+
+// Inverse of a horizontal shift grid, built by tiles of TILE_SIZE x TILE_SIZE
+// cells the first time a coordinate falling in them is transformed in the
+// inverse direction. Each tile is built at most once, under a once flag, so
+// that concurrent lookups are safe.
+struct HorizontalShiftGridInverse {
+    static constexpr int TILE_SIZE = 64;
+    static constexpr int NODES_PER_LINE = TILE_SIZE + 1;
+
+    struct Tile {
+        // Shifts to subtract from the nodes of the tile to get the source
+        // position. NaN when it could not be determined within the grid.
+        std::vector<double> longShift{};
+        std::vector<double> latShift{};
+        // Whether bilinear interpolation of the node values, followed by one
+        // step of the iteration, is accurate enough in each cell of the tile.
+        std::vector<bool> accurate{};
+    };
+
+    // Approximate memory used by a tile
+    static constexpr size_t TILE_SIZE_BYTES =
+        sizeof(Tile) + 2 * NODES_PER_LINE * NODES_PER_LINE * sizeof(double) +
+        TILE_SIZE * TILE_SIZE / 8;
+
+    struct Slot {
+        std::once_flag once{};
+        // nullptr if the tile could not be built within the memory limit
+        std::unique_ptr<const Tile> tile{};
+    };
+
+    int tilesX = 0;
+    int tilesY = 0;
+    std::unique_ptr<Slot[]> slots{};
+    // Memory used by the tiles of this grid
+    std::atomic<size_t> size{0};
+
+    HorizontalShiftGridInverse(int width, int height)
+        : tilesX((width - 1 + TILE_SIZE - 1) / TILE_SIZE),
+          tilesY((height - 1 + TILE_SIZE - 1) / TILE_SIZE),
+          slots(new Slot[static_cast<size_t>(std::max(tilesX, 0)) *
+                         std::max(tilesY, 0)]) {}
+
+    ~HorizontalShiftGridInverse() { gInverseGridTilesSize -= size; }
+
+    HorizontalShiftGridInverse(const HorizontalShiftGridInverse &) = delete;
+    HorizontalShiftGridInverse &
+    operator=(const HorizontalShiftGridInverse &) = delete;
+
+    // Reserves the memory of a tile. Returns false if the limit is reached.
+    bool reserveTile() {
+        size_t cur = gInverseGridTilesSize.load();
+        do {
+            if (cur + TILE_SIZE_BYTES > MAX_INVERSE_GRID_TILES_SIZE)
+                return false;
+        } while (!gInverseGridTilesSize.compare_exchange_weak(
+            cur, cur + TILE_SIZE_BYTES));
+        size += TILE_SIZE_BYTES;
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------
+
 HorizontalShiftGrid::HorizontalShiftGrid(const std::string &nameIn, int widthIn,
                                          int heightIn,
                                          const ExtentAndRes &extentIn)
-    : Grid(nameIn, widthIn, heightIn, extentIn) {}
+    : Grid(nameIn, widthIn, heightIn, extentIn),
+      m_inverse(std::make_unique<HorizontalShiftGridInverse>(widthIn,
+                                                             heightIn)) {}
 
 // ---------------------------------------------------------------------------
 
@@ -1908,6 +2918,12 @@ bool NTv1Grid::valueAt(int x, int y, bool compensateNTConvention,
                        float &longShift, float &latShift) const {
     assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
 
+    std::unique_lock<std::mutex> fileLock;
+    if (pj_trans_handle_for(m_ctx)) {
+        // Shared by threads running a compiled transformation
+        fileLock = std::unique_lock<std::mutex>(m_fp->sharedAccessMutex());
+    }
+
     double two_doubles[2];
     // NTv1 is organized from east to west !
     m_fp->seek(192 + 2 * sizeof(double) * (y * m_width + m_width - 1 - x));
@@ -2032,6 +3048,12 @@ bool CTable2Grid::valueAt(int x, int y, bool compensateNTConvention,
                           float &longShift, float &latShift) const {
     assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
 
+    std::unique_lock<std::mutex> fileLock;
+    if (pj_trans_handle_for(m_ctx)) {
+        // Shared by threads running a compiled transformation
+        fileLock = std::unique_lock<std::mutex>(m_fp->sharedAccessMutex());
+    }
+
     float two_floats[2];
     m_fp->seek(160 + 2 * sizeof(float) * (y * m_width + x));
     if (m_fp->read(&two_floats[0], sizeof(two_floats)) != sizeof(two_floats)) {
@@ -2082,6 +3104,7 @@ class NTv2Grid : public HorizontalShiftGrid {
     PJ_CONTEXT *m_ctx;                 // owned by the parent NTv2GridSet
     File *m_fp;                        // owned by the parent NTv2GridSet
     FloatLineCache *m_cache = nullptr; // owned by the parent NTv2GridSet
+    const unsigned char *m_data = nullptr; // when the file is memory-mapped
     uint32_t m_gridIdx;
     unsigned long long m_offset;
     bool m_mustSwap;
@@ -2090,6 +3113,12 @@ class NTv2Grid : public HorizontalShiftGrid {
     NTv2Grid(const NTv2Grid &) = delete;
     NTv2Grid &operator=(const NTv2Grid &) = delete;
 
+    const std::vector<float> *readLine(int y) const;
+
+    static bool toRadians(float latShiftSeconds, float longShiftSeconds,
+                          bool compensateNTConvention, float &longShift,
+                          float &latShift);
+
   public:
     NTv2Grid(const std::string &nameIn, PJ_CONTEXT *ctx, File *fp,
              uint32_t gridIdx, unsigned long long offsetIn, bool mustSwapIn,
@@ -2107,6 +3136,8 @@ class NTv2Grid : public HorizontalShiftGrid {
 
     void setCache(FloatLineCache *cache) { m_cache = cache; }
 
+    void setData(const unsigned char *data) { m_data = data; }
+
     void reassign_context(PJ_CONTEXT *ctx) override {
         m_ctx = ctx;
         m_fp->reassign_context(ctx);
@@ -2121,13 +3152,55 @@ bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
                        float &longShift, float &latShift) const {
     assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
 
+    if (m_data) {
+        // There are 4 components: lat shift, long shift, lat error, long
+        // error. NTv2 is organized from east to west !
+        float shifts[2];
+        memcpy(shifts,
+               m_data + 4 * sizeof(float) *
+                            (static_cast<size_t>(y) * m_width +
+                             (m_width - 1 - x)),
+               sizeof(shifts));
+        if (m_mustSwap) {
+            swap_words(shifts, sizeof(float), 2);
+        }
+        return toRadians(shifts[0], shifts[1], compensateNTConvention,
+                         longShift, latShift);
+    }
+
+    if (auto scratch = pj_trans_handle_scratch<FloatLineScratch>(m_ctx, this)) {
+        if (scratch->lineNumber != y) {
+            std::lock_guard<std::mutex> lock(m_fp->sharedAccessMutex());
+            scratch->lineNumber = -1;
+            const std::vector<float> *pLine = readLine(y);
+            if (pLine == nullptr)
+                return false;
+            scratch->line = *pLine;
+            scratch->lineNumber = y;
+        }
+        return toRadians(scratch->line[2 * x], scratch->line[2 * x + 1],
+                         compensateNTConvention, longShift, latShift);
+    }
+
+    const std::vector<float> *pLine = readLine(y);
+    if (pLine == nullptr)
+        return false;
+    return toRadians((*pLine)[2 * x], (*pLine)[2 * x + 1],
+                     compensateNTConvention, longShift, latShift);
+}
+
+// ---------------------------------------------------------------------------
+
+// Return the line y, with the long and lat shifts of each column from west
+// to east, from the cache or read from the file, or nullptr in case of error.
+const std::vector<float> *NTv2Grid::readLine(int y) const {
     const std::vector<float> *pBuffer = m_cache->get(m_gridIdx, y);
     if (pBuffer == nullptr) {
         try {
             m_buffer.resize(4 * m_width);
         } catch (const std::exception &e) {
             pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            return false;
+            return nullptr;
         }
 
         const size_t nLineSizeInBytes = 4 * sizeof(float) * m_width;
@@ -2137,7 +3210,7 @@ bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
         if (m_fp->read(&m_buffer[0], nLineSizeInBytes) != nLineSizeInBytes) {
             proj_context_errno_set(
                 m_ctx, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-            return false;
+            return nullptr;
         }
         // Remove lat and long error
         for (int i = 1; i < m_width; ++i) {
@@ -2154,6 +3227,7 @@ bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
             std::swap(m_buffer[2 * i + 1], m_buffer[2 * (m_width - 1 - i) + 1]);
         }
 
+        pBuffer = &m_buffer;
         try {
             m_cache->insert(m_gridIdx, y, m_buffer);
         } catch (const std::exception &e) {
@@ -2161,14 +3235,20 @@ bool NTv2Grid::valueAt(int x, int y, bool compensateNTConvention,
             pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
         }
     }
-    const std::vector<float> &buffer = pBuffer ? *pBuffer : m_buffer;
+    return pBuffer;
+}
+
+// ---------------------------------------------------------------------------
 
+bool NTv2Grid::toRadians(float latShiftSeconds, float longShiftSeconds,
+                         bool compensateNTConvention, float &longShift,
+                         float &latShift) {
     /* convert seconds to radians */
-    latShift = static_cast<float>(buffer[2 * x] * ((M_PI / 180.0) / 3600.0));
+    latShift = static_cast<float>(latShiftSeconds * ((M_PI / 180.0) / 3600.0));
     // west longitude positive convention !
     longShift =
         (compensateNTConvention ? -1 : 1) *
-        static_cast<float>(buffer[2 * x + 1] * ((M_PI / 180.0) / 3600.0));
+        static_cast<float>(longShiftSeconds * ((M_PI / 180.0) / 3600.0));
     return true;
 }
 
@@ -2330,9 +3410,32 @@ std::unique_ptr<NTv2GridSet> NTv2GridSet::open(PJ_CONTEXT *ctx,
                     SEEK_CUR);
     }
 
+    // Local uncompressed files can be read directly from their mapping,
+    // without read() calls nor cache.
+    unsigned long long fileSize = 0;
+    const unsigned char *data = fpRaw->mappedData(fileSize);
+    if (data) {
+        for (const auto &kv : mapGrids) {
+            const auto grid = kv.second;
+            const unsigned long long gridSize =
+                4 * sizeof(float) *
+                static_cast<unsigned long long>(grid->m_width) * grid->m_height;
+            if (grid->m_offset + gridSize > fileSize) {
+                data = nullptr;
+                break;
+            }
+        }
+    }
+    if (data) {
+        for (const auto &kv : mapGrids) {
+            kv.second->setData(data + kv.second->m_offset);
+        }
+        return set;
+    }
+
     // Cache up to 1 megapixel per NTv2 file
     const int maxLinesInCache = 1024 * 1024 / largestLine;
-    set->m_cache = std::make_unique<FloatLineCache>(maxLinesInCache);
+    set->m_cache = std::make_unique<FloatLineCache>(maxLinesInCache, fpRaw);
     for (const auto &kv : mapGrids) {
         kv.second->setCache(set->m_cache.get());
     }
@@ -2847,8 +3950,7 @@ class GTiffGenericGrid final : public GenericShiftGrid {
 
     std::unique_ptr<GTiffGrid> m_grid;
     const GenericShiftGrid *m_firstGrid = nullptr;
-    mutable std::string m_type{};
-    mutable bool m_bTypeSet = false;
+    std::string m_type{};
 
   public:
     GTiffGenericGrid(std::unique_ptr<GTiffGrid> &&grid);
@@ -2880,21 +3982,19 @@ class GTiffGenericGrid final : public GenericShiftGrid {
         return ret;
     }
 
-    const std::string &type() const override {
-        if (!m_bTypeSet) {
-            m_bTypeSet = true;
-            m_type = metadataItem("TYPE");
-        }
-        return m_type;
-    }
+    const std::string &type() const override { return m_type; }
 
     void setFirstGrid(const GenericShiftGrid *firstGrid) {
         m_firstGrid = firstGrid;
+        m_type = metadataItem("TYPE");
     }
 
     void insertGrid(PJ_CONTEXT *ctx,
                     std::unique_ptr<GTiffGenericGrid> &&subgrid);
 
+    void prefetch(double west, double south, double east,
+                  double north) const override;
+
     void reassign_context(PJ_CONTEXT *ctx) override {
         m_grid->reassign_context(ctx);
     }
@@ -2915,7 +4015,7 @@ GTiffGenericGridShiftSet::~GTiffGenericGridShiftSet() = default;
 GTiffGenericGrid::GTiffGenericGrid(std::unique_ptr<GTiffGrid> &&grid)
     : GenericShiftGrid(grid->name(), grid->width(), grid->height(),
                        grid->extentAndRes()),
-      m_grid(std::move(grid)) {}
+      m_grid(std::move(grid)), m_type(m_grid->metadataItem("TYPE")) {}
 
 // ---------------------------------------------------------------------------
 
@@ -2932,6 +4032,26 @@ bool GTiffGenericGrid::valueAt(int x, int y, int sample, float &out) const {
 
 // ---------------------------------------------------------------------------
 
+void GTiffGenericGrid::prefetch(double west, double south, double east,
+                                double north) const {
+    const auto &extent = extentAndRes();
+    if (west > extent.east || east < extent.west || south > extent.north ||
+        north < extent.south) {
+        return;
+    }
+    const auto toPixel = [](double v, double invRes, int size) {
+        return static_cast<int>(std::max(
+            0.0, std::min(static_cast<double>(size - 1), v * invRes)));
+    };
+    m_grid->prefetch(toPixel(west - extent.west, extent.invResX, m_width),
+                     toPixel(south - extent.south, extent.invResY, m_height),
+                     toPixel(east - extent.west, extent.invResX, m_width),
+                     toPixel(north - extent.south, extent.invResY, m_height));
+    GenericShiftGrid::prefetch(west, south, east, north);
+}
+
+// ---------------------------------------------------------------------------
+
 bool GTiffGenericGrid::valuesAt(int x_start, int y_start, int x_count,
                                 int y_count, int sample_count,
                                 const int *sample_idx, float *out,
@@ -3082,6 +4202,15 @@ bool GenericShiftGrid::valuesAt(int x_start, int y_start, int x_count,
 
 // ---------------------------------------------------------------------------
 
+void GenericShiftGrid::prefetch(double west, double south, double east,
+                                double north) const {
+    for (const auto &child : m_children) {
+        child->prefetch(west, south, east, north);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 GenericShiftGridSet::GenericShiftGridSet() = default;
 
 // ---------------------------------------------------------------------------
@@ -3200,6 +4329,15 @@ const GenericShiftGrid *GenericShiftGridSet::gridAt(const std::string &type,
 
 // ---------------------------------------------------------------------------
 
+void GenericShiftGridSet::prefetch(double west, double south, double east,
+                                   double north) const {
+    for (const auto &grid : m_grids) {
+        grid->prefetch(west, south, east, north);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 void GenericShiftGridSet::reassign_context(PJ_CONTEXT *ctx) {
     for (const auto &grid : m_grids) {
         grid->reassign_context(ctx);
@@ -3396,6 +4534,186 @@ static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
 #define MAX_ITERATIONS 10
 #define TOL 1e-12
 
+// Compute the position t such that t plus its shift is tb, iterating within
+// a single grid.
+static bool pj_hgrid_inverse_in_grid(const HorizontalShiftGrid *grid,
+                                     PJ_LP tb, PJ_LP &t) {
+    t = pj_hgrid_interpolate(tb, grid, true);
+    if (t.lam == HUGE_VAL)
+        return false;
+    t.lam = tb.lam - t.lam;
+    t.phi = tb.phi - t.phi;
+    for (int i = 0; i < MAX_ITERATIONS; ++i) {
+        const PJ_LP del = pj_hgrid_interpolate(t, grid, true);
+        if (del.lam == HUGE_VAL)
+            return false;
+        const double difLam = t.lam + del.lam - tb.lam;
+        const double difPhi = t.phi + del.phi - tb.phi;
+        t.lam -= difLam;
+        t.phi -= difPhi;
+        if (difLam * difLam + difPhi * difPhi <= TOL * TOL)
+            return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+
+// Applies to the estimate t of the position whose shifted position is tb the
+// correction of one step of the iteration.
+static bool pj_hgrid_inverse_correct(const HorizontalShiftGrid *grid,
+                                     PJ_LP tb, PJ_LP &t) {
+    const PJ_LP del = pj_hgrid_interpolate(t, grid, true);
+    if (del.lam == HUGE_VAL)
+        return false;
+    t.lam -= t.lam + del.lam - tb.lam;
+    t.phi -= t.phi + del.phi - tb.phi;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// Maximum difference, in radians, between the interpolated inverse shift
+// followed by one step of the iteration and the iterated one, at each sample
+// point of a cell, for the former to be used directly. This is the tolerance
+// of the iteration.
+#define MAX_INVERSE_RESIDUAL TOL
+// Number of sample points along each axis of a cell for the above check
+#define INVERSE_RESIDUAL_SAMPLES 3
+
+static std::unique_ptr<HorizontalShiftGridInverse::Tile>
+pj_hgrid_build_inverse_tile(const HorizontalShiftGrid *grid, int tileX,
+                            int tileY) {
+    constexpr int TILE_SIZE = HorizontalShiftGridInverse::TILE_SIZE;
+    constexpr int N = HorizontalShiftGridInverse::NODES_PER_LINE;
+    const auto &extent = grid->extentAndRes();
+    auto tile = std::make_unique<HorizontalShiftGridInverse::Tile>();
+    tile->longShift.resize(N * N, std::numeric_limits<double>::quiet_NaN());
+    tile->latShift.resize(N * N, std::numeric_limits<double>::quiet_NaN());
+    tile->accurate.resize(TILE_SIZE * TILE_SIZE, false);
+
+    const int x0 = tileX * TILE_SIZE;
+    const int y0 = tileY * TILE_SIZE;
+    const int nodesX = std::min(N, grid->width() - x0);
+    const int nodesY = std::min(N, grid->height() - y0);
+    for (int j = 0; j < nodesY; ++j) {
+        for (int i = 0; i < nodesX; ++i) {
+            PJ_LP tb;
+            tb.lam = (x0 + i) * extent.resX;
+            tb.phi = (y0 + j) * extent.resY;
+            PJ_LP t;
+            if (pj_hgrid_inverse_in_grid(grid, tb, t)) {
+                tile->longShift[j * N + i] = tb.lam - t.lam;
+                tile->latShift[j * N + i] = tb.phi - t.phi;
+            }
+        }
+    }
+
+    // Checks the interpolated inverse, corrected by one step of the
+    // iteration, against the iterated one at a regular set of interior
+    // points of each cell.
+    for (int j = 0; j + 1 < nodesY; ++j) {
+        for (int i = 0; i + 1 < nodesX; ++i) {
+            const int idx = j * N + i;
+            bool accurate = true;
+            for (int sj = 1; accurate && sj <= INVERSE_RESIDUAL_SAMPLES;
+                 ++sj) {
+                for (int si = 1; accurate && si <= INVERSE_RESIDUAL_SAMPLES;
+                     ++si) {
+                    const double fracX =
+                        static_cast<double>(si) /
+                        (INVERSE_RESIDUAL_SAMPLES + 1);
+                    const double fracY =
+                        static_cast<double>(sj) /
+                        (INVERSE_RESIDUAL_SAMPLES + 1);
+                    const double m00 = (1 - fracX) * (1 - fracY);
+                    const double m10 = fracX * (1 - fracY);
+                    const double m01 = (1 - fracX) * fracY;
+                    const double m11 = fracX * fracY;
+                    const double longShift =
+                        m00 * tile->longShift[idx] +
+                        m10 * tile->longShift[idx + 1] +
+                        m01 * tile->longShift[idx + N] +
+                        m11 * tile->longShift[idx + N + 1];
+                    const double latShift = m00 * tile->latShift[idx] +
+                                            m10 * tile->latShift[idx + 1] +
+                                            m01 * tile->latShift[idx + N] +
+                                            m11 * tile->latShift[idx + N + 1];
+                    PJ_LP tb;
+                    tb.lam = (x0 + i + fracX) * extent.resX;
+                    tb.phi = (y0 + j + fracY) * extent.resY;
+                    PJ_LP estimate;
+                    estimate.lam = tb.lam - longShift;
+                    estimate.phi = tb.phi - latShift;
+                    PJ_LP t;
+                    // NaN shifts fail the comparisons
+                    accurate =
+                        pj_hgrid_inverse_in_grid(grid, tb, t) &&
+                        pj_hgrid_inverse_correct(grid, tb, estimate) &&
+                        std::fabs(estimate.lam - t.lam) <=
+                            MAX_INVERSE_RESIDUAL &&
+                        std::fabs(estimate.phi - t.phi) <= MAX_INVERSE_RESIDUAL;
+                }
+            }
+            tile->accurate[j * TILE_SIZE + i] = accurate;
+        }
+    }
+    return tile;
+}
+
+// ---------------------------------------------------------------------------
+
+bool HorizontalShiftGrid::inverseShiftAt(double x, double y, double &longShift,
+                                         double &latShift,
+                                         bool &accurate) const {
+    accurate = false;
+    const auto &extent = extentAndRes();
+    const double fx = x / extent.resX;
+    const double fy = y / extent.resY;
+    // Also rejects NaN
+    if (!(fx >= 0 && fy >= 0 && fx < m_width - 1 && fy < m_height - 1))
+        return false;
+
+    constexpr int TILE_SIZE = HorizontalShiftGridInverse::TILE_SIZE;
+    constexpr int N = HorizontalShiftGridInverse::NODES_PER_LINE;
+    const int ix = static_cast<int>(fx);
+    const int iy = static_cast<int>(fy);
+    const int tileX = ix / TILE_SIZE;
+    const int tileY = iy / TILE_SIZE;
+    auto &slot =
+        m_inverse->slots[static_cast<size_t>(tileY) * m_inverse->tilesX +
+                         tileX];
+    std::call_once(slot.once, [this, &slot, tileX, tileY]() {
+        if (m_inverse->reserveTile())
+            slot.tile = pj_hgrid_build_inverse_tile(this, tileX, tileY);
+    });
+    const auto tile = slot.tile.get();
+    if (!tile)
+        return false;
+
+    const int cellX = ix - tileX * TILE_SIZE;
+    const int cellY = iy - tileY * TILE_SIZE;
+    const int idx = cellY * N + cellX;
+    const double fracX = fx - ix;
+    const double fracY = fy - iy;
+    const double m00 = (1 - fracX) * (1 - fracY);
+    const double m10 = fracX * (1 - fracY);
+    const double m01 = (1 - fracX) * fracY;
+    const double m11 = fracX * fracY;
+    longShift = m00 * tile->longShift[idx] + m10 * tile->longShift[idx + 1] +
+                m01 * tile->longShift[idx + N] +
+                m11 * tile->longShift[idx + N + 1];
+    latShift = m00 * tile->latShift[idx] + m10 * tile->latShift[idx + 1] +
+               m01 * tile->latShift[idx + N] +
+               m11 * tile->latShift[idx + N + 1];
+    if (std::isnan(longShift) || std::isnan(latShift))
+        return false;
+    accurate = tile->accurate[cellY * TILE_SIZE + cellX];
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
                                      PJ_DIRECTION direction,
                                      const HorizontalShiftGrid *grid,
@@ -3422,33 +4740,64 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
         tb.lam -= 2 * M_PI;
     tb.phi -= extent->south;
 
-    t = pj_hgrid_interpolate(tb, grid, true);
-    if (grid->hasChanged()) {
-        shouldRetry = gridset->reopen(ctx);
-        return t;
-    }
-    if (t.lam == HUGE_VAL)
-        return t;
-
-    if (direction == PJ_FWD) {
-        in.lam += t.lam;
-        in.phi += t.phi;
-        return in;
+    bool hasInitialGuess = false;
+    if (direction == PJ_INV && ctx->precomputedInverseGrids) {
+        double longShift = 0;
+        double latShift = 0;
+        bool accurate = false;
+        if (grid->inverseShiftAt(tb.lam, tb.phi, longShift, latShift,
+                                 accurate)) {
+            if (grid->hasChanged()) {
+                shouldRetry = gridset->reopen(ctx);
+                return in;
+            }
+            t.lam = tb.lam - longShift;
+            t.phi = tb.phi - latShift;
+            // A single step of the iteration is then enough
+            if (accurate && pj_hgrid_inverse_correct(grid, tb, t)) {
+                if (grid->hasChanged()) {
+                    shouldRetry = gridset->reopen(ctx);
+                    return in;
+                }
+                in.lam = adjlon(t.lam + extent->west);
+                in.phi = t.phi + extent->south;
+                return in;
+            }
+            t.lam = tb.lam - longShift;
+            t.phi = tb.phi - latShift;
+            hasInitialGuess = true;
+        }
     }
 
-    t.lam = tb.lam - t.lam;
-    t.phi = tb.phi - t.phi;
-
-    do {
-        del = pj_hgrid_interpolate(t, grid, true);
+    if (!hasInitialGuess) {
+        t = pj_hgrid_interpolate(tb, grid, true);
         if (grid->hasChanged()) {
             shouldRetry = gridset->reopen(ctx);
             return t;
         }
+        if (t.lam == HUGE_VAL)
+            return t;
+
+        if (direction == PJ_FWD) {
+            in.lam += t.lam;
+            in.phi += t.phi;
+            return in;
+        }
+
+        t.lam = tb.lam - t.lam;
+        t.phi = tb.phi - t.phi;
+    }
+
+    do {
+        del = pj_hgrid_interpolate(t, grid, true);
 
         /* We can possibly go outside of the initial guessed grid, so try */
         /* to fetch a new grid into which iterate... */
         if (del.lam == HUGE_VAL) {
+            if (grid->hasChanged()) {
+                shouldRetry = gridset->reopen(ctx);
+                return t;
+            }
             PJ_LP lp;
             lp.lam = t.lam + extent->west;
             lp.phi = t.phi + extent->south;
@@ -3481,6 +4830,12 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
     } while (--i && (dif.lam * dif.lam + dif.phi * dif.phi >
                      toltol)); /* prob. slightly faster than hypot() */
 
+    /* Checked once after the loop, rather than at each iteration */
+    if (grid->hasChanged()) {
+        shouldRetry = gridset->reopen(ctx);
+        return t;
+    }
+
     if (i == 0) {
         pj_log(ctx, PJ_LOG_TRACE,
                "Inverse grid shift iterator failed to converge.\n");
@@ -3919,6 +5274,43 @@ bool pj_bilinear_interpolation_three_samples(
     return true;
 }
 
+// ---------------------------------------------------------------------------
+
+// Prefetch the parts of a grid intersecting the area, expressed in radians.
+// Only GeoTIFF grids with a geographic extent are concerned.
+// Returns false if the grid cannot be opened.
+static bool pj_prefetch_grid(PJ_CONTEXT *ctx, const std::string &gridName,
+                             double west, double south, double east,
+                             double north) {
+    auto fp = FileManager::open_resource_file(ctx, gridName.c_str());
+    if (!fp) {
+        return false;
+    }
+    unsigned char header[4];
+    const size_t header_size = fp->read(header, sizeof(header));
+    if (!IsTIFF(header_size, header)) {
+        return true;
+    }
+#ifdef TIFF_ENABLED
+    fp->seek(0);
+    const std::string actualName(fp->name());
+    auto set = GTiffGenericGridShiftSet::open(ctx, std::move(fp), actualName);
+    if (!set) {
+        return false;
+    }
+    if (!set->grids().empty() &&
+        set->grids().front()->extentAndRes().isGeographic) {
+        set->prefetch(west, south, east, north);
+    }
+#else
+    (void)west;
+    (void)south;
+    (void)east;
+    (void)north;
+#endif
+    return true;
+}
+
 NS_PROJ_END
 
 /*****************************************************************************/
@@ -4095,3 +5487,264 @@ PJ_INIT_INFO proj_init_info(const char *initname) {
 
     return ininfo;
 }
+
+// ---------------------------------------------------------------------------
+
+void pj_clear_shared_grid_cache() { NS_PROJ::gSharedGridCache.clear(); }
+
+// ---------------------------------------------------------------------------
+
+/** Set the maximum size of the process-wide cache of decoded grid data.
+ *
+ * When enabled, the lines and blocks read from GTX, NTv2 and GeoTIFF grids
+ * are stored in a cache shared by all PJ objects and contexts of the process,
+ * instead of each grid keeping its own copy. This is mostly useful for
+ * applications using many contexts, typically one per thread, that use the
+ * same grids.
+ *
+ * The cache is disabled by default.
+ *
+ * @param max_size_bytes Maximum size of the cache, in bytes, or 0 to disable
+ *                       it. Reducing the size evicts the least recently used
+ *                       entries.
+ * @since 9.6
+ */
+void proj_grid_shared_cache_set_max_size(size_t max_size_bytes) {
+    NS_PROJ::gSharedGridCache.setMaxSize(max_size_bytes);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Remove all entries from the process-wide cache of decoded grid data,
+ * and reset its statistics.
+ *
+ * @since 9.6
+ */
+void proj_grid_shared_cache_clear(void) { pj_clear_shared_grid_cache(); }
+
+// ---------------------------------------------------------------------------
+
+/** Get statistics about the process-wide cache of decoded grid data.
+ *
+ * @param stats Pointer to the structure to fill. Must not be NULL.
+ * @since 9.6
+ */
+void proj_grid_shared_cache_get_stats(PJ_GRID_SHARED_CACHE_STATS *stats) {
+    if (!stats)
+        return;
+    NS_PROJ::gSharedGridCache.getStats(*stats);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Enable or disable the memory mapping of local grid files.
+ *
+ * When enabled, GTX, NTv2 and uncompressed GeoTIFF grids opened from local
+ * files through the default file API are memory-mapped (on platforms with
+ * mmap()), and their values are read directly from the mapping instead of
+ * through reads and caches.
+ *
+ * Grid files must then not be modified in place while they are in use:
+ * changes may or may not be seen through the mapping, and a file that is
+ * truncated makes transformations crash (SIGBUS) instead of failing. Files
+ * replaced by renaming a new file over them are not affected.
+ *
+ * The setting applies to grids opened afterwards with the context. Memory
+ * mapping is disabled by default.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if grid files may be memory-mapped.
+ * @since 9.6
+ */
+void proj_context_set_enable_grid_memory_mapping(PJ_CONTEXT *ctx,
+                                                 int enabled) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->gridMemoryMapping = enabled != FALSE;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Enable or disable the use of precomputed inverse grids for horizontal
+ * grid shifts (hgridshift and nadgrids).
+ *
+ * By default, the inverse of a horizontal grid shift is computed by iterating
+ * bilinear interpolations of the grid, which is several times slower than the
+ * forward direction. When enabled, the first time a region of a grid is used
+ * in the inverse direction, an inverse grid is derived for it and cached with
+ * the grid, so that subsequent inverse shifts in that region need a single
+ * interpolation of the inverse grid followed by a single step of the
+ * iteration. The full iteration is still used near the edges of the grids,
+ * in cells where this differs from the iterated inverse by more than the
+ * tolerance of the iteration (1e-12 radian) at any of a set of sample points,
+ * and once the inverse grids of all the grids of the process use 64 MB.
+ *
+ * Only the hgridshift operation and the +nadgrids parameter use precomputed
+ * inverse grids. The gridshift and deformation operations keep iterating.
+ *
+ * The setting applies to operations created afterwards with the context, as
+ * well as to existing ones.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if precomputed inverse grids should be used.
+ * @since 9.6
+ */
+void proj_context_set_enable_precomputed_inverse_grids(PJ_CONTEXT *ctx,
+                                                       int enabled) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->precomputedInverseGrids = enabled != FALSE;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Set the number of threads decoding the blocks of GeoTIFF grids ahead of
+ * their use.
+ *
+ * Without read-ahead, a block of a tiled or stripped GeoTIFF grid that is
+ * not cached is read and decompressed by the transforming thread the first
+ * time a coordinate falls in it. With read-ahead, each time this happens,
+ * the neighbouring blocks that are not cached yet are queued for decoding
+ * by a pool of worker threads, so that they are usually ready when the
+ * transformation moves into them. This mostly benefits compressed grids
+ * (DEFLATE, LZW) read in spatially coherent order.
+ *
+ * The context has a single pool of workers for all its grids, started the
+ * first time a block is needed. Workers read the files through the same
+ * handles as the transforming thread, one at a time. If a custom file API
+ * is set with proj_context_set_fileapi(), its callbacks may thus be called
+ * from the worker threads. Grids accessed through the network are not read
+ * ahead.
+ *
+ * The setting applies to grids opened afterwards with the context. Changing
+ * it stops the current workers.
+ * Read-ahead is disabled by default.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param thread_count Number of worker threads of the context, or 0 to
+ *                     disable read-ahead.
+ * @since 9.6
+ */
+void proj_context_set_grid_read_ahead_threads(PJ_CONTEXT *ctx,
+                                              int thread_count) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    thread_count = std::max(0, thread_count);
+    if (thread_count != ctx->gridReadAheadThreads) {
+        pj_delete_grid_read_ahead_pool(ctx->gridReadAheadPool);
+        ctx->gridReadAheadPool = nullptr;
+    }
+    ctx->gridReadAheadThreads = thread_count;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Get statistics about the decoding of GeoTIFF grid blocks ahead of their
+ * use (see proj_context_set_grid_read_ahead_threads()), for the grids used
+ * with the context.
+ *
+ * A block needed by a transformation counts as a hit if it had been decoded,
+ * or was being decoded, by the worker threads, and as a miss if the
+ * transforming thread had to decode it itself.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param stats Pointer to the structure to fill. Must not be NULL.
+ * @since 9.6
+ */
+void proj_context_get_grid_read_ahead_stats(PJ_CONTEXT *ctx,
+                                            PJ_GRID_READ_AHEAD_STATS *stats) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    if (!stats)
+        return;
+    *stats = ctx->gridReadAheadStats;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Download in advance the parts of the grids used by a coordinate operation
+ * that intersect an area of interest.
+ *
+ * This is useful before transforming a batch of coordinates with an
+ * operation using grids accessed through the network (see
+ * proj_context_set_enable_network()). Without it, each part of a grid that
+ * is not yet in the local cache of grid chunks is downloaded when a
+ * coordinate falling in it is transformed. This function instead determines
+ * all the parts of the grids covering the area, and downloads the missing
+ * ones with several concurrent requests, adjacent parts being grouped in
+ * the same request. They are stored in the local cache of grid chunks, which
+ * should therefore be enabled (see proj_grid_cache_set_enable()) and large
+ * enough.
+ *
+ * Only GeoTIFF grids with a geographic extent are prefetched. Grids that
+ * are local files are left untouched.
+ *
+ * The network callbacks (see proj_context_set_network_callbacks()) are
+ * called concurrently from several threads, each with its own context.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param P Coordinate operation, possibly with several alternative
+ *          operations as returned by proj_create_crs_to_crs(). Must not be
+ *          NULL.
+ * @param west_lon_degree Western longitude of the area, in degrees.
+ * @param south_lat_degree Southern latitude of the area, in degrees.
+ * @param east_lon_degree Eastern longitude of the area, in degrees.
+ * @param north_lat_degree Northern latitude of the area, in degrees.
+ * @return TRUE if all the grids used by the operation could be opened,
+ *         FALSE otherwise.
+ * @since 9.6
+ */
+int proj_grid_prefetch(PJ_CONTEXT *ctx, PJ *P, double west_lon_degree,
+                       double south_lat_degree, double east_lon_degree,
+                       double north_lat_degree) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    if (P == nullptr) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        pj_log(ctx, PJ_LOG_ERROR, "%s: missing required input", __FUNCTION__);
+        return false;
+    }
+
+    std::vector<PJ *> operations;
+    if (!P->alternativeCoordinateOperations.empty()) {
+        for (const auto &alt : P->alternativeCoordinateOperations) {
+            operations.push_back(alt.pj);
+        }
+    } else {
+        operations.push_back(P);
+    }
+
+    std::set<std::string> gridNames;
+    for (PJ *op : operations) {
+        const int count = proj_coordoperation_get_grid_used_count(ctx, op);
+        for (int i = 0; i < count; ++i) {
+            const char *shortName = nullptr;
+            if (proj_coordoperation_get_grid_used(ctx, op, i, &shortName,
+                                                  nullptr, nullptr, nullptr,
+                                                  nullptr, nullptr, nullptr) &&
+                shortName && shortName[0] != '\0') {
+                gridNames.insert(shortName);
+            }
+        }
+    }
+
+    bool ret = true;
+    for (const auto &gridName : gridNames) {
+        if (gridName == "null")
+            continue;
+        if (!NS_PROJ::pj_prefetch_grid(
+                ctx, gridName, proj_torad(west_lon_degree),
+                proj_torad(south_lat_degree), proj_torad(east_lon_degree),
+                proj_torad(north_lat_degree))) {
+            pj_log(ctx, PJ_LOG_DEBUG, "Cannot open grid %s for prefetching",
+                   gridName.c_str());
+            ret = false;
+        }
+    }
+    return ret;
+}
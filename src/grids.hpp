@@ -137,9 +137,12 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
 
 // ---------------------------------------------------------------------------
 
+struct HorizontalShiftGridInverse;
+
 class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<HorizontalShiftGrid>> m_children{};
+    std::unique_ptr<HorizontalShiftGridInverse> m_inverse{};
 
   public:
     PROJ_FOR_TEST HorizontalShiftGrid(const std::string &nameIn, int widthIn,
@@ -156,6 +159,14 @@ class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
                                        float &longShift,
                                        float &latShift) const = 0;
 
+    // x and y are relative to the south-west corner of the grid, in radians.
+    // Returns the shift to subtract to go from the target to the source
+    // position, estimated from an inverse grid built by tiles on first use.
+    // accurate is set when the estimate, corrected by a single step of the
+    // iteration, can be used without further iteration. Thread-safe.
+    PROJ_FOR_TEST bool inverseShiftAt(double x, double y, double &longShift,
+                                      double &latShift, bool &accurate) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -219,6 +230,11 @@ class PROJ_GCC_DLL GenericShiftGrid : public Grid {
                                         const int *sample_idx, float *out,
                                         bool &nodataFound) const;
 
+    // Hint that the values of the grid, and of its children, intersecting
+    // the area (in the same units as extentAndRes()) will be read soon.
+    PROJ_FOR_TEST virtual void prefetch(double west, double south, double east,
+                                        double north) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -248,6 +264,9 @@ class PROJ_GCC_DLL GenericShiftGridSet {
     PROJ_FOR_TEST const GenericShiftGrid *gridAt(const std::string &type,
                                                  double x, double y) const;
 
+    PROJ_FOR_TEST void prefetch(double west, double south, double east,
+                                double north) const;
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -28,6 +28,8 @@
 
 #define FROM_PROJ_CPP
 
+#include <mutex>
+
 #include "proj.h"
 #include "proj_internal.h"
 
@@ -86,6 +88,9 @@ static char *path_append(char *buf, const char *app, size_t *buf_size) {
 static const char *empty = {""};
 static char version[64] = {""};
 static PJ_INFO info = {0, 0, 0, nullptr, nullptr, nullptr, nullptr, 0};
+// Protects the above static variables. Distinct from the global core lock,
+// so that proj_info() does not contend with object creation.
+static std::mutex gInfoMutex{};
 
 /*****************************************************************************/
 PJ_INFO proj_info(void) {
@@ -97,7 +102,7 @@ PJ_INFO proj_info(void) {
     size_t buf_size = 0;
     char *buf = nullptr;
 
-    pj_acquire_lock();
+    std::lock_guard<std::mutex> lock(gInfoMutex);
 
     info.major = PROJ_VERSION_MAJOR;
     info.minor = PROJ_VERSION_MINOR;
@@ -131,7 +136,6 @@ PJ_INFO proj_info(void) {
     info.paths = ctx->c_compat_paths;
     info.path_count = static_cast<int>(ctx->search_paths.size());
 
-    pj_release_lock();
     return info;
 }
 
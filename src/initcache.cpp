@@ -28,13 +28,30 @@
 #include <assert.h>
 #include <string.h>
 
+#include <memory>
+#include <string>
+
 #include "proj.h"
+#include "proj/internal/snapshot_map.hpp"
 #include "proj_internal.h"
 
-static int cache_count = 0;
-static int cache_alloc = 0;
-static char **cache_key = nullptr;
-static paralist **cache_paralist = nullptr;
+namespace {
+
+struct ParalistDeleter {
+    void operator()(paralist *list) const {
+        for (paralist *next; list != nullptr; list = next) {
+            next = list->next;
+            free(list);
+        }
+    }
+};
+
+// Lookups, which happen for each +init=, only hold a lock to get the
+// current snapshot.
+NS_PROJ::internal::SnapshotMap<std::string, std::shared_ptr<const paralist>>
+    gInitCache{};
+
+} // namespace
 
 /************************************************************************/
 /*                            pj_clone_paralist()                       */
@@ -71,34 +88,7 @@ paralist *pj_clone_paralist(const paralist *list) {
 /*      Clear out all memory held in the init file cache.               */
 /************************************************************************/
 
-void pj_clear_initcache() {
-    if (cache_alloc > 0) {
-        int i;
-
-        pj_acquire_lock();
-
-        for (i = 0; i < cache_count; i++) {
-            paralist *n, *t = cache_paralist[i];
-
-            free(cache_key[i]);
-
-            /* free parameter list elements */
-            for (; t != nullptr; t = n) {
-                n = t->next;
-                free(t);
-            }
-        }
-
-        free(cache_key);
-        free(cache_paralist);
-        cache_count = 0;
-        cache_alloc = 0;
-        cache_key = nullptr;
-        cache_paralist = nullptr;
-
-        pj_release_lock();
-    }
-}
+void pj_clear_initcache() { gInitCache.clear(); }
 
 /************************************************************************/
 /*                            pj_search_initcache()                     */
@@ -109,20 +99,10 @@ void pj_clear_initcache() {
 paralist *pj_search_initcache(const char *filekey)
 
 {
-    int i;
-    paralist *result = nullptr;
-
-    pj_acquire_lock();
-
-    for (i = 0; result == nullptr && i < cache_count; i++) {
-        if (strcmp(filekey, cache_key[i]) == 0) {
-            result = pj_clone_paralist(cache_paralist[i]);
-        }
-    }
-
-    pj_release_lock();
-
-    return result;
+    std::shared_ptr<const paralist> list;
+    if (!gInitCache.find(filekey, list))
+        return nullptr;
+    return pj_clone_paralist(list.get());
 }
 
 /************************************************************************/
@@ -134,46 +114,6 @@ paralist *pj_search_initcache(const char *filekey)
 void pj_insert_initcache(const char *filekey, const paralist *list)
 
 {
-    pj_acquire_lock();
-
-    /*
-    ** Grow list if required.
-    */
-    if (cache_count == cache_alloc) {
-        char **cache_key_new;
-        paralist **cache_paralist_new;
-
-        cache_alloc = cache_alloc * 2 + 15;
-
-        cache_key_new = (char **)malloc(sizeof(char *) * cache_alloc);
-        assert(cache_key_new);
-        if (cache_key && cache_count) {
-            memcpy(cache_key_new, cache_key, sizeof(char *) * cache_count);
-        }
-        free(cache_key);
-        cache_key = cache_key_new;
-
-        cache_paralist_new =
-            (paralist **)malloc(sizeof(paralist *) * cache_alloc);
-        assert(cache_paralist_new);
-        if (cache_paralist && cache_count) {
-            memcpy(cache_paralist_new, cache_paralist,
-                   sizeof(paralist *) * cache_count);
-        }
-        free(cache_paralist);
-        cache_paralist = cache_paralist_new;
-    }
-
-    /*
-    ** Duplicate the filekey and paralist, and insert in cache.
-    */
-    cache_key[cache_count] = (char *)malloc(strlen(filekey) + 1);
-    assert(cache_key[cache_count]);
-    strcpy(cache_key[cache_count], filekey);
-
-    cache_paralist[cache_count] = pj_clone_paralist(list);
-
-    cache_count++;
-
-    pj_release_lock();
+    gInitCache.insert(filekey, std::shared_ptr<const paralist>(
+                                   pj_clone_paralist(list), ParalistDeleter()));
 }
@@ -417,7 +417,7 @@ void proj_context_errno_set(PJ_CONTEXT *ctx, int err) {
     ******************************************************************************/
     if (nullptr == ctx)
         ctx = pj_get_default_ctx();
-    ctx->last_errno = err;
+    pj_ctx_last_errno(ctx) = err;
     if (err == 0)
         return;
     errno = err;
@@ -142,10 +142,10 @@ static void inv_finalize(PJ *P, PJ_COORD &coo) {
 }
 
 static inline PJ_COORD error_or_coord(PJ *P, PJ_COORD coord, int last_errno) {
-    if (P->ctx->last_errno)
+    if (pj_ctx_last_errno(P->ctx))
         return proj_coord_error();
 
-    P->ctx->last_errno = last_errno;
+    pj_ctx_last_errno(P->ctx) = last_errno;
 
     return coord;
 }
@@ -154,8 +154,8 @@ PJ_LP pj_inv(PJ_XY xy, PJ *P) {
     PJ_COORD coo = {{0, 0, 0, 0}};
     coo.xy = xy;
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_inv_prepare)
         inv_prepare(P, coo);
@@ -189,8 +189,8 @@ PJ_LPZ pj_inv3d(PJ_XYZ xyz, PJ *P) {
     PJ_COORD coo = {{0, 0, 0, 0}};
     coo.xyz = xyz;
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_inv_prepare)
         inv_prepare(P, coo);
@@ -222,8 +222,8 @@ PJ_LPZ pj_inv3d(PJ_XYZ xyz, PJ *P) {
 
 bool pj_inv4d(PJ_COORD &coo, PJ *P) {
 
-    const int last_errno = P->ctx->last_errno;
-    P->ctx->last_errno = 0;
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
 
     if (!P->skip_inv_prepare)
         inv_prepare(P, coo);
@@ -254,11 +254,49 @@ bool pj_inv4d(PJ_COORD &coo, PJ *P) {
     if (!P->skip_inv_finalize)
         inv_finalize(P, coo);
 
-    if (P->ctx->last_errno) {
+    if (pj_ctx_last_errno(P->ctx)) {
         coo = proj_coord_error();
         return false;
     }
 
-    P->ctx->last_errno = last_errno;
+    pj_ctx_last_errno(P->ctx) = last_errno;
     return true;
 }
+
+/* Block-wise counterpart of pj_inv4d(). See pj_fwd4d_batch() */
+void pj_inv4d_batch(PJ_COORD *coo, size_t n, PJ *P) {
+    if (!P->inv4d_batch) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL != coo[i].v[0])
+                pj_inv4d(coo[i], P);
+        }
+        return;
+    }
+
+    const int last_errno = pj_ctx_last_errno(P->ctx);
+    pj_ctx_last_errno(P->ctx) = 0;
+
+    if (!P->skip_inv_prepare) {
+        for (size_t i = 0; i < n; i++) {
+            if (HUGE_VAL == coo[i].v[0])
+                continue;
+            inv_prepare(P, coo[i]);
+            if (HUGE_VAL == coo[i].v[0])
+                coo[i] = proj_coord_error();
+        }
+    }
+
+    P->inv4d_batch(coo, n, P);
+
+    for (size_t i = 0; i < n; i++) {
+        if (HUGE_VAL == coo[i].v[0]) {
+            coo[i] = proj_coord_error();
+            continue;
+        }
+        if (!P->skip_inv_finalize)
+            inv_finalize(P, coo[i]);
+    }
+
+    if (pj_ctx_last_errno(P->ctx) == 0)
+        pj_ctx_last_errno(P->ctx) = last_errno;
+}
@@ -30,6 +30,8 @@
 #define FROM_PROJ_CPP
 #endif
 
+#define LRU11_DO_NOT_DEFINE_OUT_OF_CLASS_METHODS
+
 #include <algorithm>
 #include <cassert>
 #include <cstdarg>
@@ -54,6 +56,7 @@
 #include "proj/internal/datum_internal.hpp"
 #include "proj/internal/internal.hpp"
 #include "proj/internal/io_internal.hpp"
+#include "proj/internal/lru_cache.hpp"
 
 // PROJ include order is sensitive
 // clang-format off
@@ -363,6 +366,8 @@ int proj_context_set_database_path(PJ_CONTEXT *ctx, const char *dbPath,
         osPrevDbPath = ctx->cpp_context->getDbPath();
         osPrevAuxDbPaths = ctx->cpp_context->getAuxDbPaths();
     }
+    pj_clear_crs_to_crs_cache(ctx);
+    pj_clear_create_cache(ctx);
     delete ctx->cpp_context;
     ctx->cpp_context = nullptr;
     try {
@@ -564,6 +569,8 @@ PJ *proj_clone(PJ_CONTEXT *ctx, const PJ *obj) {
                         PJCoordOperation(ctx, altOp));
                 }
                 ctx->debug_level = old_debug_level;
+                newPj->alternativeCoordinateOperationsIndex =
+                    obj->alternativeCoordinateOperationsIndex;
             }
             return newPj;
         }
@@ -583,6 +590,74 @@ PJ *proj_clone(PJ_CONTEXT *ctx, const PJ *obj) {
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+
+struct projCreateCache {
+    NS_PROJ::lru11::Cache<std::string, BaseObjectPtr, NS_PROJ::lru11::NullLock>
+        cache;
+
+    explicit projCreateCache(size_t maxSize) : cache(maxSize, 0) {}
+};
+
+void pj_delete_create_cache(projCreateCache *cache) { delete cache; }
+
+void pj_clear_create_cache(PJ_CONTEXT *ctx) {
+    pj_delete_create_cache(ctx->createCache);
+    ctx->createCache = nullptr;
+}
+
+/** Returns the key of the proj_create() cache for a definition, or an empty
+ * string if the cache is disabled. */
+static std::string create_cache_key(PJ_CONTEXT *ctx, const char *text) {
+    if (ctx->createCacheMaxSize <= 0 || text[0] == '\0')
+        return std::string();
+    std::string key(text);
+    key += '\0';
+    key += proj_context_get_use_proj4_init_rules(ctx, FALSE) ? '1' : '0';
+    return key;
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** \brief Set the maximum number of entries of the cache of objects created
+ * by proj_create() with this context.
+ *
+ * When a definition string has already been parsed, the returned PJ object
+ * wraps the cached, immutable, ISO-19111 object instead of parsing the
+ * definition and querying the database again. The cache is cleared when the
+ * database path, the resource search paths or the file finder of the
+ * context are changed, and by proj_cleanup() for the default context.
+ *
+ * The cache is disabled by default. A cloned context inherits the maximum
+ * number of entries, but not the entries themselves.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param max_entries Maximum number of entries, or 0 to disable and clear the
+ * cache.
+ * @since 9.6
+ */
+void proj_create_cache_set_max_size(PJ_CONTEXT *ctx, int max_entries) {
+    SANITIZE_CTX(ctx);
+    pj_clear_create_cache(ctx);
+    ctx->createCacheMaxSize = std::max(0, max_entries);
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Remove all entries from the cache of objects of proj_create().
+ *
+ * @param ctx PROJ context, or NULL
+ * @since 9.6
+ */
+void proj_create_cache_clear(PJ_CONTEXT *ctx) {
+    SANITIZE_CTX(ctx);
+    pj_clear_create_cache(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Instantiate an object from a WKT string, PROJ string, object code
  * (like "EPSG:4326", "urn:ogc:def:crs:EPSG::4326",
  * "urn:ogc:def:coordinateOperation:EPSG::1671"), a PROJJSON string, an object
@@ -607,6 +682,19 @@ PJ *proj_create(PJ_CONTEXT *ctx, const char *text) {
         return nullptr;
     }
 
+    const std::string cacheKey = create_cache_key(ctx, text);
+    if (!cacheKey.empty() && ctx->createCache) {
+        BaseObjectPtr cached;
+        if (ctx->createCache->cache.tryGet(cacheKey, cached)) {
+            try {
+                return pj_obj_create(ctx, NN_NO_CHECK(cached));
+            } catch (const std::exception &e) {
+                proj_log_error(ctx, __FUNCTION__, e.what());
+                return nullptr;
+            }
+        }
+    }
+
     // Only connect to proj.db if needed
     if (strstr(text, "proj=") == nullptr || strstr(text, "init=") != nullptr) {
         getDBcontextNoException(ctx, __FUNCTION__);
@@ -615,7 +703,15 @@ PJ *proj_create(PJ_CONTEXT *ctx, const char *text) {
         auto obj =
             nn_dynamic_pointer_cast<BaseObject>(createFromUserInput(text, ctx));
         if (obj) {
-            return pj_obj_create(ctx, NN_NO_CHECK(obj));
+            auto pj = pj_obj_create(ctx, NN_NO_CHECK(obj));
+            if (pj && !cacheKey.empty()) {
+                if (!ctx->createCache) {
+                    ctx->createCache = new projCreateCache(
+                        static_cast<size_t>(ctx->createCacheMaxSize));
+                }
+                ctx->createCache->cache.insert(cacheKey, obj);
+            }
+            return pj;
         }
     } catch (const io::ParsingException &e) {
         if (proj_context_errno(ctx) == 0) {
@@ -670,6 +766,8 @@ PJ *proj_create(PJ_CONTEXT *ctx, const char *text) {
  * @param out_grammar_errors Pointer to a PROJ_STRING_LIST object, or NULL.
  * If provided, *out_grammar_errors will contain a list of errors regarding the
  * WKT grammar. It must be freed with proj_string_list_destroy().
+ * Since PROJ 9.6, the WKT grammar is only checked if out_grammar_errors is
+ * not NULL or STRICT=YES is set, since the result would be ignored otherwise.
  * @return Object that must be unreferenced with proj_destroy(), or NULL in
  * case of error.
  */
@@ -697,11 +795,11 @@ PJ *proj_create_from_wkt(PJ_CONTEXT *ctx, const char *wkt,
         if (dbContext) {
             parser.attachDatabaseContext(NN_NO_CHECK(dbContext));
         }
-        parser.setStrict(false);
+        bool strict = false;
         for (auto iter = options; iter && iter[0]; ++iter) {
             const char *value;
             if ((value = getOptionValue(*iter, "STRICT="))) {
-                parser.setStrict(ci_equal(value, "YES"));
+                strict = ci_equal(value, "YES");
             } else if ((value = getOptionValue(
                             *iter, "UNSET_IDENTIFIERS_IF_INCOMPATIBLE_DEF="))) {
                 parser.setUnsetIdentifiersIfIncompatibleDef(
@@ -713,6 +811,10 @@ PJ *proj_create_from_wkt(PJ_CONTEXT *ctx, const char *wkt,
                 return nullptr;
             }
         }
+        // Grammar errors are only reported through out_grammar_errors, or
+        // as an exception in strict mode.
+        parser.setStrict(strict);
+        parser.setValidateGrammar(strict || out_grammar_errors != nullptr);
         auto obj = parser.createFromWKT(wkt);
 
         if (out_grammar_errors) {
@@ -3244,6 +3346,93 @@ void proj_unit_list_destroy(PROJ_UNIT_INFO **list) {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Enable or disable the collection of execution statistics of the
+ * SQL queries run against the database of the context.
+ *
+ * This is meant to find which database lookups dominate the time spent in
+ * functions such as proj_create_crs_to_crs(). Enabling the collection resets
+ * the statistics.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param enable TRUE to enable the collection, FALSE to disable it.
+ * @since 9.6
+ */
+void proj_context_set_db_query_profiling(PJ_CONTEXT *ctx, int enable) {
+    SANITIZE_CTX(ctx);
+    try {
+        getDBcontext(ctx)->setQueryProfilingEnabled(enable != FALSE);
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the execution statistics of the SQL queries run against the
+ * database of the context, since proj_context_set_db_query_profiling() was
+ * called to enable their collection.
+ *
+ * The returned object is an array of PROJ_DB_QUERY_STATS* pointers, sorted by
+ * decreasing total execution time, whose last entry is NULL. This array
+ * should be freed with proj_db_query_stats_list_destroy()
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param out_result_count Output parameter pointing to an integer to receive
+ * the size of the result list. Might be NULL
+ * @return an array of PROJ_DB_QUERY_STATS* pointers to be freed with
+ * proj_db_query_stats_list_destroy(), or NULL in case of error.
+ * @since 9.6
+ */
+PROJ_DB_QUERY_STATS **proj_context_get_db_query_stats(PJ_CONTEXT *ctx,
+                                                      int *out_result_count) {
+    SANITIZE_CTX(ctx);
+    PROJ_DB_QUERY_STATS **ret = nullptr;
+    int i = 0;
+    try {
+        const auto list = getDBcontext(ctx)->getQueryStatistics();
+        ret = new PROJ_DB_QUERY_STATS *[list.size() + 1];
+        for (const auto &stats : list) {
+            ret[i] = new PROJ_DB_QUERY_STATS;
+            ret[i]->sql = pj_strdup(stats.sql.c_str());
+            ret[i]->count = stats.count;
+            ret[i]->row_count = stats.rowCount;
+            ret[i]->total_time_ms = stats.totalTimeMs;
+            i++;
+        }
+        ret[i] = nullptr;
+        if (out_result_count)
+            *out_result_count = i;
+        return ret;
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+        if (ret) {
+            ret[i] = nullptr;
+            proj_db_query_stats_list_destroy(ret);
+        }
+        if (out_result_count)
+            *out_result_count = 0;
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Destroy the result returned by proj_context_get_db_query_stats().
+ *
+ * @since 9.6
+ */
+void proj_db_query_stats_list_destroy(PROJ_DB_QUERY_STATS **list) {
+    if (list) {
+        for (int i = 0; list[i] != nullptr; i++) {
+            free(list[i]->sql);
+            delete list[i];
+        }
+        delete[] list;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Return the Conversion of a DerivedCRS (such as a ProjectedCRS),
  * or the Transformation from the baseCRS to the hubCRS of a BoundCRS
  *
@@ -8452,6 +8641,37 @@ void proj_operation_factory_context_set_allow_ballpark_transformations(
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the maximum number of threads used to evaluate the candidate
+ * operations.
+ *
+ * The candidate operations are still searched sequentially in the database,
+ * but the computations made on each of them to sort them may be run
+ * concurrently. The result is the same as with a single thread.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param factory_ctx Operation factory context. must not be NULL
+ * @param thread_count Maximum number of threads. Defaults to 1. A value of 0
+ * or less means the number of processors.
+ * @since 9.6
+ */
+void proj_operation_factory_context_set_thread_count(
+    PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx,
+    int thread_count) {
+    SANITIZE_CTX(ctx);
+    if (!factory_ctx) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "missing required input");
+        return;
+    }
+    try {
+        factory_ctx->operationContext->setThreadCount(thread_count);
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 //! @cond Doxygen_Suppress
 /** \brief Opaque object representing a set of operation results. */
 struct PJ_OPERATION_LIST : PJ_OBJ_LIST {
@@ -9244,6 +9464,9 @@ PJ *proj_normalize_for_visualization(PJ_CONTEXT *ctx, const PJ *obj) {
                         alt.pjDstGeocentricToLonLat);
                 }
             }
+            pjNew->alternativeCoordinateOperationsIndex =
+                pj_create_coord_operation_index(
+                    pjNew->alternativeCoordinateOperations);
             return pjNew.release();
         } catch (const std::exception &e) {
             ctx->forceOver = false;
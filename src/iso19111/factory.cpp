@@ -52,12 +52,15 @@
 #include "sqlite3_utils.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iomanip>
 #include <limits>
+#include <list>
 #include <locale>
 #include <map>
 #include <memory>
@@ -65,6 +68,7 @@
 #include <sstream> // std::ostringstream
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 #include "proj_constants.h"
 
@@ -712,6 +716,334 @@ void SQLiteHandleCache::invalidateHandles() {
 
 // ---------------------------------------------------------------------------
 
+/** In-memory index on the names of the rows returned by a query.
+ *
+ * It is used by AuthorityFactory::createObjectsFromNameEx() so that name
+ * lookups neither run again queries scanning whole tables, nor compare the
+ * searched name with every row. Rows whose name contains a string are found
+ * with inverted indices of the trigrams of the lower-cased names and of the
+ * canonicalized names. Callers that only scan the rows can skip building
+ * those indices.
+ */
+class NameIndex {
+  public:
+    NameIndex(SQLResultSet &&rows, size_t nameColumn, bool buildPostings);
+
+    const std::vector<SQLRow> &rows() const { return rows_; }
+
+    bool hasPostings() const { return hasPostings_; }
+
+    /** Approximate number of bytes used by the index. */
+    size_t memoryUsage() const { return memoryUsage_; }
+
+    void findEqual(const std::string &name, std::vector<uint32_t> &res) const;
+
+    void findContaining(const std::string &name,
+                        const std::string &canonicalizedName,
+                        std::vector<uint32_t> &res) const;
+
+  private:
+    using Postings = std::unordered_map<uint32_t, std::vector<uint32_t>>;
+
+    std::vector<SQLRow> rows_{};
+    std::unordered_map<std::string, std::vector<uint32_t>> mapLowerName_{};
+    Postings trigramsLowerName_{};
+    Postings trigramsCanonicalizedName_{};
+    bool hasPostings_ = false;
+    size_t memoryUsage_ = 0;
+
+    static size_t postingsMemoryUsage(const Postings &postings);
+
+    static std::string asciiLower(const std::string &str);
+
+    static uint32_t trigramAt(const std::string &str, size_t i) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(str[i]))
+                << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(str[i + 1]))
+                << 8) |
+               static_cast<unsigned char>(str[i + 2]);
+    }
+
+    static void addTrigrams(Postings &postings, const std::string &str,
+                            uint32_t idx);
+
+    void findTrigrams(const Postings &postings, const std::string &str,
+                      std::vector<uint32_t> &res) const;
+};
+
+// ---------------------------------------------------------------------------
+
+NameIndex::NameIndex(SQLResultSet &&rows, size_t nameColumn,
+                     bool buildPostings)
+    : hasPostings_(buildPostings) {
+    rows_.reserve(rows.size());
+    memoryUsage_ = sizeof(*this) + rows.size() * sizeof(SQLRow);
+    for (auto &row : rows) {
+        const auto idx = static_cast<uint32_t>(rows_.size());
+        for (const auto &value : row) {
+            memoryUsage_ += sizeof(std::string) + value.capacity();
+        }
+        if (buildPostings) {
+            const auto lowerName = asciiLower(row[nameColumn]);
+            addTrigrams(trigramsLowerName_, lowerName, idx);
+            addTrigrams(trigramsCanonicalizedName_,
+                        asciiLower(metadata::Identifier::canonicalizeName(
+                            row[nameColumn])),
+                        idx);
+            auto &list = mapLowerName_[lowerName];
+            if (list.empty()) {
+                memoryUsage_ += sizeof(std::string) + lowerName.capacity() +
+                                sizeof(std::vector<uint32_t>) +
+                                2 * sizeof(void *);
+            }
+            list.push_back(idx);
+            memoryUsage_ += sizeof(uint32_t);
+        }
+        rows_.emplace_back(std::move(row));
+    }
+    memoryUsage_ += postingsMemoryUsage(trigramsLowerName_) +
+                    postingsMemoryUsage(trigramsCanonicalizedName_);
+}
+
+// ---------------------------------------------------------------------------
+
+size_t NameIndex::postingsMemoryUsage(const Postings &postings) {
+    size_t res = postings.bucket_count() * sizeof(void *);
+    for (const auto &pair : postings) {
+        res += sizeof(pair) + 2 * sizeof(void *) +
+               pair.second.capacity() * sizeof(uint32_t);
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string NameIndex::asciiLower(const std::string &str) {
+    std::string res(str);
+    for (auto &ch : res) {
+        if (ch >= 'A' && ch <= 'Z')
+            ch = static_cast<char>(ch - 'A' + 'a');
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+void NameIndex::addTrigrams(Postings &postings, const std::string &str,
+                           uint32_t idx) {
+    for (size_t i = 0; i + 3 <= str.size(); ++i) {
+        auto &list = postings[trigramAt(str, i)];
+        if (list.empty() || list.back() != idx)
+            list.push_back(idx);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** Sets res to the sorted indices of the rows whose name is equal to name,
+ * ignoring ASCII case, as done by the NOCASE collation of SQLite. */
+void NameIndex::findEqual(const std::string &name,
+                          std::vector<uint32_t> &res) const {
+    const auto iter = mapLowerName_.find(asciiLower(name));
+    if (iter != mapLowerName_.end()) {
+        res = iter->second;
+    } else {
+        res.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** Sets res to the sorted indices of the rows whose lower-cased name may
+ * contain str, from the trigrams of str. All rows are candidates if str is
+ * shorter than a trigram. */
+void NameIndex::findTrigrams(const Postings &postings, const std::string &str,
+                             std::vector<uint32_t> &res) const {
+    res.clear();
+    if (str.size() < 3) {
+        res.resize(rows_.size());
+        for (size_t i = 0; i < rows_.size(); ++i)
+            res[i] = static_cast<uint32_t>(i);
+        return;
+    }
+    std::vector<const std::vector<uint32_t> *> lists;
+    for (size_t i = 0; i + 3 <= str.size(); ++i) {
+        const auto iter = postings.find(trigramAt(str, i));
+        if (iter == postings.end())
+            return;
+        lists.push_back(&(iter->second));
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t> *a,
+                 const std::vector<uint32_t> *b) {
+                  return a->size() < b->size();
+              });
+    res = *(lists.front());
+    std::vector<uint32_t> tmp;
+    for (size_t i = 1; i < lists.size() && !res.empty(); ++i) {
+        if (lists[i] == lists[i - 1])
+            continue;
+        tmp.clear();
+        std::set_intersection(res.begin(), res.end(), lists[i]->begin(),
+                              lists[i]->end(), std::back_inserter(tmp));
+        res.swap(tmp);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** Sets res to the sorted indices of the rows whose name may contain name, or
+ * whose canonicalized name may contain canonicalizedName, ignoring ASCII
+ * case. The matches must be confirmed by the caller. */
+void NameIndex::findContaining(const std::string &name,
+                               const std::string &canonicalizedName,
+                               std::vector<uint32_t> &res) const {
+    std::vector<uint32_t> resName;
+    findTrigrams(trigramsLowerName_, asciiLower(name), resName);
+    std::vector<uint32_t> resCanonicalizedName;
+    findTrigrams(trigramsCanonicalizedName_, asciiLower(canonicalizedName),
+                 resCanonicalizedName);
+    res.clear();
+    std::set_union(resName.begin(), resName.end(),
+                   resCanonicalizedName.begin(), resCanonicalizedName.end(),
+                   std::back_inserter(res));
+}
+
+// ---------------------------------------------------------------------------
+
+/** Process-wide cache of the objects instantiated from databases.
+ *
+ * This is a second level behind the caches of each DatabaseContext, so that
+ * contexts opened on the same database, typically one per thread, can reuse
+ * the objects already instantiated by other contexts. Objects returned by
+ * the factories are immutable and can thus be shared between threads.
+ * Entries are keyed by database identity (paths of the main and auxiliary
+ * databases), kind of object and code. The cache is disabled (max size of 0)
+ * by default. It is split into shards, each with its own lock and LRU list,
+ * to limit contention between threads.
+ */
+class SharedDatabaseObjectCache {
+  public:
+    struct Value {
+        util::BaseObjectPtr obj{};
+        std::vector<operation::CoordinateOperationNNPtr> ops{};
+    };
+
+    bool enabled() const {
+        return maxSize_.load(std::memory_order_relaxed) != 0;
+    }
+
+    bool tryGet(const std::string &key, Value &value);
+
+    void insert(const std::string &key, const Value &value);
+
+    void setMaxSize(size_t maxSize);
+
+    void clear();
+
+    void getStats(PJ_DB_SHARED_CACHE_STATS &stats);
+
+  private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    using CacheType = lru11::Cache<std::string, Value>;
+
+    struct Shard {
+        std::mutex mutex{};
+        std::unique_ptr<CacheType> cache{};
+    };
+
+    std::atomic<size_t> maxSize_{0};
+    std::atomic<unsigned long long> hits_{0};
+    std::atomic<unsigned long long> misses_{0};
+    std::atomic<unsigned long long> evictions_{0};
+    Shard shards_[SHARD_COUNT]{};
+
+    Shard &getShard(const std::string &key) {
+        return shards_[std::hash<std::string>{}(key) % SHARD_COUNT];
+    }
+};
+
+static SharedDatabaseObjectCache gSharedDatabaseObjectCache;
+
+// ---------------------------------------------------------------------------
+
+bool SharedDatabaseObjectCache::tryGet(const std::string &key,
+                                       Value &value) {
+    auto &shard = getShard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.cache && shard.cache->tryGet(key, value)) {
+            ++hits_;
+            return true;
+        }
+    }
+    ++misses_;
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedDatabaseObjectCache::insert(const std::string &key,
+                                       const Value &value) {
+    auto &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.cache) {
+        const size_t maxSize = maxSize_;
+        if (maxSize == 0)
+            return;
+        shard.cache.reset(new CacheType(
+            std::max<size_t>(1, (maxSize + SHARD_COUNT - 1) / SHARD_COUNT),
+            0));
+    }
+    const bool isNew = !shard.cache->contains(key);
+    const size_t sizeBefore = shard.cache->size();
+    shard.cache->insert(key, value);
+    if (isNew && shard.cache->size() <= sizeBefore) {
+        evictions_ += sizeBefore + 1 - shard.cache->size();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedDatabaseObjectCache::setMaxSize(size_t maxSize) {
+    // Shards are created again with the new size on the next insertion
+    maxSize_ = maxSize;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.cache.reset();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedDatabaseObjectCache::clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.cache.reset();
+    }
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedDatabaseObjectCache::getStats(PJ_DB_SHARED_CACHE_STATS &stats) {
+    stats.max_size = maxSize_;
+    stats.entry_count = 0;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.cache)
+            stats.entry_count += shard.cache->size();
+    }
+    stats.hit_count = hits_;
+    stats.miss_count = misses_;
+    stats.eviction_count = evictions_;
+}
+
+// ---------------------------------------------------------------------------
+
 struct DatabaseContext::Private {
     Private();
     ~Private();
@@ -760,6 +1092,11 @@ struct DatabaseContext::Private {
         return mapCanonicalizeGRFName_;
     }
 
+    std::shared_ptr<NameIndex> getNameIndex(const std::string &sql,
+                                            const ListOfParams &parameters,
+                                            size_t nameColumn, bool create,
+                                            bool buildPostings);
+
     // cppcheck-suppress functionStatic
     common::UnitOfMeasurePtr getUOMFromCache(const std::string &code);
     // cppcheck-suppress functionStatic
@@ -810,10 +1147,11 @@ struct DatabaseContext::Private {
     // cppcheck-suppress functionStatic
     bool getCRSToCRSCoordOpFromCache(
         const std::string &code,
-        std::vector<operation::CoordinateOperationNNPtr> &list);
+        std::vector<operation::CoordinateOperationNNPtr> &list, bool shared);
     // cppcheck-suppress functionStatic
     void cache(const std::string &code,
-               const std::vector<operation::CoordinateOperationNNPtr> &list);
+               const std::vector<operation::CoordinateOperationNNPtr> &list,
+               bool shared);
 
     struct GridInfoCache {
         std::string fullFilename{};
@@ -849,7 +1187,16 @@ struct DatabaseContext::Private {
     std::vector<std::string> auxiliaryDatabasePaths_{};
     std::shared_ptr<SQLiteHandle> sqlite_handle_{};
     unsigned int queryCounter_ = 0;
-    std::map<std::string, sqlite3_stmt *> mapSqlToStatement_{};
+
+    // Prepared statements, keyed by SQL text. The statements are finalized
+    // when the last reference on them is released.
+    static constexpr size_t STATEMENT_CACHE_SIZE = 512;
+    lru11::Cache<std::string, std::shared_ptr<sqlite3_stmt>> cacheStatements_{
+        STATEMENT_CACHE_SIZE};
+
+    // Statistics per SQL text, when enabled with setQueryProfilingEnabled()
+    bool profileQueries_ = false;
+    std::map<std::string, QueryStatistics> queryStatistics_{};
     PJ_CONTEXT *pjCtxt_ = nullptr;
     int recLevel_ = 0;
     bool detach_ = false;
@@ -881,14 +1228,35 @@ struct DatabaseContext::Private {
         CACHE_SIZE};
     lru11::Cache<std::string, std::string> cacheNames_{CACHE_SIZE};
 
+    // Indices on the names returned by the queries of
+    // AuthorityFactory::createObjectsFromNameEx() and
+    // AuthorityFactory::getOfficialNameFromAlias(), keyed by SQL text and
+    // parameters. The least recently used ones are evicted once their
+    // approximate total size exceeds NAME_INDEX_CACHE_MAX_BYTES.
+    static constexpr size_t NAME_INDEX_CACHE_MAX_BYTES = 64 * 1024 * 1024;
+    using NameIndexCacheList =
+        std::list<std::pair<std::string, std::shared_ptr<NameIndex>>>;
+    NameIndexCacheList cacheNameIndex_{};
+    std::unordered_map<std::string, NameIndexCacheList::iterator>
+        cacheNameIndexMap_{};
+    size_t cacheNameIndexBytes_ = 0;
+
+    void clearNameIndexCache() {
+        cacheNameIndexMap_.clear();
+        cacheNameIndex_.clear();
+        cacheNameIndexBytes_ = 0;
+    }
+
     std::vector<VersionedAuthName> cacheAuthNameWithVersion_{};
 
-    static void insertIntoCache(LRUCacheOfObjects &cache,
-                                const std::string &code,
-                                const util::BaseObjectPtr &obj);
+    void insertIntoCache(LRUCacheOfObjects &cache, char kind,
+                         const std::string &code,
+                         const util::BaseObjectPtr &obj);
+
+    void getFromCache(LRUCacheOfObjects &cache, char kind,
+                      const std::string &code, util::BaseObjectPtr &obj);
 
-    static void getFromCache(LRUCacheOfObjects &cache, const std::string &code,
-                             util::BaseObjectPtr &obj);
+    std::string sharedCacheKey(char kind, const std::string &code) const;
 
     void closeDB() noexcept;
 
@@ -1021,10 +1389,7 @@ void DatabaseContext::Private::closeDB() noexcept {
         detach_ = false;
     }
 
-    for (auto &pair : mapSqlToStatement_) {
-        sqlite3_finalize(pair.second);
-    }
-    mapSqlToStatement_.clear();
+    cacheStatements_.clear();
 
     sqlite_handle_.reset();
 }
@@ -1046,6 +1411,65 @@ void DatabaseContext::Private::clearCaches() {
     cacheAllowedAuthorities_.clear();
     cacheAliasNames_.clear();
     cacheNames_.clear();
+    clearNameIndexCache();
+}
+
+// ---------------------------------------------------------------------------
+
+/** Returns the index on the names of the rows returned by a query, building
+ * it if create is true, or nullptr. If buildPostings is false, the returned
+ * index may only give access to the rows. */
+std::shared_ptr<NameIndex>
+DatabaseContext::Private::getNameIndex(const std::string &sql,
+                                       const ListOfParams &parameters,
+                                       size_t nameColumn, bool create,
+                                       bool buildPostings) {
+    std::string key(sql);
+    for (const auto &param : parameters) {
+        key += '\0';
+        const auto paramType = param.type();
+        if (paramType == SQLValues::Type::STRING) {
+            key += param.stringValue();
+        } else if (paramType == SQLValues::Type::INT) {
+            key += toString(param.intValue());
+        } else {
+            key += toString(param.doubleValue(), 17);
+        }
+    }
+    const auto iter = cacheNameIndexMap_.find(key);
+    if (iter != cacheNameIndexMap_.end()) {
+        if (!buildPostings || iter->second->second->hasPostings()) {
+            cacheNameIndex_.splice(cacheNameIndex_.begin(), cacheNameIndex_,
+                                   iter->second);
+            return iter->second->second;
+        }
+        if (!create) {
+            return nullptr;
+        }
+        cacheNameIndexBytes_ -= iter->second->second->memoryUsage();
+        cacheNameIndex_.erase(iter->second);
+        cacheNameIndexMap_.erase(iter);
+    }
+    if (!create) {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<NameIndex>(run(sql, parameters), nameColumn,
+                                             buildPostings);
+    const auto indexBytes = index->memoryUsage();
+    if (indexBytes > NAME_INDEX_CACHE_MAX_BYTES) {
+        return index;
+    }
+    while (!cacheNameIndex_.empty() &&
+           cacheNameIndexBytes_ + indexBytes > NAME_INDEX_CACHE_MAX_BYTES) {
+        cacheNameIndexBytes_ -= cacheNameIndex_.back().second->memoryUsage();
+        cacheNameIndexMap_.erase(cacheNameIndex_.back().first);
+        cacheNameIndex_.pop_back();
+    }
+    cacheNameIndex_.emplace_front(key, index);
+    cacheNameIndexMap_[key] = cacheNameIndex_.begin();
+    cacheNameIndexBytes_ += indexBytes;
+    return index;
 }
 
 // ---------------------------------------------------------------------------
@@ -1065,41 +1489,100 @@ const std::shared_ptr<SQLiteHandle> &DatabaseContext::Private::handle() {
 
 // ---------------------------------------------------------------------------
 
+/** Returns the key of gSharedDatabaseObjectCache for an object, or an empty
+ * string if it is disabled or cannot be used for this database. */
+std::string DatabaseContext::Private::sharedCacheKey(
+    char kind, const std::string &code) const {
+    // Databases opened from a sqlite3 handle have no identity, and the ones
+    // in an insertion session may contain objects of their own.
+    if (!gSharedDatabaseObjectCache.enabled() || databasePath_.empty() ||
+        !memoryDbForInsertPath_.empty()) {
+        return std::string();
+    }
+    std::string key(databasePath_);
+    key += '\0';
+    for (const auto &path : auxiliaryDatabasePaths_) {
+        key += path;
+        key += '\0';
+    }
+    key += '\1';
+    key += kind;
+    key += code;
+    return key;
+}
+
+// ---------------------------------------------------------------------------
+
 void DatabaseContext::Private::insertIntoCache(LRUCacheOfObjects &cache,
+                                               char kind,
                                                const std::string &code,
                                                const util::BaseObjectPtr &obj) {
     cache.insert(code, obj);
+    const auto sharedKey = sharedCacheKey(kind, code);
+    if (!sharedKey.empty()) {
+        SharedDatabaseObjectCache::Value value;
+        value.obj = obj;
+        gSharedDatabaseObjectCache.insert(sharedKey, value);
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 void DatabaseContext::Private::getFromCache(LRUCacheOfObjects &cache,
+                                            char kind,
                                             const std::string &code,
                                             util::BaseObjectPtr &obj) {
-    cache.tryGet(code, obj);
+    if (cache.tryGet(code, obj))
+        return;
+    const auto sharedKey = sharedCacheKey(kind, code);
+    if (!sharedKey.empty()) {
+        SharedDatabaseObjectCache::Value value;
+        if (gSharedDatabaseObjectCache.tryGet(sharedKey, value)) {
+            obj = std::move(value.obj);
+            cache.insert(code, obj);
+        }
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 bool DatabaseContext::Private::getCRSToCRSCoordOpFromCache(
     const std::string &code,
-    std::vector<operation::CoordinateOperationNNPtr> &list) {
-    return cacheCRSToCrsCoordOp_.tryGet(code, list);
+    std::vector<operation::CoordinateOperationNNPtr> &list, bool shared) {
+    if (cacheCRSToCrsCoordOp_.tryGet(code, list))
+        return true;
+    const auto sharedKey = shared ? sharedCacheKey('O', code) : std::string();
+    if (!sharedKey.empty()) {
+        SharedDatabaseObjectCache::Value value;
+        if (gSharedDatabaseObjectCache.tryGet(sharedKey, value)) {
+            list = std::move(value.ops);
+            cacheCRSToCrsCoordOp_.insert(code, list);
+            return true;
+        }
+    }
+    return false;
 }
 
 // ---------------------------------------------------------------------------
 
 void DatabaseContext::Private::cache(
     const std::string &code,
-    const std::vector<operation::CoordinateOperationNNPtr> &list) {
+    const std::vector<operation::CoordinateOperationNNPtr> &list,
+    bool shared) {
     cacheCRSToCrsCoordOp_.insert(code, list);
+    const auto sharedKey = shared ? sharedCacheKey('O', code) : std::string();
+    if (!sharedKey.empty()) {
+        SharedDatabaseObjectCache::Value value;
+        value.ops = list;
+        gSharedDatabaseObjectCache.insert(sharedKey, value);
+    }
 }
 
 // ---------------------------------------------------------------------------
 
 crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCRS_, code, obj);
+    getFromCache(cacheCRS_, 'C', code, obj);
     return std::static_pointer_cast<crs::CRS>(obj);
 }
 
@@ -1107,7 +1590,7 @@ crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const crs::CRSNNPtr &crs) {
-    insertIntoCache(cacheCRS_, code, crs.as_nullable());
+    insertIntoCache(cacheCRS_, 'C', code, crs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1115,7 +1598,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 common::UnitOfMeasurePtr
 DatabaseContext::Private::getUOMFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheUOM_, code, obj);
+    getFromCache(cacheUOM_, 'U', code, obj);
     return std::static_pointer_cast<common::UnitOfMeasure>(obj);
 }
 
@@ -1123,7 +1606,7 @@ DatabaseContext::Private::getUOMFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const common::UnitOfMeasureNNPtr &uom) {
-    insertIntoCache(cacheUOM_, code, uom.as_nullable());
+    insertIntoCache(cacheUOM_, 'U', code, uom.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1131,7 +1614,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 datum::GeodeticReferenceFramePtr
 DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheGeodeticDatum_, code, obj);
+    getFromCache(cacheGeodeticDatum_, 'G', code, obj);
     return std::static_pointer_cast<datum::GeodeticReferenceFrame>(obj);
 }
 
@@ -1139,7 +1622,7 @@ DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(
     const std::string &code, const datum::GeodeticReferenceFrameNNPtr &datum) {
-    insertIntoCache(cacheGeodeticDatum_, code, datum.as_nullable());
+    insertIntoCache(cacheGeodeticDatum_, 'G', code, datum.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1147,7 +1630,7 @@ void DatabaseContext::Private::cache(
 datum::DatumEnsemblePtr
 DatabaseContext::Private::getDatumEnsembleFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheDatumEnsemble_, code, obj);
+    getFromCache(cacheDatumEnsemble_, 'D', code, obj);
     return std::static_pointer_cast<datum::DatumEnsemble>(obj);
 }
 
@@ -1155,7 +1638,8 @@ DatabaseContext::Private::getDatumEnsembleFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(
     const std::string &code, const datum::DatumEnsembleNNPtr &datumEnsemble) {
-    insertIntoCache(cacheDatumEnsemble_, code, datumEnsemble.as_nullable());
+    insertIntoCache(cacheDatumEnsemble_, 'D', code,
+                    datumEnsemble.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1163,7 +1647,7 @@ void DatabaseContext::Private::cache(
 datum::EllipsoidPtr
 DatabaseContext::Private::getEllipsoidFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheEllipsoid_, code, obj);
+    getFromCache(cacheEllipsoid_, 'E', code, obj);
     return std::static_pointer_cast<datum::Ellipsoid>(obj);
 }
 
@@ -1171,7 +1655,7 @@ DatabaseContext::Private::getEllipsoidFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const datum::EllipsoidNNPtr &ellps) {
-    insertIntoCache(cacheEllipsoid_, code, ellps.as_nullable());
+    insertIntoCache(cacheEllipsoid_, 'E', code, ellps.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1179,7 +1663,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 datum::PrimeMeridianPtr
 DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cachePrimeMeridian_, code, obj);
+    getFromCache(cachePrimeMeridian_, 'P', code, obj);
     return std::static_pointer_cast<datum::PrimeMeridian>(obj);
 }
 
@@ -1187,7 +1671,7 @@ DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const datum::PrimeMeridianNNPtr &pm) {
-    insertIntoCache(cachePrimeMeridian_, code, pm.as_nullable());
+    insertIntoCache(cachePrimeMeridian_, 'P', code, pm.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1195,7 +1679,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
     const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCS_, code, obj);
+    getFromCache(cacheCS_, 'S', code, obj);
     return std::static_pointer_cast<cs::CoordinateSystem>(obj);
 }
 
@@ -1203,7 +1687,7 @@ cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const cs::CoordinateSystemNNPtr &cs) {
-    insertIntoCache(cacheCS_, code, cs.as_nullable());
+    insertIntoCache(cacheCS_, 'S', code, cs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1211,7 +1695,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 metadata::ExtentPtr
 DatabaseContext::Private::getExtentFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheExtent_, code, obj);
+    getFromCache(cacheExtent_, 'X', code, obj);
     return std::static_pointer_cast<metadata::Extent>(obj);
 }
 
@@ -1219,7 +1703,7 @@ DatabaseContext::Private::getExtentFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const metadata::ExtentNNPtr &extent) {
-    insertIntoCache(cacheExtent_, code, extent.as_nullable());
+    insertIntoCache(cacheExtent_, 'X', code, extent.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -1406,25 +1890,42 @@ SQLResultSet DatabaseContext::Private::run(const std::string &sql,
     auto l_handle = handle();
     assert(l_handle);
 
-    sqlite3_stmt *stmt = nullptr;
-    auto iter = mapSqlToStatement_.find(sql);
-    if (iter != mapSqlToStatement_.end()) {
-        stmt = iter->second;
-        sqlite3_reset(stmt);
-    } else {
+    std::shared_ptr<sqlite3_stmt> stmt;
+    if (!cacheStatements_.tryGet(sql, stmt)) {
+        sqlite3_stmt *newStmt = nullptr;
         if (sqlite3_prepare_v2(l_handle->handle(), sql.c_str(),
-                               static_cast<int>(sql.size()), &stmt,
+                               static_cast<int>(sql.size()), &newStmt,
                                nullptr) != SQLITE_OK) {
             throw FactoryException("SQLite error on " + sql + ": " +
                                    sqlite3_errmsg(l_handle->handle()));
         }
-        mapSqlToStatement_.insert(
-            std::pair<std::string, sqlite3_stmt *>(sql, stmt));
+        stmt.reset(newStmt, sqlite3_finalize);
+        cacheStatements_.insert(sql, stmt);
     }
 
     ++queryCounter_;
 
-    return l_handle->run(stmt, sql, parameters, useMaxFloatPrecision);
+    // Reset the statement once done, so that it does not keep a read
+    // transaction open until its next use.
+    struct StatementResetter {
+        sqlite3_stmt *stmt_;
+        ~StatementResetter() { sqlite3_reset(stmt_); }
+    } resetter{stmt.get()};
+
+    if (!profileQueries_) {
+        return l_handle->run(stmt.get(), sql, parameters,
+                             useMaxFloatPrecision);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto res = l_handle->run(stmt.get(), sql, parameters, useMaxFloatPrecision);
+    auto &stats = queryStatistics_[sql];
+    ++stats.count;
+    stats.rowCount += res.size();
+    stats.totalTimeMs += std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    return res;
 }
 
 // ---------------------------------------------------------------------------
@@ -1485,6 +1986,8 @@ static std::string formatStatement(const char *fmt, ...) {
 void DatabaseContext::Private::appendSql(
     std::vector<std::string> &sqlStatements, const std::string &sql) {
     sqlStatements.emplace_back(sql);
+    // The names in the database are modified
+    clearNameIndexCache();
     char *errMsg = nullptr;
     if (sqlite3_exec(memoryDbHandle_->handle(), sql.c_str(), nullptr, nullptr,
                      &errMsg) != SQLITE_OK) {
@@ -3505,6 +4008,41 @@ unsigned int DatabaseContext::getQueryCounter() const {
 
 // ---------------------------------------------------------------------------
 
+/** Enable or disable the collection of statistics about the SQL queries run
+ * by this instance, returned by getQueryStatistics().
+ *
+ * Enabling the collection resets the statistics.
+ */
+void DatabaseContext::setQueryProfilingEnabled(bool enable) {
+    d->profileQueries_ = enable;
+    if (enable) {
+        d->queryStatistics_.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** Returns statistics about the SQL queries run since
+ * setQueryProfilingEnabled(true) was called, sorted by decreasing total
+ * execution time.
+ */
+std::vector<DatabaseContext::QueryStatistics>
+DatabaseContext::getQueryStatistics() const {
+    std::vector<QueryStatistics> res;
+    res.reserve(d->queryStatistics_.size());
+    for (const auto &pair : d->queryStatistics_) {
+        res.emplace_back(pair.second);
+        res.back().sql = pair.first;
+    }
+    std::sort(res.begin(), res.end(),
+              [](const QueryStatistics &a, const QueryStatistics &b) {
+                  return a.totalTimeMs > b.totalTimeMs;
+              });
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
 bool DatabaseContext::isKnownName(const std::string &name,
                                   const std::string &tableName) const {
     std::string sql("SELECT 1 FROM \"");
@@ -7024,7 +7562,8 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
 
     std::vector<operation::CoordinateOperationNNPtr> list;
 
-    if (d->context()->d->getCRSToCRSCoordOpFromCache(cacheKey, list)) {
+    if (d->context()->d->getCRSToCRSCoordOpFromCache(
+            cacheKey, list, !discardIfMissingGrid)) {
         return list;
     }
 
@@ -7066,7 +7605,8 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
                 }
                 if (ok) {
                     list.emplace_back(conv);
-                    d->context()->d->cache(cacheKey, list);
+                    d->context()->d->cache(cacheKey, list,
+                                           !discardIfMissingGrid);
                     return list;
                 }
             }
@@ -7320,7 +7860,7 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
             }
         }
     }
-    d->context()->d->cache(cacheKey, list);
+    d->context()->d->cache(cacheKey, list, !discardIfMissingGrid);
     return list;
 }
 
@@ -8971,11 +9511,11 @@ std::string AuthorityFactory::getOfficialNameFromAlias(
             sql += "source = ?";
             params.push_back(source);
         }
-        auto res = d->run(sql, params);
-        if (res.empty()) {
-            return std::string();
-        }
-        for (const auto &row : res) {
+        // The aliases are kept in memory, since this is called repeatedly
+        // when identifying objects.
+        const auto nameIndex = d->context()->getPrivate()->getNameIndex(
+            sql, params, 3, /* create = */ true, /* buildPostings = */ false);
+        for (const auto &row : nameIndex->rows()) {
             const auto &alt_name = row[3];
             if (metadata::Identifier::isEquivalentName(alt_name.c_str(),
                                                        aliasedName.c_str())) {
@@ -8985,7 +9525,7 @@ std::string AuthorityFactory::getOfficialNameFromAlias(
                 sql = "SELECT name FROM \"";
                 sql += replaceAll(outTableName, "\"", "\"\"");
                 sql += "\" WHERE auth_name = ? AND code = ?";
-                res = d->run(sql, {outAuthName, outCode});
+                const auto res = d->run(sql, {outAuthName, outCode});
                 if (res.empty()) { // shouldn't happen normally
                     return std::string();
                 }
@@ -9108,10 +9648,6 @@ AuthorityFactory::createObjectsFromNameEx(
         return {};
     }
 
-    std::string sql(
-        "SELECT table_name, auth_name, code, name, deprecated, is_alias "
-        "FROM (");
-
     const auto getTableAndTypeConstraints = [&allowedObjectTypes,
                                              &searchedName]() {
         typedef std::pair<std::string, std::string> TableType;
@@ -9257,87 +9793,93 @@ AuthorityFactory::createObjectsFromNameEx(
     }
 
     const auto listTableNameType = getTableAndTypeConstraints();
-    bool first = true;
-    ListOfParams params;
-    for (const auto &tableNameTypePair : listTableNameType) {
-        if (!first) {
-            sql += " UNION ";
-        }
-        first = false;
-        sql += "SELECT '";
-        sql += tableNameTypePair.first;
-        sql += "' AS table_name, auth_name, code, name, deprecated, "
-               "0 AS is_alias FROM ";
-        sql += tableNameTypePair.first;
-        sql += " WHERE 1 = 1 ";
-        if (!tableNameTypePair.second.empty()) {
-            if (tableNameTypePair.second == "frame_reference_epoch") {
-                sql += "AND frame_reference_epoch IS NOT NULL ";
-            } else if (tableNameTypePair.second == "ensemble") {
-                sql += "AND ensemble_accuracy IS NOT NULL ";
-            } else {
-                sql += "AND type = '";
-                sql += tableNameTypePair.second;
-                sql += "' ";
-            }
-        }
-        if (deprecated) {
-            sql += "AND deprecated = 1 ";
-        }
-        if (!approximateMatch) {
-            sql += "AND name = ? COLLATE NOCASE ";
-            params.push_back(searchedNameWithoutDeprecated);
-        }
-        if (d->hasAuthorityRestriction()) {
-            sql += "AND auth_name = ? ";
-            params.emplace_back(d->authority());
-        }
-
-        sql += " UNION SELECT '";
-        sql += tableNameTypePair.first;
-        sql += "' AS table_name, "
-               "ov.auth_name AS auth_name, "
-               "ov.code AS code, a.alt_name AS name, "
-               "ov.deprecated AS deprecated, 1 as is_alias FROM ";
-        sql += tableNameTypePair.first;
-        sql += " ov "
-               "JOIN alias_name a ON "
-               "ov.auth_name = a.auth_name AND ov.code = a.code WHERE "
-               "a.table_name = '";
-        sql += tableNameTypePair.first;
-        sql += "' ";
-        if (!tableNameTypePair.second.empty()) {
-            if (tableNameTypePair.second == "frame_reference_epoch") {
-                sql += "AND ov.frame_reference_epoch IS NOT NULL ";
-            } else if (tableNameTypePair.second == "ensemble") {
-                sql += "AND ov.ensemble_accuracy IS NOT NULL ";
-            } else {
-                sql += "AND ov.type = '";
-                sql += tableNameTypePair.second;
-                sql += "' ";
+
+    // Builds the query on all the names of the allowed objects, or only on
+    // the ones equal to the searched name if withNameFilter is set
+    const auto buildSQL = [this, &listTableNameType, deprecated,
+                           &searchedNameWithoutDeprecated](
+                              bool withNameFilter, ListOfParams &params) {
+        std::string sql(
+            "SELECT table_name, auth_name, code, name, deprecated, is_alias "
+            "FROM (");
+        bool first = true;
+        for (const auto &tableNameTypePair : listTableNameType) {
+            if (!first) {
+                sql += " UNION ";
+            }
+            first = false;
+            sql += "SELECT '";
+            sql += tableNameTypePair.first;
+            sql += "' AS table_name, auth_name, code, name, deprecated, "
+                   "0 AS is_alias FROM ";
+            sql += tableNameTypePair.first;
+            sql += " WHERE 1 = 1 ";
+            if (!tableNameTypePair.second.empty()) {
+                if (tableNameTypePair.second == "frame_reference_epoch") {
+                    sql += "AND frame_reference_epoch IS NOT NULL ";
+                } else if (tableNameTypePair.second == "ensemble") {
+                    sql += "AND ensemble_accuracy IS NOT NULL ";
+                } else {
+                    sql += "AND type = '";
+                    sql += tableNameTypePair.second;
+                    sql += "' ";
+                }
+            }
+            if (deprecated) {
+                sql += "AND deprecated = 1 ";
+            }
+            if (withNameFilter) {
+                sql += "AND name = ? COLLATE NOCASE ";
+                params.push_back(searchedNameWithoutDeprecated);
+            }
+            if (d->hasAuthorityRestriction()) {
+                sql += "AND auth_name = ? ";
+                params.emplace_back(d->authority());
+            }
+
+            sql += " UNION SELECT '";
+            sql += tableNameTypePair.first;
+            sql += "' AS table_name, "
+                   "ov.auth_name AS auth_name, "
+                   "ov.code AS code, a.alt_name AS name, "
+                   "ov.deprecated AS deprecated, 1 as is_alias FROM ";
+            sql += tableNameTypePair.first;
+            sql += " ov "
+                   "JOIN alias_name a ON "
+                   "ov.auth_name = a.auth_name AND ov.code = a.code WHERE "
+                   "a.table_name = '";
+            sql += tableNameTypePair.first;
+            sql += "' ";
+            if (!tableNameTypePair.second.empty()) {
+                if (tableNameTypePair.second == "frame_reference_epoch") {
+                    sql += "AND ov.frame_reference_epoch IS NOT NULL ";
+                } else if (tableNameTypePair.second == "ensemble") {
+                    sql += "AND ov.ensemble_accuracy IS NOT NULL ";
+                } else {
+                    sql += "AND ov.type = '";
+                    sql += tableNameTypePair.second;
+                    sql += "' ";
+                }
+            }
+            if (deprecated) {
+                sql += "AND ov.deprecated = 1 ";
+            }
+            if (withNameFilter) {
+                sql += "AND a.alt_name = ? COLLATE NOCASE ";
+                params.push_back(searchedNameWithoutDeprecated);
+            }
+            if (d->hasAuthorityRestriction()) {
+                sql += "AND ov.auth_name = ? ";
+                params.emplace_back(d->authority());
             }
         }
-        if (deprecated) {
-            sql += "AND ov.deprecated = 1 ";
-        }
-        if (!approximateMatch) {
-            sql += "AND a.alt_name = ? COLLATE NOCASE ";
-            params.push_back(searchedNameWithoutDeprecated);
-        }
-        if (d->hasAuthorityRestriction()) {
-            sql += "AND ov.auth_name = ? ";
-            params.emplace_back(d->authority());
-        }
-    }
 
-    sql += ") ORDER BY deprecated, is_alias, length(name), name";
-    if (limitResultCount > 0 &&
-        limitResultCount <
-            static_cast<size_t>(std::numeric_limits<int>::max()) &&
-        !approximateMatch) {
-        sql += " LIMIT ";
-        sql += toString(static_cast<int>(limitResultCount));
-    }
+        sql += ") ORDER BY deprecated, is_alias, length(name), name";
+        return sql;
+    };
+
+    ListOfParams params;
+    const auto sql = buildSQL(/* withNameFilter = */ false, params);
 
     std::list<PairObjectName> res;
     std::set<std::pair<std::string, std::string>> setIdentified;
@@ -9421,13 +9963,53 @@ AuthorityFactory::createObjectsFromNameEx(
             }
         }
     } else {
-        auto sqlRes = d->run(sql, params);
+        // Approximate searches build an index on all the names, which exact
+        // searches use too if it is available.
+        std::vector<const SQLRow *> rows;
+        SQLResultSet sqlRes;
+        const auto nameIndex = d->context()->getPrivate()->getNameIndex(
+            sql, params, 3, /* create = */ approximateMatch,
+            /* buildPostings = */ true);
+        if (nameIndex) {
+            std::vector<uint32_t> candidates;
+            if (approximateMatch) {
+                nameIndex->findContaining(searchedNameWithoutDeprecated,
+                                          canonicalizedSearchedName,
+                                          candidates);
+            } else {
+                nameIndex->findEqual(searchedNameWithoutDeprecated,
+                                     candidates);
+                if (limitResultCount > 0 &&
+                    candidates.size() > limitResultCount) {
+                    candidates.resize(limitResultCount);
+                }
+            }
+            const auto &indexRows = nameIndex->rows();
+            for (const auto idx : candidates) {
+                rows.push_back(&indexRows[idx]);
+            }
+        } else {
+            ListOfParams paramsWithName;
+            auto sqlWithName =
+                buildSQL(/* withNameFilter = */ true, paramsWithName);
+            if (limitResultCount > 0 &&
+                limitResultCount <
+                    static_cast<size_t>(std::numeric_limits<int>::max())) {
+                sqlWithName += " LIMIT ";
+                sqlWithName += toString(static_cast<int>(limitResultCount));
+            }
+            sqlRes = d->run(sqlWithName, paramsWithName);
+            for (const auto &row : sqlRes) {
+                rows.push_back(&row);
+            }
+        }
         bool isFirst = true;
         bool firstIsDeprecated = false;
         size_t countExactMatch = 0;
         size_t countExactMatchOnAlias = 0;
         std::size_t hashCodeFirstMatch = 0;
-        for (const auto &row : sqlRes) {
+        for (const SQLRow *pRow : rows) {
+            const auto &row = *pRow;
             const auto &name = row[3];
             if (approximateMatch) {
                 bool match = ci_find(name, searchedNameWithoutDeprecated) !=
@@ -10368,3 +10950,55 @@ NS_PROJ_END
 // ---------------------------------------------------------------------------
 
 void pj_clear_sqlite_cache() { NS_PROJ::io::SQLiteHandleCache::get().clear(); }
+
+// ---------------------------------------------------------------------------
+
+void pj_clear_shared_db_cache() {
+    NS_PROJ::io::gSharedDatabaseObjectCache.clear();
+}
+
+// ---------------------------------------------------------------------------
+
+/** Set the maximum number of entries of the process-wide cache of objects
+ * instantiated from the database.
+ *
+ * When enabled, the CRS, datums, ellipsoids, coordinate systems, units,
+ * extents and lists of operations between CRS instantiated from a database
+ * are stored in a cache shared by all contexts of the process using the same
+ * database, in addition to the cache of each context. This is mostly useful
+ * for applications using many contexts, typically one per thread, so that a
+ * new context benefits from the objects already instantiated by the others.
+ *
+ * The cache is disabled by default. Changing its maximum size removes all
+ * its entries.
+ *
+ * @param max_entries Maximum number of entries of the cache, or 0 to disable
+ *                    it.
+ * @since 9.6
+ */
+void proj_db_shared_cache_set_max_size(size_t max_entries) {
+    NS_PROJ::io::gSharedDatabaseObjectCache.setMaxSize(max_entries);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Remove all entries from the process-wide cache of objects instantiated
+ * from the database, and reset its statistics.
+ *
+ * @since 9.6
+ */
+void proj_db_shared_cache_clear(void) { pj_clear_shared_db_cache(); }
+
+// ---------------------------------------------------------------------------
+
+/** Get statistics about the process-wide cache of objects instantiated from
+ * the database.
+ *
+ * @param stats Pointer to the structure to fill. Must not be NULL.
+ * @since 9.6
+ */
+void proj_db_shared_cache_get_stats(PJ_DB_SHARED_CACHE_STATS *stats) {
+    if (!stats)
+        return;
+    NS_PROJ::io::gSharedDatabaseObjectCache.getStats(*stats);
+}
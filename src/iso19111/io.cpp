@@ -1105,8 +1105,15 @@ static size_t skipSpace(const std::string &str, size_t start) {
 
 //! @cond Doxygen_Suppress
 // As used in examples of OGC 12-063r5
-static const std::string startPrintedQuote("\xE2\x80\x9C");
-static const std::string endPrintedQuote("\xE2\x80\x9D");
+static const char startPrintedQuote[] = "\xE2\x80\x9C";
+static const char endPrintedQuote[] = "\xE2\x80\x9D";
+constexpr size_t printedQuoteSize = 3;
+
+static inline bool isPrintedQuote(const char *data, size_t size, size_t i,
+                                  const char *quote) {
+    return i + printedQuoteSize <= size &&
+           memcmp(data + i, quote, printedQuoteSize) == 0;
+}
 //! @endcond
 
 WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
@@ -1114,53 +1121,62 @@ WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
     if (recLevel == 16) {
         throw ParsingException("too many nesting levels");
     }
-    std::string value;
     size_t i = skipSpace(wkt, indexStart);
     if (i == wkt.size()) {
         throw ParsingException("whitespace only string");
     }
-    std::string closingStringMarker;
-    bool inString = false;
 
-    for (; i < wkt.size() &&
-           (inString ||
-            (wkt[i] != '[' && wkt[i] != '(' && wkt[i] != ',' && wkt[i] != ']' &&
-             wkt[i] != ')' && !::isspace(static_cast<unsigned char>(wkt[i]))));
-         ++i) {
-        if (wkt[i] == '"') {
+    // Scan the token in place. The value is only assembled piecewise when
+    // escaped double quotes or printed quotes must be rewritten, so that a
+    // token normally costs a single copy.
+    const char *const data = wkt.data();
+    const size_t size = wkt.size();
+    std::string value;
+    size_t segmentStart = i;
+    bool inString = false;
+    bool inPrintedQuoteString = false;
+    for (; i < size; ++i) {
+        const char ch = data[i];
+        if (!inString &&
+            (ch == '[' || ch == '(' || ch == ',' || ch == ']' || ch == ')' ||
+             ::isspace(static_cast<unsigned char>(ch))))
+            break;
+        if (ch == '"') {
             if (!inString) {
                 inString = true;
-                closingStringMarker = "\"";
-            } else if (closingStringMarker == "\"") {
-                if (i + 1 < wkt.size() && wkt[i + 1] == '"') {
+            } else if (!inPrintedQuoteString) {
+                if (i + 1 < size && data[i + 1] == '"') {
+                    // Escaped double quote: only keep one of them
+                    value.append(data + segmentStart, i + 1 - segmentStart);
                     i++;
+                    segmentStart = i + 1;
                 } else {
                     inString = false;
-                    closingStringMarker.clear();
                 }
             }
-        } else if (i + 3 <= wkt.size() &&
-                   wkt.substr(i, 3) == startPrintedQuote) {
+        } else if (isPrintedQuote(data, size, i, startPrintedQuote)) {
             if (!inString) {
                 inString = true;
-                closingStringMarker = endPrintedQuote;
+                inPrintedQuoteString = true;
+                value.append(data + segmentStart, i - segmentStart);
                 value += '"';
-                i += 2;
-                continue;
+                i += printedQuoteSize - 1;
+                segmentStart = i + 1;
             }
-        } else if (i + 3 <= wkt.size() &&
-                   closingStringMarker == endPrintedQuote &&
-                   wkt.substr(i, 3) == endPrintedQuote) {
+        } else if (inPrintedQuoteString &&
+                   isPrintedQuote(data, size, i, endPrintedQuote)) {
             inString = false;
-            closingStringMarker.clear();
+            inPrintedQuoteString = false;
+            value.append(data + segmentStart, i - segmentStart);
             value += '"';
-            i += 2;
-            continue;
+            i += printedQuoteSize - 1;
+            segmentStart = i + 1;
         }
-        value += wkt[i];
     }
+    value.append(data + segmentStart, i - segmentStart);
+
     i = skipSpace(wkt, i);
-    if (i == wkt.size()) {
+    if (i == size) {
         if (indexStart == 0) {
             throw ParsingException("missing [");
         } else {
@@ -1171,32 +1187,32 @@ WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
     auto node = NN_NO_CHECK(std::make_unique<WKTNode>(value));
 
     if (indexStart > 0) {
-        if (wkt[i] == ',') {
+        if (data[i] == ',') {
             indexEnd = i + 1;
             return node;
         }
-        if (wkt[i] == ']' || wkt[i] == ')') {
+        if (data[i] == ']' || data[i] == ')') {
             indexEnd = i;
             return node;
         }
     }
-    if (wkt[i] != '[' && wkt[i] != '(') {
+    if (data[i] != '[' && data[i] != '(') {
         throw ParsingException("missing [");
     }
     ++i; // skip [
     i = skipSpace(wkt, i);
-    while (i < wkt.size() && wkt[i] != ']' && wkt[i] != ')') {
+    while (i < size && data[i] != ']' && data[i] != ')') {
         size_t indexEndChild;
         node->addChild(createFrom(wkt, i, recLevel + 1, indexEndChild));
         assert(indexEndChild > i);
         i = indexEndChild;
         i = skipSpace(wkt, i);
-        if (i < wkt.size() && wkt[i] == ',') {
+        if (i < size && data[i] == ',') {
             ++i;
             i = skipSpace(wkt, i);
         }
     }
-    if (i == wkt.size() || (wkt[i] != ']' && wkt[i] != ')')) {
+    if (i == size || (data[i] != ']' && data[i] != ')')) {
         throw ParsingException("missing ]");
     }
     indexEnd = i + 1;
@@ -1265,6 +1281,7 @@ struct WKTParser::Private {
 
     bool strict_ = true;
     bool unsetIdentifiersIfIncompatibleDef_ = true;
+    bool validateGrammar_ = true;
     std::list<std::string> warningList_{};
     std::list<std::string> grammarErrorList_{};
     std::vector<double> toWGS84Parameters_{};
@@ -1503,6 +1520,23 @@ WKTParser &WKTParser::setUnsetIdentifiersIfIncompatibleDef(bool unset) {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set whether the WKT string should be validated against the WKT
+ *         grammar.
+ *
+ * Validation requires a second pass over the string with a grammar parser,
+ * and is enabled by default. When it is disabled, grammarErrorList() is
+ * always empty, and grammar errors do not cause an exception in strict mode.
+ * Callers that ignore grammar errors can disable it to speed up parsing.
+ *
+ * @since PROJ 9.6
+ */
+WKTParser &WKTParser::setValidateGrammar(bool validate) {
+    d->validateGrammar_ = validate;
+    return *this;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Return the list of warnings found during parsing.
  *
  * \note The list might be non-empty only is setStrict(false) has been called.
@@ -7569,9 +7603,12 @@ static BaseObjectNNPtr createFromUserInput(const std::string &text,
                     if (isspace(static_cast<unsigned char>(*wkt)))
                         continue;
                     if (*wkt == '[') {
+                        // Grammar errors would be ignored: do not bother
+                        // looking for them
                         return WKTParser()
                             .attachDatabaseContext(dbContext)
                             .setStrict(false)
+                            .setValidateGrammar(false)
                             .createFromWKT(text);
                     }
                     break;
@@ -8288,17 +8325,19 @@ BaseObjectNNPtr WKTParser::createFromWKT(const std::string &wkt) {
 
     auto obj = build();
 
-    if (dialect == WKTGuessedDialect::WKT1_GDAL ||
-        dialect == WKTGuessedDialect::WKT1_ESRI) {
-        auto errorMsg = pj_wkt1_parse(wkt);
-        if (!errorMsg.empty()) {
-            d->emitGrammarError(errorMsg);
-        }
-    } else if (dialect == WKTGuessedDialect::WKT2_2015 ||
-               dialect == WKTGuessedDialect::WKT2_2019) {
-        auto errorMsg = pj_wkt2_parse(wkt);
-        if (!errorMsg.empty()) {
-            d->emitGrammarError(errorMsg);
+    if (d->validateGrammar_) {
+        if (dialect == WKTGuessedDialect::WKT1_GDAL ||
+            dialect == WKTGuessedDialect::WKT1_ESRI) {
+            auto errorMsg = pj_wkt1_parse(wkt);
+            if (!errorMsg.empty()) {
+                d->emitGrammarError(errorMsg);
+            }
+        } else if (dialect == WKTGuessedDialect::WKT2_2015 ||
+                   dialect == WKTGuessedDialect::WKT2_2019) {
+            auto errorMsg = pj_wkt2_parse(wkt);
+            if (!errorMsg.empty()) {
+                d->emitGrammarError(errorMsg);
+            }
         }
     }
 
@@ -56,12 +56,15 @@
 #include "proj_constants.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 // #define TRACE_CREATE_OPERATIONS
@@ -185,6 +188,7 @@ struct CoordinateOperationContext::Private {
         std::make_shared<util::optional<common::DataEpoch>>()};
     std::shared_ptr<util::optional<common::DataEpoch>> targetCoordinateEpoch_{
         std::make_shared<util::optional<common::DataEpoch>>()};
+    int threadCount_ = 1;
 
     Private() = default;
     Private(const Private &) = default;
@@ -496,6 +500,35 @@ CoordinateOperationContext::getTargetCoordinateEpoch() const {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the maximum number of threads used to evaluate the candidate
+ * operations.
+ *
+ * The candidate operations are still searched sequentially in the database,
+ * but the computations made on each of them to sort them, such as their
+ * export as PROJ strings, may be run concurrently. The result is the same as
+ * with a single thread.
+ *
+ * The default is 1. A value of 0 or less means the number of processors.
+ *
+ * @since 9.6
+ */
+void CoordinateOperationContext::setThreadCount(int threadCount) {
+    d->threadCount_ = threadCount;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the maximum number of threads used to evaluate the
+ * candidate operations.
+ *
+ * @since 9.6
+ */
+int CoordinateOperationContext::getThreadCount() const {
+    return d->threadCount_;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Creates a context for a coordinate operation.
  *
  * If a non null authorityFactory is provided, the resulting context should
@@ -819,6 +852,66 @@ CoordinateOperationPtr CoordinateOperationFactory::createOperation(
 
 // ---------------------------------------------------------------------------
 
+/** Calls func(i) for each i in [0, count[, using up to threadCount threads
+ * (all processors if threadCount <= 0). func must not throw, and must only
+ * write to data specific to i. */
+static void runInParallel(size_t count, int threadCount,
+                          const std::function<void(size_t)> &func) {
+    // Below that, the cost of starting threads is not worth it
+    constexpr size_t MIN_ITEMS_PER_THREAD = 4;
+
+#ifdef __MINGW32__
+    // std::thread is not available with all MinGW toolchains
+    threadCount = 1;
+#else
+    if (threadCount <= 0)
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+#endif
+    const size_t nThreads =
+        std::min(static_cast<size_t>(std::max(threadCount, 1)),
+                 count / MIN_ITEMS_PER_THREAD);
+    if (nThreads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+#ifndef __MINGW32__
+    std::atomic<size_t> next{0};
+    const auto worker = [&next, count, &func]() {
+        for (size_t i = next++; i < count; i = next++) {
+            func(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (size_t i = 1; i < nThreads; ++i) {
+        try {
+            threads.emplace_back(worker);
+        } catch (const std::exception &) {
+            // Remaining items will be processed by the running threads
+            break;
+        }
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+/** Result of the export of an operation as a PROJ string. */
+struct ExportedPROJString {
+    bool isPROJExportable_ = false;
+    std::string projString_{};
+    size_t projStepCount_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+
 struct PrecomputedOpCharacteristics {
     double area_{};
     double accuracy_{};
@@ -1184,6 +1277,9 @@ struct FilterResults {
     bool hasOpThatContainsAreaOfInterestAndNoGrid = false;
     std::vector<CoordinateOperationNNPtr> res{};
 
+    // PROJ strings of the operations of res, computed by sort()
+    std::map<CoordinateOperation *, ExportedPROJString> mapPROJString{};
+
     // ----------------------------------------------------------------------
     void computeAreaOfInterest() {
 
@@ -1371,8 +1467,40 @@ struct FilterResults {
         // Precompute a number of parameters for each operation that will be
         // useful for the sorting.
         std::map<CoordinateOperation *, PrecomputedOpCharacteristics> map;
+
+        // Exporting operations as PROJ strings is the most CPU intensive part,
+        // and does not involve the database, so it can be done in parallel.
+        std::vector<ExportedPROJString> exportedOps(res.size());
+        runInParallel(res.size(), context->getThreadCount(),
+                      [this, &exportedOps](size_t i) {
+                          auto &exported = exportedOps[i];
+                          auto formatter = io::PROJStringFormatter::create();
+                          try {
+                              exported.projString_ =
+                                  res[i]->exportToPROJString(formatter.get());
+                              // Grids might be missing, but at least this is
+                              // something PROJ could potentially process
+                              exported.isPROJExportable_ = true;
+
+                              // We exclude pipelines with +proj=xyzgridshift
+                              // as they generate more steps, but are more
+                              // precise.
+                              const auto &str = exported.projString_;
+                              if (str.find("+proj=xyzgridshift") ==
+                                  std::string::npos) {
+                                  auto formatter2 =
+                                      io::PROJStringFormatter::create();
+                                  formatter2->ingestPROJString(str);
+                                  exported.projStepCount_ =
+                                      formatter2->getStepCount();
+                              }
+                          } catch (const std::exception &) {
+                          }
+                      });
+
         const auto gridAvailabilityUse = context->getGridAvailabilityUse();
-        for (const auto &op : res) {
+        for (size_t iOp = 0; iOp < res.size(); ++iOp) {
+            const auto &op = res[iOp];
             bool dummy = false;
             auto extentOp = getExtent(op, true, dummy);
             double area = 0.0;
@@ -1425,24 +1553,8 @@ struct FilterResults {
 
             const auto stepCount = getStepCount(op);
 
-            bool isPROJExportable = false;
-            auto formatter = io::PROJStringFormatter::create();
-            size_t projStepCount = 0;
-            try {
-                const auto str = op->exportToPROJString(formatter.get());
-                // Grids might be missing, but at least this is something
-                // PROJ could potentially process
-                isPROJExportable = true;
-
-                // We exclude pipelines with +proj=xyzgridshift as they
-                // generate more steps, but are more precise.
-                if (str.find("+proj=xyzgridshift") == std::string::npos) {
-                    auto formatter2 = io::PROJStringFormatter::create();
-                    formatter2->ingestPROJString(str);
-                    projStepCount = formatter2->getStepCount();
-                }
-            } catch (const std::exception &) {
-            }
+            const bool isPROJExportable = exportedOps[iOp].isPROJExportable_;
+            const size_t projStepCount = exportedOps[iOp].projStepCount_;
 
 #if 0
             std::cerr << "name=" << op->nameStr() << " ";
@@ -1471,6 +1583,7 @@ struct FilterResults {
                 op->nameStr().find(BALLPARK_VERTICAL_TRANSFORMATION) !=
                     std::string::npos,
                 isNullTransformation(op->nameStr()));
+            mapPROJString[op.get()] = std::move(exportedOps[iOp]);
         }
 
         // Sort !
@@ -1601,9 +1714,15 @@ struct FilterResults {
         std::set<std::string> setPROJPlusExtent;
         std::vector<CoordinateOperationNNPtr> resTemp;
         for (const auto &op : res) {
-            auto formatter = io::PROJStringFormatter::create();
+            // Reuse the PROJ string computed by sort()
+            const auto iter = mapPROJString.find(op.get());
+            if (iter == mapPROJString.end() ||
+                !iter->second.isPROJExportable_) {
+                resTemp.emplace_back(op);
+                continue;
+            }
             try {
-                std::string key(op->exportToPROJString(formatter.get()));
+                std::string key(iter->second.projString_);
                 bool dummy = false;
                 auto extentOp = getExtent(op, true, dummy);
                 if (extentOp) {
@@ -197,11 +197,17 @@ void proj_cleanup() {
     if (cpp_context) {
         cpp_context->closeDb();
     }
+    pj_clear_crs_to_crs_cache(ctx);
+    pj_clear_create_cache(ctx);
 
     pj_clear_initcache();
     FileManager::clearMemoryCache();
     pj_clear_hgridshift_knowngrids_cache();
     pj_clear_vgridshift_knowngrids_cache();
     pj_clear_gridshift_knowngrids_cache();
+    pj_clear_tinshift_cache();
+    pj_clear_defmodel_cache();
+    pj_clear_shared_grid_cache();
+    pj_clear_shared_db_cache();
     pj_clear_sqlite_cache();
 }
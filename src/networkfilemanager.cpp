@@ -40,7 +40,11 @@
 #include <algorithm>
 #include <limits>
 #include <mutex>
+#include <set>
 #include <string>
+#ifndef __MINGW32__
+#include <thread>
+#endif
 
 #include "filemanager.hpp"
 #include "proj.h"
@@ -97,6 +101,8 @@ static void sleep_ms(int ms) {
 
 constexpr size_t DOWNLOAD_CHUNK_SIZE = 16 * 1024;
 constexpr int MAX_CHUNKS = 64;
+// Maximum number of concurrent requests issued by NetworkFile::prefetch()
+constexpr size_t MAX_PREFETCH_THREADS = 4;
 
 struct FileProperties {
     unsigned long long size = 0;
@@ -1247,6 +1253,9 @@ class NetworkFile : public File {
     unsigned long long tell() override;
     void reassign_context(PJ_CONTEXT *ctx) override;
     bool hasChanged() const override { return m_hasChanged; }
+    std::string contentIdentity() override;
+    void prefetch(const std::vector<std::pair<unsigned long long, size_t>>
+                      &ranges) override;
 
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename);
 
@@ -1257,6 +1266,17 @@ class NetworkFile : public File {
 
 // ---------------------------------------------------------------------------
 
+std::string NetworkFile::contentIdentity() {
+    std::string ret(m_url);
+    ret += '\0';
+    ret += std::to_string(m_props.size);
+    ret += '\0';
+    ret += m_props.etag.empty() ? m_props.lastModified : m_props.etag;
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
 bool NetworkFile::get_props_from_headers(PJ_CONTEXT *ctx,
                                          PROJ_NETWORK_HANDLE *handle,
                                          FileProperties &props) {
@@ -1457,6 +1477,135 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
 // ---------------------------------------------------------------------------
 
+// Download the chunks covering the ranges that are not already cached.
+// Adjacent chunks are coalesced into requests of up to MAX_CHUNKS chunks,
+// which are issued concurrently, each thread using its own context and
+// network handle. The downloaded chunks are then inserted in the memory and
+// disk chunk caches, where the subsequent read() calls will find them.
+void NetworkFile::prefetch(
+    const std::vector<std::pair<unsigned long long, size_t>> &ranges) {
+    if (m_hasChanged)
+        return;
+
+    std::set<unsigned long long> chunkIndices;
+    for (const auto &range : ranges) {
+        if (range.second == 0 || range.first >= m_props.size)
+            continue;
+        const auto endOffset = std::min(
+            m_props.size, range.first + static_cast<unsigned long long>(
+                                            range.second));
+        for (auto idx = range.first / DOWNLOAD_CHUNK_SIZE;
+             idx * DOWNLOAD_CHUNK_SIZE < endOffset; ++idx) {
+            chunkIndices.insert(idx);
+        }
+    }
+
+    struct Request {
+        unsigned long long firstChunkIdx;
+        size_t chunkCount;
+        std::vector<unsigned char> data{};
+    };
+    std::vector<Request> requests;
+    for (const auto idx : chunkIndices) {
+        if (gNetworkChunkCache.get(m_ctx, m_url, idx) != nullptr)
+            continue;
+        if (!requests.empty() &&
+            requests.back().firstChunkIdx + requests.back().chunkCount ==
+                idx &&
+            requests.back().chunkCount < static_cast<size_t>(MAX_CHUNKS)) {
+            requests.back().chunkCount++;
+        } else {
+            requests.push_back(Request{idx, 1});
+        }
+    }
+    if (requests.empty())
+        return;
+
+    const size_t nThreads = std::min(MAX_PREFETCH_THREADS, requests.size());
+    const auto downloader = [this, &requests, nThreads](PJ_CONTEXT *ctx,
+                                                        size_t iThread) {
+        PROJ_NETWORK_HANDLE *handle = nullptr;
+        std::string errorBuffer;
+        for (size_t i = iThread; i < requests.size(); i += nThreads) {
+            auto &req = requests[i];
+            req.data.resize(req.chunkCount * DOWNLOAD_CHUNK_SIZE);
+            errorBuffer.assign(1024, '\0');
+            size_t nRead = 0;
+            const auto offset = req.firstChunkIdx * DOWNLOAD_CHUNK_SIZE;
+            if (!handle) {
+                handle = ctx->networking.open(
+                    ctx, m_url.c_str(), offset, req.data.size(),
+                    req.data.data(), &nRead, errorBuffer.size(),
+                    &errorBuffer[0], ctx->networking.user_data);
+            } else {
+                nRead = ctx->networking.read_range(
+                    ctx, handle, offset, req.data.size(), req.data.data(),
+                    errorBuffer.size(), &errorBuffer[0],
+                    ctx->networking.user_data);
+            }
+            if (nRead == 0) {
+                errorBuffer.resize(strlen(errorBuffer.data()));
+                if (!errorBuffer.empty()) {
+                    pj_log(ctx, PJ_LOG_DEBUG, "Cannot prefetch in %s: %s",
+                           m_url.c_str(), errorBuffer.c_str());
+                }
+                req.data.clear();
+                if (!handle)
+                    break;
+            } else {
+                req.data.resize(nRead);
+            }
+        }
+        if (handle)
+            ctx->networking.close(ctx, handle, ctx->networking.user_data);
+    };
+
+    std::vector<PJ_CONTEXT *> contexts;
+    size_t nStartedThreads = 1; // the calling thread
+#ifndef __MINGW32__
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nThreads; i++) {
+        PJ_CONTEXT *ctx = proj_context_clone(m_ctx);
+        if (!ctx)
+            break;
+        contexts.push_back(ctx);
+        try {
+            threads.emplace_back(downloader, ctx, i);
+        } catch (const std::exception &) {
+            break;
+        }
+        ++nStartedThreads;
+    }
+#endif
+    // Requests assigned to threads that could not be created are processed
+    // by the calling thread.
+    for (size_t i = nStartedThreads; i <= nThreads; i++) {
+        downloader(m_ctx, i % nThreads);
+    }
+#ifndef __MINGW32__
+    for (auto &thread : threads)
+        thread.join();
+#endif
+    for (auto ctx : contexts)
+        proj_context_destroy(ctx);
+
+    for (auto &req : requests) {
+        const auto &region = req.data;
+        const auto nChunks =
+            (region.size() + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
+        for (size_t i = 0; i < nChunks; i++) {
+            std::vector<unsigned char> chunk(
+                region.data() + i * DOWNLOAD_CHUNK_SIZE,
+                region.data() +
+                    std::min((i + 1) * DOWNLOAD_CHUNK_SIZE, region.size()));
+            gNetworkChunkCache.insert(m_ctx, m_url, req.firstChunkIdx + i,
+                                      std::move(chunk));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 bool NetworkFile::seek(unsigned long long offset, int whence) {
     if (whence == SEEK_SET) {
         m_pos = offset;
@@ -97,8 +97,9 @@ Thomas Knudsen, thokn@sdfe.dk, 2016-05-20
 *
 ********************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <math.h>
-#include <stack>
 #include <stddef.h>
 #include <string.h>
 #include <vector>
@@ -114,16 +115,28 @@ PROJ_HEAD(push, "Save coordinate value on pipeline stack");
 /* Projection specific elements for the PJ object */
 namespace { // anonymous namespace
 
+/* What a push or pop step does in a given direction, resolved when the
+ * pipeline is created by matching each pop with the push whose value it
+ * retrieves. Values are kept in slots local to each pipeline run. */
+struct SlotOps {
+    bool save = false; /* save to the slots (push) or restore from them (pop) */
+    int slot[4] = {-1, -1, -1, -1}; /* per component, -1 if untouched */
+};
+
 struct Step {
     PJ *pj = nullptr;
     bool omit_fwd = false;
     bool omit_inv = false;
+    bool pushpop = false; /* push or pop step, run by the pipeline itself */
+    SlotOps fwd_slots{};
+    SlotOps inv_slots{};
 
     Step(PJ *pjIn, bool omitFwdIn, bool omitInvIn)
         : pj(pjIn), omit_fwd(omitFwdIn), omit_inv(omitInvIn) {}
     Step(Step &&other)
         : pj(std::move(other.pj)), omit_fwd(other.omit_fwd),
-          omit_inv(other.omit_inv) {
+          omit_inv(other.omit_inv), pushpop(other.pushpop),
+          fwd_slots(other.fwd_slots), inv_slots(other.inv_slots) {
         other.pj = nullptr;
     }
     Step(const Step &) = delete;
@@ -132,13 +145,50 @@ struct Step {
     ~Step() { proj_destroy(pj); }
 };
 
+/* Run of consecutive steps whose composition is a PJ_AXIS_MAP giving
+ * exactly the same results, executed as a single one */
+struct FusedSteps {
+    size_t first = 0; /* index of the first step of the run */
+    size_t count = 0; /* number of steps of the run */
+    PJ_AXIS_MAP fwd{};
+    PJ_AXIS_MAP inv{};
+};
+
 struct Pipeline {
     char **argv = nullptr;
     char **current_argv = nullptr;
     std::vector<Step> steps{};
-    std::stack<double> stack[4];
+    std::vector<FusedSteps> fused{}; /* sorted by index of first step */
+    size_t slot_count = 0; /* number of slots used by push and pop steps */
+};
+
+/* Storage for the slots of push and pop steps during one pipeline run,
+ * on the stack unless the pipeline needs an unusual number of them */
+template <size_t N> class SlotBuffer {
+    double inline_values[N];
+    std::vector<double> heap_values{};
+    double *values = inline_values;
+
+  public:
+    explicit SlotBuffer(size_t count) {
+        if (count > N) {
+            heap_values.resize(count);
+            values = heap_values.data();
+        }
+    }
+    SlotBuffer(const SlotBuffer &) = delete;
+    SlotBuffer &operator=(const SlotBuffer &) = delete;
+
+    double *data() { return values; }
 };
 
+/* Slots for a single coordinate */
+constexpr size_t INLINE_SLOTS = 16;
+
+/* Values held in slots for a block of coordinates. Blocks are split so that
+ * their slots fit in that many values */
+constexpr size_t INLINE_SLOT_VALUES = 1024;
+
 struct PushPop {
     bool v1;
     bool v2;
@@ -149,6 +199,8 @@ struct PushPop {
 
 static void pipeline_forward_4d(PJ_COORD &point, PJ *P);
 static void pipeline_reverse_4d(PJ_COORD &point, PJ *P);
+static void pipeline_forward_4d_batch(PJ_COORD *points, size_t n, PJ *P);
+static void pipeline_reverse_4d_batch(PJ_COORD *points, size_t n, PJ *P);
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P);
 static PJ_LPZ pipeline_reverse_3d(PJ_XYZ xyz, PJ *P);
 static PJ_XY pipeline_forward(PJ_LP lp, PJ *P);
@@ -160,10 +212,106 @@ static void pipeline_reassign_context(PJ *P, PJ_CONTEXT *ctx) {
         proj_assign_context(step.pj, ctx);
 }
 
+static void apply_slot_ops(PJ_COORD &point, const SlotOps &ops,
+                           double *slots) {
+    for (int j = 0; j < 4; j++) {
+        const int slot = ops.slot[j];
+        if (slot < 0)
+            continue;
+        if (ops.save)
+            slots[slot] = point.v[j];
+        else
+            point.v[j] = slots[slot];
+    }
+}
+
+/* Block variant: each slot holds one value per coordinate of the block.
+ * Coordinates that failed in an earlier step are left untouched. */
+static void apply_slot_ops_batch(PJ_COORD *points, size_t n,
+                                 const SlotOps &ops, double *slots) {
+    for (int j = 0; j < 4; j++) {
+        const int slot = ops.slot[j];
+        if (slot < 0)
+            continue;
+        double *values = slots + static_cast<size_t>(slot) * n;
+        if (ops.save) {
+            for (size_t i = 0; i < n; i++)
+                values[i] = points[i].v[j];
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                if (points[i].v[0] != HUGE_VAL)
+                    points[i].v[j] = values[i];
+            }
+        }
+    }
+}
+
+/* Apply the map of fused steps. Returns false, leaving the coordinate
+ * untouched, if one of its spatial components is not finite on input or on
+ * output, in which case the steps must be run one by one so that failures
+ * are handled as usual. */
+static bool apply_axis_map(PJ_COORD &point, const PJ_AXIS_MAP &map) {
+    PJ_COORD out;
+    for (int i = 0; i < 3; i++) {
+        const double v = point.v[map.axis[i]];
+        out.v[i] = map.divide[i] ? v / map.factor[i] : v * map.factor[i];
+        if (!std::isfinite(out.v[i]))
+            return false;
+    }
+    out.v[3] = point.v[3] * map.tsign;
+    point = out;
+    return true;
+}
+
+/* Run the given steps one by one, as done without fusion. Returns false if
+ * the coordinate fails. */
+static bool run_steps_fwd(PJ_COORD &point, const Pipeline *pipeline,
+                          const FusedSteps &fused) {
+    for (size_t i = fused.first; i < fused.first + fused.count; ++i) {
+        PJ *Q = pipeline->steps[i].pj;
+        if (!Q->inverted)
+            pj_fwd4d(point, Q);
+        else
+            pj_inv4d(point, Q);
+        if (point.xyzt.x == HUGE_VAL)
+            return false;
+    }
+    return true;
+}
+
+static bool run_steps_inv(PJ_COORD &point, const Pipeline *pipeline,
+                          const FusedSteps &fused) {
+    for (size_t i = fused.first + fused.count; i > fused.first;) {
+        --i;
+        PJ *Q = pipeline->steps[i].pj;
+        if (Q->inverted)
+            pj_fwd4d(point, Q);
+        else
+            pj_inv4d(point, Q);
+        if (point.xyzt.x == HUGE_VAL)
+            return false;
+    }
+    return true;
+}
+
 static void pipeline_forward_4d(PJ_COORD &point, PJ *P) {
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
-    for (auto &step : pipeline->steps) {
-        if (!step.omit_fwd) {
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
+    auto iterFused = pipeline->fused.cbegin();
+    for (size_t i = 0; i < pipeline->steps.size(); ++i) {
+        if (iterFused != pipeline->fused.cend() && iterFused->first == i) {
+            const auto &fused = *iterFused;
+            i += fused.count - 1;
+            ++iterFused;
+            if (!apply_axis_map(point, fused.fwd) &&
+                !run_steps_fwd(point, pipeline, fused))
+                break;
+            continue;
+        }
+        const auto &step = pipeline->steps[i];
+        if (step.pushpop) {
+            apply_slot_ops(point, step.fwd_slots, slots.data());
+        } else if (!step.omit_fwd) {
             if (!step.pj->inverted)
                 pj_fwd4d(point, step.pj);
             else
@@ -177,10 +325,24 @@ static void pipeline_forward_4d(PJ_COORD &point, PJ *P) {
 
 static void pipeline_reverse_4d(PJ_COORD &point, PJ *P) {
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
-    for (auto iterStep = pipeline->steps.rbegin();
-         iterStep != pipeline->steps.rend(); ++iterStep) {
-        const auto &step = *iterStep;
-        if (!step.omit_inv) {
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
+    auto iterFused = pipeline->fused.crbegin();
+    for (size_t i = pipeline->steps.size(); i > 0;) {
+        --i;
+        if (iterFused != pipeline->fused.crend() &&
+            iterFused->first + iterFused->count - 1 == i) {
+            const auto &fused = *iterFused;
+            i -= fused.count - 1;
+            ++iterFused;
+            if (!apply_axis_map(point, fused.inv) &&
+                !run_steps_inv(point, pipeline, fused))
+                break;
+            continue;
+        }
+        const auto &step = pipeline->steps[i];
+        if (step.pushpop) {
+            apply_slot_ops(point, step.inv_slots, slots.data());
+        } else if (!step.omit_inv) {
             if (step.pj->inverted)
                 pj_fwd4d(point, step.pj);
             else
@@ -192,12 +354,109 @@ static void pipeline_reverse_4d(PJ_COORD &point, PJ *P) {
     }
 }
 
+static void apply_axis_map_batch(PJ_COORD *points, size_t n,
+                                 const Pipeline *pipeline,
+                                 const FusedSteps &fused, PJ_DIRECTION dir) {
+    const auto &map = dir == PJ_FWD ? fused.fwd : fused.inv;
+    for (size_t j = 0; j < n; j++) {
+        if (points[j].v[0] == HUGE_VAL || apply_axis_map(points[j], map))
+            continue;
+        if (dir == PJ_FWD)
+            run_steps_fwd(points[j], pipeline, fused);
+        else
+            run_steps_inv(points[j], pipeline, fused);
+    }
+}
+
+/* Number of coordinates run through the pipeline at once so that the slots
+ * of push and pop steps fit in INLINE_SLOT_VALUES values */
+static size_t batch_block_size(const Pipeline *pipeline, size_t n) {
+    if (pipeline->slot_count == 0)
+        return n;
+    return std::max<size_t>(
+        1, std::min(n, INLINE_SLOT_VALUES / pipeline->slot_count));
+}
+
+/* Run each step over the whole block before moving on to the next one.
+ * Coordinates that fail in a step are set to HUGE_VAL and skipped by the
+ * following steps, which mimics the early exit of pipeline_forward_4d() */
+static void pipeline_forward_4d_block(PJ_COORD *points, size_t n, PJ *P,
+                                      double *slots) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    auto iterFused = pipeline->fused.cbegin();
+    for (size_t i = 0; i < pipeline->steps.size(); ++i) {
+        if (iterFused != pipeline->fused.cend() && iterFused->first == i) {
+            const auto &fused = *iterFused;
+            i += fused.count - 1;
+            ++iterFused;
+            apply_axis_map_batch(points, n, pipeline, fused, PJ_FWD);
+            continue;
+        }
+        const auto &step = pipeline->steps[i];
+        if (step.pushpop) {
+            apply_slot_ops_batch(points, n, step.fwd_slots, slots);
+        } else if (!step.omit_fwd) {
+            if (!step.pj->inverted)
+                pj_fwd4d_batch(points, n, step.pj);
+            else
+                pj_inv4d_batch(points, n, step.pj);
+        }
+    }
+}
+
+static void pipeline_forward_4d_batch(PJ_COORD *points, size_t n, PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    const size_t block = batch_block_size(pipeline, n);
+    SlotBuffer<INLINE_SLOT_VALUES> slots(pipeline->slot_count * block);
+    for (size_t i = 0; i < n; i += block)
+        pipeline_forward_4d_block(points + i, std::min(block, n - i), P,
+                                  slots.data());
+}
+
+static void pipeline_reverse_4d_block(PJ_COORD *points, size_t n, PJ *P,
+                                      double *slots) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    auto iterFused = pipeline->fused.crbegin();
+    for (size_t i = pipeline->steps.size(); i > 0;) {
+        --i;
+        if (iterFused != pipeline->fused.crend() &&
+            iterFused->first + iterFused->count - 1 == i) {
+            const auto &fused = *iterFused;
+            i -= fused.count - 1;
+            ++iterFused;
+            apply_axis_map_batch(points, n, pipeline, fused, PJ_INV);
+            continue;
+        }
+        const auto &step = pipeline->steps[i];
+        if (step.pushpop) {
+            apply_slot_ops_batch(points, n, step.inv_slots, slots);
+        } else if (!step.omit_inv) {
+            if (step.pj->inverted)
+                pj_fwd4d_batch(points, n, step.pj);
+            else
+                pj_inv4d_batch(points, n, step.pj);
+        }
+    }
+}
+
+static void pipeline_reverse_4d_batch(PJ_COORD *points, size_t n, PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    const size_t block = batch_block_size(pipeline, n);
+    SlotBuffer<INLINE_SLOT_VALUES> slots(pipeline->slot_count * block);
+    for (size_t i = 0; i < n; i += block)
+        pipeline_reverse_4d_block(points + i, std::min(block, n - i), P,
+                                  slots.data());
+}
+
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.lpz = lpz;
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
     for (auto &step : pipeline->steps) {
-        if (!step.omit_fwd) {
+        if (step.pushpop) {
+            apply_slot_ops(point, step.fwd_slots, slots.data());
+        } else if (!step.omit_fwd) {
             point = pj_approx_3D_trans(step.pj, PJ_FWD, point);
             if (point.xyzt.x == HUGE_VAL) {
                 break;
@@ -212,10 +471,13 @@ static PJ_LPZ pipeline_reverse_3d(PJ_XYZ xyz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.xyz = xyz;
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
     for (auto iterStep = pipeline->steps.rbegin();
          iterStep != pipeline->steps.rend(); ++iterStep) {
         const auto &step = *iterStep;
-        if (!step.omit_inv) {
+        if (step.pushpop) {
+            apply_slot_ops(point, step.inv_slots, slots.data());
+        } else if (!step.omit_inv) {
             point = proj_trans(step.pj, PJ_INV, point);
             if (point.xyzt.x == HUGE_VAL) {
                 break;
@@ -230,8 +492,11 @@ static PJ_XY pipeline_forward(PJ_LP lp, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.lp = lp;
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
     for (auto &step : pipeline->steps) {
-        if (!step.omit_fwd) {
+        if (step.pushpop) {
+            apply_slot_ops(point, step.fwd_slots, slots.data());
+        } else if (!step.omit_fwd) {
             point = pj_approx_2D_trans(step.pj, PJ_FWD, point);
             if (point.xyzt.x == HUGE_VAL) {
                 break;
@@ -246,10 +511,13 @@ static PJ_LP pipeline_reverse(PJ_XY xy, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.xy = xy;
     auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    SlotBuffer<INLINE_SLOTS> slots(pipeline->slot_count);
     for (auto iterStep = pipeline->steps.rbegin();
          iterStep != pipeline->steps.rend(); ++iterStep) {
         const auto &step = *iterStep;
-        if (!step.omit_inv) {
+        if (step.pushpop) {
+            apply_slot_ops(point, step.inv_slots, slots.data());
+        } else if (!step.omit_inv) {
             point = pj_approx_2D_trans(step.pj, PJ_INV, point);
             if (point.xyzt.x == HUGE_VAL) {
                 break;
@@ -358,6 +626,156 @@ static void set_ellipsoid(PJ *P) {
     proj_errno_restore(P, err);
 }
 
+/* Whether the unit handling done by pj_fwd4d()/pj_inv4d() on the given side
+ * of a step leaves the coordinates unchanged. */
+static bool units_handling_is_identity(const PJ *Q, enum pj_io_units units) {
+    switch (units) {
+    case PJ_IO_UNITS_WHATEVER:
+    case PJ_IO_UNITS_DEGREES:
+        return true;
+    case PJ_IO_UNITS_CARTESIAN:
+        return !Q->is_geocent && Q->to_meter == 1 && Q->fr_meter == 1;
+    case PJ_IO_UNITS_PROJECTED:
+        return Q->to_meter == 1 && Q->fr_meter == 1 && Q->vto_meter == 1 &&
+               Q->vfr_meter == 1 && Q->x0 == 0 && Q->y0 == 0 && Q->z0 == 0;
+    case PJ_IO_UNITS_RADIANS:
+        return Q->vto_meter == 1 && Q->vfr_meter == 1 && Q->z0 == 0 &&
+               !Q->is_long_wrap_set;
+    case PJ_IO_UNITS_CLASSIC:
+        break;
+    }
+    return false;
+}
+
+/* Set map to next o map, if it gives exactly the same results as applying
+ * map then next, that is if at least one of the two factors applied to each
+ * component is 1 or -1, as then the sign can be moved to the other one
+ * without any rounding. */
+static bool chain_axis_map(PJ_AXIS_MAP &map, const PJ_AXIS_MAP &next) {
+    PJ_AXIS_MAP res;
+    for (int i = 0; i < 3; i++) {
+        const int k = next.axis[i];
+        res.axis[i] = map.axis[k];
+        if (std::fabs(next.factor[i]) == 1) {
+            res.factor[i] = map.factor[k] * next.factor[i];
+            res.divide[i] = map.divide[k];
+        } else if (std::fabs(map.factor[k]) == 1) {
+            res.factor[i] = next.factor[i] * map.factor[k];
+            res.divide[i] = next.divide[i];
+        } else {
+            return false;
+        }
+    }
+    res.tsign = next.tsign * map.tsign;
+    map = res;
+    return true;
+}
+
+/* Get the map applied by a step in the given direction of the pipeline, if
+ * it has one and the prepare/finalize stages of pj_fwd4d() and pj_inv4d() do
+ * not alter finite coordinates for it. */
+static bool get_step_axis_map(const Step &step, PJ_DIRECTION direction,
+                              PJ_AXIS_MAP &map) {
+    const PJ *Q = step.pj;
+    if (step.pushpop || step.omit_fwd || step.omit_inv ||
+        Q->get_axis_map == nullptr || Q->axisswap || Q->helmert)
+        return false;
+
+    /* Only radians are subject to checks and adjustments on input */
+    if (!(Q->skip_fwd_prepare && Q->skip_inv_finalize) &&
+        Q->left == PJ_IO_UNITS_RADIANS)
+        return false;
+    if (!(Q->skip_fwd_finalize && Q->skip_inv_prepare) &&
+        !units_handling_is_identity(Q, Q->right))
+        return false;
+
+    if (Q->inverted)
+        direction = direction == PJ_FWD ? PJ_INV : PJ_FWD;
+    return Q->get_axis_map(Q, direction, map);
+}
+
+/* Replace runs of consecutive steps that only permute and scale the
+ * components of the coordinates by their composition, so that they are
+ * executed as a single step. A run ends before a step whose composition
+ * with the previous ones would not give exactly the same results as running
+ * them one by one. The maps of each direction are composed from the maps of
+ * the steps for that direction, which reproduce the arithmetic of the
+ * steps, e.g. a division by a factor rather than a multiplication by its
+ * inverse. */
+static void fuse_axis_map_steps(Pipeline *pipeline) {
+    const size_t nsteps = pipeline->steps.size();
+    size_t i = 0;
+    while (i < nsteps) {
+        FusedSteps fused;
+        fused.first = i;
+        PJ_AXIS_MAP fwdMap;
+        PJ_AXIS_MAP invMap;
+        while (i < nsteps &&
+               get_step_axis_map(pipeline->steps[i], PJ_FWD, fwdMap) &&
+               get_step_axis_map(pipeline->steps[i], PJ_INV, invMap)) {
+            if (fused.count == 0) {
+                fused.fwd = fwdMap;
+                fused.inv = invMap;
+            } else {
+                /* The reverse direction runs this step first */
+                PJ_AXIS_MAP fwd = fused.fwd;
+                if (!chain_axis_map(fwd, fwdMap) ||
+                    !chain_axis_map(invMap, fused.inv))
+                    break;
+                fused.fwd = fwd;
+                fused.inv = invMap;
+            }
+            ++fused.count;
+            ++i;
+        }
+        if (fused.count >= 2)
+            pipeline->fused.push_back(fused);
+        else if (fused.count == 0)
+            ++i;
+    }
+}
+
+static bool is_pushpop_step(const PJ *Q) {
+    return Q->short_name != nullptr && (strcmp(Q->short_name, "push") == 0 ||
+                                        strcmp(Q->short_name, "pop") == 0);
+}
+
+/* Match each pop with the latest push of the same component that precedes
+ * it in the order steps are run in the given direction. A value pushed at a
+ * given stack depth is kept in a slot, slot_of[component][depth]. Pops
+ * without a matching push leave the component as it is. */
+static void resolve_pushpop_slots(Pipeline *pipeline, PJ_DIRECTION direction,
+                                  std::vector<int> (&slot_of)[4]) {
+    size_t depth[4] = {0, 0, 0, 0};
+    const size_t nsteps = pipeline->steps.size();
+    for (size_t k = 0; k < nsteps; k++) {
+        auto &step = pipeline->steps[direction == PJ_FWD ? k : nsteps - 1 - k];
+        if (!step.pushpop ||
+            (direction == PJ_FWD ? step.omit_fwd : step.omit_inv))
+            continue;
+
+        auto &ops = direction == PJ_FWD ? step.fwd_slots : step.inv_slots;
+        const auto pushpop = static_cast<const PushPop *>(step.pj->opaque);
+        const bool flags[4] = {pushpop->v1, pushpop->v2, pushpop->v3,
+                               pushpop->v4};
+        /* push saves values when run forward, pop when run inverse */
+        const bool is_push = strcmp(step.pj->short_name, "push") == 0;
+        ops.save = is_push == ((direction == PJ_FWD) == !step.pj->inverted);
+        for (int j = 0; j < 4; j++) {
+            if (!flags[j])
+                continue;
+            if (ops.save) {
+                if (depth[j] == slot_of[j].size())
+                    slot_of[j].push_back(
+                        static_cast<int>(pipeline->slot_count++));
+                ops.slot[j] = slot_of[j][depth[j]++];
+            } else if (depth[j] > 0) {
+                ops.slot[j] = slot_of[j][--depth[j]];
+            }
+        }
+    }
+}
+
 PJ *OPERATION(pipeline, 0) {
     int i, nsteps = 0, argc;
     int i_pipeline = -1, i_first_step = -1, i_current_step;
@@ -381,6 +799,8 @@ PJ *OPERATION(pipeline, 0) {
 
     P->fwd4d = pipeline_forward_4d;
     P->inv4d = pipeline_reverse_4d;
+    P->fwd4d_batch = pipeline_forward_4d_batch;
+    P->inv4d_batch = pipeline_reverse_4d_batch;
     P->fwd3d = pipeline_forward_3d;
     P->inv3d = pipeline_reverse_3d;
     P->fwd = pipeline_forward;
@@ -510,6 +930,8 @@ PJ *OPERATION(pipeline, 0) {
             return destructor(P, err_to_report); /* ERROR: bad pipeline def */
         }
         next_step->parent = P;
+        if (!next_step->shareableBetweenThreads)
+            P->shareableBetweenThreads = false;
 
         proj_errno_restore(P, err);
 
@@ -525,6 +947,7 @@ PJ *OPERATION(pipeline, 0) {
         bool omit_fwd = pj_param(P->ctx, next_step->params, "bomit_fwd").i != 0;
         bool omit_inv = pj_param(P->ctx, next_step->params, "bomit_inv").i != 0;
         pipeline->steps.emplace_back(next_step, omit_fwd, omit_inv);
+        pipeline->steps.back().pushpop = is_pushpop_step(next_step);
 
         proj_log_trace(P, "Pipeline at [%p]:    step at [%p] (%s) done", P,
                        next_step, current_argv[0]);
@@ -564,6 +987,7 @@ PJ *OPERATION(pipeline, 0) {
             P->inv = nullptr;
             P->inv3d = nullptr;
             P->inv4d = nullptr;
+            P->inv4d_batch = nullptr;
             break;
         }
     }
@@ -635,55 +1059,19 @@ PJ *OPERATION(pipeline, 0) {
     /* Now, correspondingly determine forward output (= reverse input) data type
      */
     P->right = pj_right(pipeline->steps.back().pj);
-    return P;
-}
-
-static void push(PJ_COORD &point, PJ *P) {
-    if (P->parent == nullptr)
-        return;
 
-    struct Pipeline *pipeline =
-        static_cast<struct Pipeline *>(P->parent->opaque);
-    struct PushPop *pushpop = static_cast<struct PushPop *>(P->opaque);
+    std::vector<int> slot_of[4];
+    resolve_pushpop_slots(pipeline, PJ_FWD, slot_of);
+    resolve_pushpop_slots(pipeline, PJ_INV, slot_of);
 
-    if (pushpop->v1)
-        pipeline->stack[0].push(point.v[0]);
-    if (pushpop->v2)
-        pipeline->stack[1].push(point.v[1]);
-    if (pushpop->v3)
-        pipeline->stack[2].push(point.v[2]);
-    if (pushpop->v4)
-        pipeline->stack[3].push(point.v[3]);
+    fuse_axis_map_steps(pipeline);
+    return P;
 }
 
-static void pop(PJ_COORD &point, PJ *P) {
-    if (P->parent == nullptr)
-        return;
-
-    struct Pipeline *pipeline =
-        static_cast<struct Pipeline *>(P->parent->opaque);
-    struct PushPop *pushpop = static_cast<struct PushPop *>(P->opaque);
-
-    if (pushpop->v1 && !pipeline->stack[0].empty()) {
-        point.v[0] = pipeline->stack[0].top();
-        pipeline->stack[0].pop();
-    }
-
-    if (pushpop->v2 && !pipeline->stack[1].empty()) {
-        point.v[1] = pipeline->stack[1].top();
-        pipeline->stack[1].pop();
-    }
-
-    if (pushpop->v3 && !pipeline->stack[2].empty()) {
-        point.v[2] = pipeline->stack[2].top();
-        pipeline->stack[2].pop();
-    }
-
-    if (pushpop->v4 && !pipeline->stack[3].empty()) {
-        point.v[3] = pipeline->stack[3].top();
-        pipeline->stack[3].pop();
-    }
-}
+/* push and pop steps are run by their pipeline, through the slots resolved
+ * by resolve_pushpop_slots(). On their own, they leave coordinates as they
+ * are. */
+static void pushpop_noop(PJ_COORD &, PJ *) {}
 
 static PJ *setup_pushpop(PJ *P) {
     auto pushpop =
@@ -711,15 +1099,15 @@ static PJ *setup_pushpop(PJ *P) {
 }
 
 PJ *OPERATION(push, 0) {
-    P->fwd4d = push;
-    P->inv4d = pop;
+    P->fwd4d = pushpop_noop;
+    P->inv4d = pushpop_noop;
 
     return setup_pushpop(P);
 }
 
 PJ *OPERATION(pop, 0) {
-    P->inv4d = push;
-    P->fwd4d = pop;
+    P->fwd4d = pushpop_noop;
+    P->inv4d = pushpop_noop;
 
     return setup_pushpop(P);
 }
@@ -237,6 +237,22 @@ typedef struct PJ_GRID_INFO PJ_GRID_INFO;
 struct PJ_INIT_INFO;
 typedef struct PJ_INIT_INFO PJ_INIT_INFO;
 
+struct PJ_GRID_SHARED_CACHE_STATS;
+typedef struct PJ_GRID_SHARED_CACHE_STATS PJ_GRID_SHARED_CACHE_STATS;
+
+struct PJ_DB_SHARED_CACHE_STATS;
+typedef struct PJ_DB_SHARED_CACHE_STATS PJ_DB_SHARED_CACHE_STATS;
+
+/* Opaque types for transformations shared between threads */
+struct PJ_COMPILED_TRANSFORMATION;
+typedef struct PJ_COMPILED_TRANSFORMATION PJ_COMPILED_TRANSFORMATION;
+
+struct PJ_TRANS_HANDLE;
+typedef struct PJ_TRANS_HANDLE PJ_TRANS_HANDLE;
+
+struct PJ_GRID_READ_AHEAD_STATS;
+typedef struct PJ_GRID_READ_AHEAD_STATS PJ_GRID_READ_AHEAD_STATS;
+
 /* Data types for list of operations, ellipsoids, datums and units used in
  * PROJ.4 */
 struct PJ_LIST {
@@ -370,6 +386,29 @@ struct PJ_INIT_INFO {
     char lastupdate[16]; /* Date of last update in YYYY-MM-DD format */
 };
 
+struct PJ_GRID_SHARED_CACHE_STATS {
+    size_t max_size;                   /* Maximum size, in bytes         */
+    size_t size;                       /* Current size, in bytes         */
+    size_t entry_count;                /* Number of cached lines/blocks  */
+    unsigned long long hit_count;      /* Number of successful lookups   */
+    unsigned long long miss_count;     /* Number of unsuccessful lookups */
+    unsigned long long eviction_count; /* Number of evicted entries      */
+};
+
+struct PJ_DB_SHARED_CACHE_STATS {
+    size_t max_size;                   /* Maximum number of entries      */
+    size_t entry_count;                /* Number of cached objects       */
+    unsigned long long hit_count;      /* Number of successful lookups   */
+    unsigned long long miss_count;     /* Number of unsuccessful lookups */
+    unsigned long long eviction_count; /* Number of evicted entries      */
+};
+
+struct PJ_GRID_READ_AHEAD_STATS {
+    unsigned long long scheduled_count; /* Blocks queued for read-ahead   */
+    unsigned long long hit_count;  /* Blocks needed and decoded ahead     */
+    unsigned long long miss_count; /* Blocks needed and decoded on demand */
+};
+
 typedef enum PJ_LOG_LEVEL {
     PJ_LOG_NONE = 0,
     PJ_LOG_ERROR = 1,
@@ -578,6 +617,38 @@ void PROJ_DLL proj_grid_cache_set_ttl(PJ_CONTEXT *ctx, int ttl_seconds);
 
 void PROJ_DLL proj_grid_cache_clear(PJ_CONTEXT *ctx);
 
+void PROJ_DLL proj_grid_shared_cache_set_max_size(size_t max_size_bytes);
+
+void PROJ_DLL proj_grid_shared_cache_clear(void);
+
+void PROJ_DLL
+proj_grid_shared_cache_get_stats(PJ_GRID_SHARED_CACHE_STATS *stats);
+
+void PROJ_DLL proj_context_set_enable_grid_memory_mapping(PJ_CONTEXT *ctx,
+                                                         int enabled);
+
+void PROJ_DLL proj_context_set_enable_precomputed_inverse_grids(PJ_CONTEXT *ctx,
+                                                               int enabled);
+
+void PROJ_DLL proj_context_set_grid_read_ahead_threads(PJ_CONTEXT *ctx,
+                                                       int thread_count);
+
+void PROJ_DLL
+proj_context_get_grid_read_ahead_stats(PJ_CONTEXT *ctx,
+                                       PJ_GRID_READ_AHEAD_STATS *stats);
+
+void PROJ_DLL proj_db_shared_cache_set_max_size(size_t max_entries);
+
+void PROJ_DLL proj_db_shared_cache_clear(void);
+
+void PROJ_DLL proj_db_shared_cache_get_stats(PJ_DB_SHARED_CACHE_STATS *stats);
+
+int PROJ_DLL proj_grid_prefetch(PJ_CONTEXT *ctx, PJ *P,
+                                double west_lon_degree,
+                                double south_lat_degree,
+                                double east_lon_degree,
+                                double north_lat_degree);
+
 int PROJ_DLL proj_is_download_needed(PJ_CONTEXT *ctx,
                                      const char *url_or_filename,
                                      int ignore_ttl_setting);
@@ -599,6 +670,11 @@ PJ PROJ_DLL *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx,
                                             const PJ *target_crs, PJ_AREA *area,
                                             const char *const *options);
 /*! @endcond */
+void PROJ_DLL proj_crs_to_crs_cache_set_max_size(PJ_CONTEXT *ctx,
+                                                 int max_entries);
+void PROJ_DLL proj_crs_to_crs_cache_clear(PJ_CONTEXT *ctx);
+void PROJ_DLL proj_create_cache_set_max_size(PJ_CONTEXT *ctx, int max_entries);
+void PROJ_DLL proj_create_cache_clear(PJ_CONTEXT *ctx);
 PJ PROJ_DLL *proj_normalize_for_visualization(PJ_CONTEXT *ctx, const PJ *obj);
 /*! @cond Doxygen_Suppress */
 void PROJ_DLL proj_assign_context(PJ *pj, PJ_CONTEXT *ctx);
@@ -634,6 +710,26 @@ size_t PROJ_DLL proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x,
                                    size_t sx, size_t nx, double *y, size_t sy,
                                    size_t ny, double *z, size_t sz, size_t nz,
                                    double *t, size_t st, size_t nt);
+size_t PROJ_DLL proj_trans_generic_mt(PJ *P, PJ_DIRECTION direction,
+                                      double *x, size_t sx, size_t nx,
+                                      double *y, size_t sy, size_t ny,
+                                      double *z, size_t sz, size_t nz,
+                                      double *t, size_t st, size_t nt,
+                                      int thread_count);
+
+PJ_COMPILED_TRANSFORMATION PROJ_DLL *proj_trans_compile(PJ *P);
+void PROJ_DLL
+proj_trans_compiled_destroy(PJ_COMPILED_TRANSFORMATION *compiled);
+PJ_TRANS_HANDLE PROJ_DLL *
+proj_trans_handle_create(PJ_COMPILED_TRANSFORMATION *compiled);
+void PROJ_DLL proj_trans_handle_destroy(PJ_TRANS_HANDLE *handle);
+PJ_COORD PROJ_DLL proj_trans_with_handle(PJ_TRANS_HANDLE *handle,
+                                         PJ_DIRECTION direction,
+                                         PJ_COORD coord);
+int PROJ_DLL proj_trans_array_with_handle(PJ_TRANS_HANDLE *handle,
+                                          PJ_DIRECTION direction, size_t n,
+                                          PJ_COORD *coord);
+int PROJ_DLL proj_trans_handle_errno(const PJ_TRANS_HANDLE *handle);
 /*! @endcond */
 int PROJ_DLL proj_trans_bounds(PJ_CONTEXT *context, PJ *P,
                                PJ_DIRECTION direction, double xmin, double ymin,
@@ -650,6 +746,13 @@ int PROJ_DLL proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P,
                                   double *out_xmax, double *out_ymax,
                                   double *out_zmax, const int densify_pts);
 
+int PROJ_DLL proj_trans_bounds_adaptive(PJ_CONTEXT *context, PJ *P,
+                                        PJ_DIRECTION direction, double xmin,
+                                        double ymin, double xmax, double ymax,
+                                        double *out_xmin, double *out_ymin,
+                                        double *out_xmax, double *out_ymax,
+                                        double tolerance);
+
 /*! @cond Doxygen_Suppress */
 
 /* Initializers */
@@ -1130,6 +1233,27 @@ typedef struct {
 
 } PROJ_CELESTIAL_BODY_INFO;
 
+/** \brief Structure giving execution statistics of a SQL query run against
+ * the database.
+ *
+ * This structure may grow over time, and should not be directly allocated by
+ * client code.
+ * @since 9.6
+ */
+typedef struct {
+    /** SQL text of the query, with question marks for its parameters. */
+    char *sql;
+
+    /** Number of executions of the query. */
+    unsigned long long count;
+
+    /** Total number of rows returned by the executions of the query. */
+    unsigned long long row_count;
+
+    /** Total execution time of the query, in milliseconds. */
+    double total_time_ms;
+} PROJ_DB_QUERY_STATS;
+
 /**@}*/
 
 /**
@@ -1303,6 +1427,14 @@ PROJ_UNIT_INFO PROJ_DLL **proj_get_units_from_database(PJ_CONTEXT *ctx,
 
 void PROJ_DLL proj_unit_list_destroy(PROJ_UNIT_INFO **list);
 
+void PROJ_DLL proj_context_set_db_query_profiling(PJ_CONTEXT *ctx,
+                                                  int enable);
+
+PROJ_DB_QUERY_STATS PROJ_DLL **
+proj_context_get_db_query_stats(PJ_CONTEXT *ctx, int *out_result_count);
+
+void PROJ_DLL proj_db_query_stats_list_destroy(PROJ_DB_QUERY_STATS **list);
+
 /* ------------------------------------------------------------------------- */
 /*! @cond Doxygen_Suppress */
 typedef struct PJ_INSERT_SESSION PJ_INSERT_SESSION;
@@ -1379,6 +1511,10 @@ void PROJ_DLL proj_operation_factory_context_set_discard_superseded(
 void PROJ_DLL proj_operation_factory_context_set_allow_ballpark_transformations(
     PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx, int allow);
 
+void PROJ_DLL proj_operation_factory_context_set_thread_count(
+    PJ_CONTEXT *ctx, PJ_OPERATION_FACTORY_CONTEXT *factory_ctx,
+    int thread_count);
+
 /* ------------------------------------------------------------------------- */
 
 PJ_OBJ_LIST PROJ_DLL *
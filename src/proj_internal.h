@@ -77,7 +77,9 @@
 #include "proj/coordinateoperation.hpp"
 
 #include <cmath>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "proj.h"
@@ -208,6 +210,16 @@ void proj_context_errno_set(PJ_CONTEXT *ctx, int err);
 void PROJ_DLL proj_context_set(PJ *P, PJ_CONTEXT *ctx);
 void proj_context_inherit(PJ *parent, PJ *child);
 
+struct projCrsToCrsCache;
+void pj_clear_crs_to_crs_cache(PJ_CONTEXT *ctx);
+void pj_delete_crs_to_crs_cache(struct projCrsToCrsCache *cache);
+struct projCreateCache;
+void pj_clear_create_cache(PJ_CONTEXT *ctx);
+void pj_delete_create_cache(struct projCreateCache *cache);
+
+struct projGridReadAheadPool;
+void pj_delete_grid_read_ahead_pool(struct projGridReadAheadPool *pool);
+
 struct projCppContext;
 /* not sure why we need to export it, but mingw needs it */
 void PROJ_DLL
@@ -215,6 +227,8 @@ proj_context_delete_cpp_context(struct projCppContext *cppContext);
 
 bool pj_fwd4d(PJ_COORD &coo, PJ *P);
 bool pj_inv4d(PJ_COORD &coo, PJ *P);
+void pj_fwd4d_batch(PJ_COORD *coo, size_t n, PJ *P);
+void pj_inv4d_batch(PJ_COORD *coo, size_t n, PJ *P);
 
 PJ_COORD PROJ_DLL pj_approx_2D_trans(PJ *P, PJ_DIRECTION direction,
                                      PJ_COORD coo);
@@ -303,10 +317,38 @@ PJ_OPERATOR:
     A function taking a reference to a PJ_COORD and a pointer-to-PJ as args,
 applying the PJ to the PJ_COORD, and modifying in-place the passed PJ_COORD.
 
+PJ_BATCH_OPERATOR:
+
+    A function taking a pointer to an array of PJ_COORD, its length and a
+pointer-to-PJ as args, applying the PJ to each PJ_COORD in-place. Coordinates
+whose x component is HUGE_VAL on input must be left untouched, and
+coordinates that fail to transform must be set to proj_coord_error().
+
+PJ_AXIS_MAP_GETTER:
+
+    A function taking a pointer-to-PJ, a direction and a reference to a
+PJ_AXIS_MAP as args, filling the PJ_AXIS_MAP with the method of the PJ for
+that direction, and returning false if it cannot be expressed as such for this
+PJ instance. The PJ_AXIS_MAP must give exactly the same results as the method.
+
 *****************************************************************************/
 typedef PJ *(*PJ_CONSTRUCTOR)(PJ *);
 typedef PJ *(*PJ_DESTRUCTOR)(PJ *, int);
 typedef void (*PJ_OPERATOR)(PJ_COORD &, PJ *);
+typedef void (*PJ_BATCH_OPERATOR)(PJ_COORD *, size_t, PJ *);
+
+/* Map of a 4D coordinate where each spatial component is a spatial component
+ * of the input multiplied, or divided, by a factor, and the time component
+ * is kept or negated:
+ *     v'[i] = v[axis[i]] * factor[i]     (or / factor[i] if divide[i])
+ *     t' = tsign * t */
+struct PJ_AXIS_MAP {
+    int axis[3];
+    double factor[3];
+    bool divide[3];
+    double tsign;
+};
+typedef bool (*PJ_AXIS_MAP_GETTER)(const PJ *, PJ_DIRECTION, PJ_AXIS_MAP &);
 /****************************************************************************/
 
 /* datum_type values */
@@ -446,6 +488,32 @@ struct PJCoordOperation {
     mutable int isInstantiableCached = INSTANTIABLE_STATUS_UNKNOWN;
 };
 
+/* Spatial index over the source and target extents of a list of
+ * PJCoordOperation, to speed up pj_get_suggested_operation(). Defined in
+ * trans.cpp */
+struct PJCoordOperationIndex;
+
+/* Last lookup done by pj_get_suggested_operation() with a
+ * PJCoordOperationIndex. Owned by each PJ, as the index is shared */
+struct PJCoordOperationMemo {
+    bool valid = false;
+    PJ_DIRECTION direction = PJ_FWD;
+    // Cell of the index edges in which each query point falls
+    size_t cellKey[6] = {0, 0, 0, 0, 0, 0};
+    int nCellKey = 0;
+    std::vector<int> candidates{};
+
+    // Best operation found for those candidates, when it only depends on
+    // the cell (i.e. no exclusion and no always-candidates).
+    bool bestValid = false;
+    bool bestSkipNonInstantiable = false;
+    int best = -1;
+};
+
+/* Cache of the results of proj_trans_bounds_adaptive(). Defined in
+ * trans_bounds.cpp */
+struct PJTransBoundsCache;
+
 enum class TMercAlgo {
     AUTO, // Poder/Engsager if far from central meridian, otherwise
           // Evenden/Snyder
@@ -510,6 +578,16 @@ struct PJconsts {
     PJ_OPERATOR fwd4d = nullptr;
     PJ_OPERATOR inv4d = nullptr;
 
+    /* Optional block-wise variants of fwd4d/inv4d. When set, they must give
+     * the same results as calling fwd4d/inv4d on each coordinate. */
+    PJ_BATCH_OPERATOR fwd4d_batch = nullptr;
+    PJ_BATCH_OPERATOR inv4d_batch = nullptr;
+
+    /* Set by operations whose methods only permute and scale the
+     * components of the coordinates, so that pipelines can fuse consecutive
+     * such steps. */
+    PJ_AXIS_MAP_GETTER get_axis_map = nullptr;
+
     PJ_DESTRUCTOR destructor = nullptr;
     void (*reassign_context)(PJ *, PJ_CONTEXT *) = nullptr;
 
@@ -666,16 +744,30 @@ struct PJconsts {
     // cache pj_get_type() result to help for repeated calls to proj_factors()
     mutable PJ_TYPE type = PJ_TYPE_UNKNOWN;
 
+    // results of proj_trans_bounds_adaptive(). Cleared by
+    // proj_assign_context()
+    std::shared_ptr<PJTransBoundsCache> transBoundsCache{};
+
     /*************************************************************************************
      proj_create_crs_to_crs() alternative coordinate operations
     **************************************************************************************/
     std::vector<PJCoordOperation> alternativeCoordinateOperations{};
+    // Built together with alternativeCoordinateOperations, and immutable
+    // afterwards, so that clones can share it.
+    std::shared_ptr<PJCoordOperationIndex>
+        alternativeCoordinateOperationsIndex{};
     int iCurCoordOp = -1;
+    PJCoordOperationMemo coordOperationMemo{};
     bool errorIfBestTransformationNotAvailable = false;
     bool warnIfBestTransformationNotAvailable =
         true; /* to remove in PROJ 10? */
     bool skipNonInstantiable = true;
 
+    // Whether fwd and inv may run concurrently from several threads, the
+    // object being shared through proj_trans_compile(): false for the
+    // operations that modify their private data while transforming
+    bool shareableBetweenThreads = true;
+
     // Used internally by proj_factors()
     PJ *cached_op_for_proj_factors = nullptr;
 
@@ -813,6 +905,9 @@ struct pj_ctx {
     std::map<std::string, std::string> lookupedFiles{};
 
     bool defer_grid_opening = false; // set transiently by pj_obj_create()
+    // Set on the context of compiled transformations, whose grids must be
+    // opened when the operations are created, as they are then shared
+    bool eager_grid_opening = false;
 
     projFileApiCallbackAndData fileApi{};
     std::string custom_sqlite3_vfs_name{};
@@ -835,6 +930,29 @@ struct pj_ctx {
     int pipelineInitRecursiongCounter =
         0; // to avoid potential infinite recursion in pipeline.cpp
 
+    // Cache of the results of proj_create_crs_to_crs(). Disabled when
+    // crsToCrsCacheMaxSize is 0
+    int crsToCrsCacheMaxSize = 0;
+    struct projCrsToCrsCache *crsToCrsCache = nullptr;
+
+    // Cache of the objects parsed by proj_create(). Disabled when
+    // createCacheMaxSize is 0
+    int createCacheMaxSize = 0;
+    struct projCreateCache *createCache = nullptr;
+
+    // Whether local grid files may be memory-mapped
+    bool gridMemoryMapping = false;
+
+    // Whether inverse horizontal grid shifts use a precomputed inverse grid
+    bool precomputedInverseGrids = false;
+
+    // Number of threads decoding GeoTIFF grid blocks ahead of their use.
+    // Read-ahead is disabled when 0
+    int gridReadAheadThreads = 0;
+    // Worker threads, started the first time a block is read ahead
+    struct projGridReadAheadPool *gridReadAheadPool = nullptr;
+    PJ_GRID_READ_AHEAD_STATS gridReadAheadStats{0, 0, 0};
+
     pj_ctx() = default;
     pj_ctx(const pj_ctx &);
     ~pj_ctx();
@@ -848,6 +966,68 @@ struct pj_ctx {
     static pj_ctx createDefault();
 };
 
+/* Compiled transformation, shared between threads. Defined in trans.cpp */
+struct PJCompiledTransformationState;
+
+/* State owned by an object of a compiled transformation, such as a grid,
+ * that the object changes while transforming. Each PJ_TRANS_HANDLE has its
+ * own copy */
+struct PJTransHandleScratch {
+    virtual ~PJTransHandleScratch();
+};
+
+/* Caller-owned state of a compiled transformation, see
+ * proj_trans_handle_create(). While proj_trans_with_handle() runs, it is the
+ * current handle of the calling thread, and it holds what would otherwise be
+ * changed in the PJ objects and the context of the compiled transformation */
+struct PJ_TRANS_HANDLE {
+    std::shared_ptr<const PJCompiledTransformationState> compiled{};
+    PJ *pj = nullptr;          /* owned by compiled */
+    PJ_CONTEXT *ctx = nullptr; /* owned by compiled */
+    int last_errno = 0;
+    std::string lastFullErrorMessage{};
+    int iCurCoordOp = -1;
+    PJCoordOperationMemo coordOperationMemo{};
+    bool warnIfBestTransformationNotAvailable = true;
+    std::vector<std::pair<const void *, std::unique_ptr<PJTransHandleScratch>>>
+        scratch{};
+};
+
+/* Handle running a compiled transformation in the calling thread, if any */
+extern thread_local PJ_TRANS_HANDLE *pj_current_trans_handle;
+
+/* Current handle of the calling thread, if it runs a transformation whose
+ * objects use ctx */
+inline PJ_TRANS_HANDLE *pj_trans_handle_for(const PJ_CONTEXT *ctx) {
+    PJ_TRANS_HANDLE *handle = pj_current_trans_handle;
+    return handle && handle->ctx == ctx ? handle : nullptr;
+}
+
+/* Error state of ctx, which is kept in the current handle while it runs a
+ * compiled transformation */
+inline int &pj_ctx_last_errno(PJ_CONTEXT *ctx) {
+    PJ_TRANS_HANDLE *handle = pj_trans_handle_for(ctx);
+    return handle ? handle->last_errno : ctx->last_errno;
+}
+
+/* Scratch state of owner in the current handle, created on first use, or
+ * nullptr if no handle runs a transformation using ctx, in which case owner
+ * keeps its state itself */
+template <class T>
+T *pj_trans_handle_scratch(const PJ_CONTEXT *ctx, const void *owner) {
+    PJ_TRANS_HANDLE *handle = pj_trans_handle_for(ctx);
+    if (!handle)
+        return nullptr;
+    for (const auto &entry : handle->scratch) {
+        if (entry.first == owner)
+            return static_cast<T *>(entry.second.get());
+    }
+    std::unique_ptr<T> scratch(new T());
+    T *ret = scratch.get();
+    handle->scratch.emplace_back(owner, std::move(scratch));
+    return ret;
+}
+
 #ifndef DO_NOT_DEFINE_PROJ_HEAD
 #define PROJ_HEAD(name, desc) static const char des_##name[] = desc
 
@@ -973,7 +1153,12 @@ pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
 int pj_get_suggested_operation(PJ_CONTEXT *ctx,
                                const std::vector<PJCoordOperation> &opList,
                                const int iExcluded[2], bool skipNonInstantiable,
-                               PJ_DIRECTION direction, PJ_COORD coord);
+                               PJ_DIRECTION direction, PJ_COORD coord,
+                               const PJCoordOperationIndex *index = nullptr,
+                               PJCoordOperationMemo *memo = nullptr);
+
+std::shared_ptr<PJCoordOperationIndex>
+pj_create_coord_operation_index(const std::vector<PJCoordOperation> &opList);
 
 const PJ_UNITS *pj_list_linear_units();
 const PJ_UNITS *pj_list_angular_units();
@@ -981,8 +1166,12 @@ const PJ_UNITS *pj_list_angular_units();
 void pj_clear_hgridshift_knowngrids_cache();
 void pj_clear_vgridshift_knowngrids_cache();
 void pj_clear_gridshift_knowngrids_cache();
+void pj_clear_tinshift_cache();
+void pj_clear_defmodel_cache();
+void pj_clear_shared_grid_cache();
 
 void pj_clear_sqlite_cache();
+void pj_clear_shared_db_cache();
 
 PJ_LP pj_generic_inverse_2d(PJ_XY xy, PJ *P, PJ_LP lpInitial,
                             double deltaXYTolerance);
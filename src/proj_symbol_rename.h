@@ -52,6 +52,10 @@
 #define proj_context_get_database_path internal_proj_context_get_database_path
 #define proj_context_get_database_structure                                    \
     internal_proj_context_get_database_structure
+#define proj_context_get_db_query_stats                                        \
+    internal_proj_context_get_db_query_stats
+#define proj_context_get_grid_read_ahead_stats                                 \
+    internal_proj_context_get_grid_read_ahead_stats
 #define proj_context_get_url_endpoint internal_proj_context_get_url_endpoint
 #define proj_context_get_use_proj4_init_rules                                  \
     internal_proj_context_get_use_proj4_init_rules
@@ -63,9 +67,17 @@
     internal_proj_context_set_autoclose_database
 #define proj_context_set_ca_bundle_path internal_proj_context_set_ca_bundle_path
 #define proj_context_set_database_path internal_proj_context_set_database_path
+#define proj_context_set_db_query_profiling                                    \
+    internal_proj_context_set_db_query_profiling
+#define proj_context_set_enable_grid_memory_mapping                            \
+    internal_proj_context_set_enable_grid_memory_mapping
 #define proj_context_set_enable_network internal_proj_context_set_enable_network
+#define proj_context_set_enable_precomputed_inverse_grids                      \
+    internal_proj_context_set_enable_precomputed_inverse_grids
 #define proj_context_set_fileapi internal_proj_context_set_fileapi
 #define proj_context_set_file_finder internal_proj_context_set_file_finder
+#define proj_context_set_grid_read_ahead_threads                               \
+    internal_proj_context_set_grid_read_ahead_threads
 #define proj_context_set_network_callbacks                                     \
     internal_proj_context_set_network_callbacks
 #define proj_context_set_search_paths internal_proj_context_set_search_paths
@@ -107,6 +119,9 @@
     internal_proj_coordoperation_requires_per_coordinate_input_time
 #define proj_create internal_proj_create
 #define proj_create_argv internal_proj_create_argv
+#define proj_create_cache_clear internal_proj_create_cache_clear
+#define proj_create_cache_set_max_size                                         \
+    internal_proj_create_cache_set_max_size
 #define proj_create_cartesian_2D_cs internal_proj_create_cartesian_2D_cs
 #define proj_create_compound_crs internal_proj_create_compound_crs
 #define proj_create_conversion internal_proj_create_conversion
@@ -292,6 +307,9 @@
 #define proj_crs_info_list_destroy internal_proj_crs_info_list_destroy
 #define proj_crs_is_derived internal_proj_crs_is_derived
 #define proj_crs_promote_to_3D internal_proj_crs_promote_to_3D
+#define proj_crs_to_crs_cache_clear internal_proj_crs_to_crs_cache_clear
+#define proj_crs_to_crs_cache_set_max_size                                     \
+    internal_proj_crs_to_crs_cache_set_max_size
 #define proj_cs_get_axis_count internal_proj_cs_get_axis_count
 #define proj_cs_get_axis_info internal_proj_cs_get_axis_info
 #define proj_cs_get_type internal_proj_cs_get_type
@@ -300,6 +318,12 @@
 #define proj_datum_ensemble_get_member internal_proj_datum_ensemble_get_member
 #define proj_datum_ensemble_get_member_count                                   \
     internal_proj_datum_ensemble_get_member_count
+#define proj_db_query_stats_list_destroy                                       \
+    internal_proj_db_query_stats_list_destroy
+#define proj_db_shared_cache_clear internal_proj_db_shared_cache_clear
+#define proj_db_shared_cache_get_stats internal_proj_db_shared_cache_get_stats
+#define proj_db_shared_cache_set_max_size                                      \
+    internal_proj_db_shared_cache_set_max_size
 #define proj_degree_input internal_proj_degree_input
 #define proj_degree_output internal_proj_degree_output
 #define proj_destroy internal_proj_destroy
@@ -355,6 +379,12 @@
 #define proj_grid_get_info_from_database                                       \
     internal_proj_grid_get_info_from_database
 #define proj_grid_info internal_proj_grid_info
+#define proj_grid_prefetch internal_proj_grid_prefetch
+#define proj_grid_shared_cache_clear internal_proj_grid_shared_cache_clear
+#define proj_grid_shared_cache_get_stats                                       \
+    internal_proj_grid_shared_cache_get_stats
+#define proj_grid_shared_cache_set_max_size                                    \
+    internal_proj_grid_shared_cache_set_max_size
 #define proj_identify internal_proj_identify
 #define proj_info internal_proj_info
 #define proj_init_info internal_proj_init_info
@@ -405,6 +435,8 @@
     internal_proj_operation_factory_context_set_grid_availability_use
 #define proj_operation_factory_context_set_spatial_criterion                   \
     internal_proj_operation_factory_context_set_spatial_criterion
+#define proj_operation_factory_context_set_thread_count                        \
+    internal_proj_operation_factory_context_set_thread_count
 #define proj_operation_factory_context_set_use_proj_alternative_grid_names     \
     internal_proj_operation_factory_context_set_use_proj_alternative_grid_names
 #define proj_pj_info internal_proj_pj_info
@@ -422,10 +454,19 @@
 #define proj_torad internal_proj_torad
 #define proj_trans internal_proj_trans
 #define proj_trans_array internal_proj_trans_array
+#define proj_trans_array_with_handle internal_proj_trans_array_with_handle
 #define proj_trans_bounds internal_proj_trans_bounds
+#define proj_trans_bounds_adaptive internal_proj_trans_bounds_adaptive
+#define proj_trans_compile internal_proj_trans_compile
+#define proj_trans_compiled_destroy internal_proj_trans_compiled_destroy
 #define proj_trans_generic internal_proj_trans_generic
+#define proj_trans_generic_mt internal_proj_trans_generic_mt
 #define proj_trans_get_last_used_operation                                     \
     internal_proj_trans_get_last_used_operation
+#define proj_trans_handle_create internal_proj_trans_handle_create
+#define proj_trans_handle_destroy internal_proj_trans_handle_destroy
+#define proj_trans_handle_errno internal_proj_trans_handle_errno
+#define proj_trans_with_handle internal_proj_trans_with_handle
 #define proj_unit_list_destroy internal_proj_unit_list_destroy
 #define proj_uom_get_info_from_database internal_proj_uom_get_info_from_database
 #define proj_xy_dist internal_proj_xy_dist
@@ -75,7 +75,6 @@ struct pj_aea {
     double dd;
     double n2;
     double rho0;
-    double rho;
     double phi1;
     double phi2;
     double *en;
@@ -97,16 +96,17 @@ static PJ *pj_aea_destructor(PJ *P, int errlev) { /* Destructor */
 static PJ_XY aea_e_forward(PJ_LP lp, PJ *P) { /* Ellipsoid/spheroid, forward */
     PJ_XY xy = {0.0, 0.0};
     struct pj_aea *Q = static_cast<struct pj_aea *>(P->opaque);
-    Q->rho = Q->c - (Q->ellips ? Q->n * pj_qsfn(sin(lp.phi), P->e, P->one_es)
-                               : Q->n2 * sin(lp.phi));
-    if (Q->rho < 0.) {
+    double rho =
+        Q->c - (Q->ellips ? Q->n * pj_qsfn(sin(lp.phi), P->e, P->one_es)
+                          : Q->n2 * sin(lp.phi));
+    if (rho < 0.) {
         proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
         return xy;
     }
-    Q->rho = Q->dd * sqrt(Q->rho);
+    rho = Q->dd * sqrt(rho);
     lp.lam *= Q->n;
-    xy.x = Q->rho * sin(lp.lam);
-    xy.y = Q->rho0 - Q->rho * cos(lp.lam);
+    xy.x = rho * sin(lp.lam);
+    xy.y = Q->rho0 - rho * cos(lp.lam);
     return xy;
 }
 
@@ -114,14 +114,14 @@ static PJ_LP aea_e_inverse(PJ_XY xy, PJ *P) { /* Ellipsoid/spheroid, inverse */
     PJ_LP lp = {0.0, 0.0};
     struct pj_aea *Q = static_cast<struct pj_aea *>(P->opaque);
     xy.y = Q->rho0 - xy.y;
-    Q->rho = hypot(xy.x, xy.y);
-    if (Q->rho != 0.0) {
+    double rho = hypot(xy.x, xy.y);
+    if (rho != 0.0) {
         if (Q->n < 0.) {
-            Q->rho = -Q->rho;
+            rho = -rho;
             xy.x = -xy.x;
             xy.y = -xy.y;
         }
-        lp.phi = Q->rho / Q->dd;
+        lp.phi = rho / Q->dd;
         if (Q->ellips) {
             lp.phi = (Q->c - lp.phi * lp.phi) / Q->n;
             if (fabs(Q->ec - fabs(lp.phi)) > TOL7) {
@@ -12,7 +12,6 @@ struct pj_eqdc_data {
     double phi1;
     double phi2;
     double n;
-    double rho;
     double rho0;
     double c;
     double *en;
@@ -28,12 +27,12 @@ static PJ_XY eqdc_e_forward(PJ_LP lp, PJ *P) { /* Ellipsoidal, forward */
     PJ_XY xy = {0.0, 0.0};
     struct pj_eqdc_data *Q = static_cast<struct pj_eqdc_data *>(P->opaque);
 
-    Q->rho =
+    const double rho =
         Q->c -
         (Q->ellips ? pj_mlfn(lp.phi, sin(lp.phi), cos(lp.phi), Q->en) : lp.phi);
     const double lam_mul_n = lp.lam * Q->n;
-    xy.x = Q->rho * sin(lam_mul_n);
-    xy.y = Q->rho0 - Q->rho * cos(lam_mul_n);
+    xy.x = rho * sin(lam_mul_n);
+    xy.y = Q->rho0 - rho * cos(lam_mul_n);
 
     return xy;
 }
@@ -42,13 +41,14 @@ static PJ_LP eqdc_e_inverse(PJ_XY xy, PJ *P) { /* Ellipsoidal, inverse */
     PJ_LP lp = {0.0, 0.0};
     struct pj_eqdc_data *Q = static_cast<struct pj_eqdc_data *>(P->opaque);
 
-    if ((Q->rho = hypot(xy.x, xy.y = Q->rho0 - xy.y)) != 0.0) {
+    double rho = hypot(xy.x, xy.y = Q->rho0 - xy.y);
+    if (rho != 0.0) {
         if (Q->n < 0.) {
-            Q->rho = -Q->rho;
+            rho = -rho;
             xy.x = -xy.x;
             xy.y = -xy.y;
         }
-        lp.phi = Q->c - Q->rho;
+        lp.phi = Q->c - rho;
         if (Q->ellips)
             lp.phi = pj_inv_mlfn(lp.phi, Q->en);
         lp.lam = atan2(xy.x, xy.y) / Q->n;
@@ -484,6 +484,270 @@ static PJ_LP exact_e_inv(PJ_XY xy, PJ *P) {
     return lp;
 }
 
+/*****************************************************************************/
+//
+//              Batch kernels for the "exact" transverse mercator
+//
+/*****************************************************************************/
+
+/* Points are processed in blocks of TMERC_BLOCK_SIZE lanes, laid out as one
+ * array per variable, so that the Clenshaw summations and the algebra around
+ * them are vectorized across lanes. Trigonometric and hyperbolic functions are
+ * still evaluated by the C library one lane at a time, and the arithmetic of
+ * each lane is the same as in exact_e_fwd() and exact_e_inv(), so that both
+ * paths give identical results, as long as the compiler is not allowed to
+ * contract products and sums into FMA instructions (which it may do
+ * differently in both paths). */
+#define TMERC_BLOCK_SIZE 8
+
+/* With GCC on x86_64 and GNU ifunc support, also build the block kernels for
+ * AVX2, in addition to the baseline SSE2, and select one at load time.
+ * AVX-512 is deliberately not a target: it includes FMA instructions, which
+ * the compiler would use to contract products and sums. AVX2 alone does not,
+ * so both variants give the same results as the scalar path. */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) &&        \
+    defined(__GLIBC__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define TMERC_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+#ifndef TMERC_TARGET_CLONES
+#define TMERC_TARGET_CLONES
+#endif
+
+/* Same as gatg(), over a block */
+inline static void gatg_block(const double *p1, const double *B,
+                              const double *cos_2B, const double *sin_2B,
+                              double *res) {
+    double h1[TMERC_BLOCK_SIZE], h2[TMERC_BLOCK_SIZE],
+        two_cos_2B[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        two_cos_2B[j] = 2 * cos_2B[j];
+        h1[j] = p1[PROJ_ETMERC_ORDER - 1];
+        h2[j] = 0;
+    }
+    for (int k = PROJ_ETMERC_ORDER - 2; k >= 0; k--) {
+        for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+            const double h = -h2[j] + two_cos_2B[j] * h1[j] + p1[k];
+            h2[j] = h1[j];
+            h1[j] = h;
+        }
+    }
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++)
+        res[j] = B[j] + h1[j] * sin_2B[j];
+}
+
+/* Same as clenS(), over a block */
+inline static void clenS_block(const double *a, const double *sin_arg_r,
+                               const double *cos_arg_r, const double *sinh_arg_i,
+                               const double *cosh_arg_i, double *R, double *I) {
+    double r[TMERC_BLOCK_SIZE], i[TMERC_BLOCK_SIZE];
+    double hr[TMERC_BLOCK_SIZE], hr1[TMERC_BLOCK_SIZE];
+    double hi[TMERC_BLOCK_SIZE], hi1[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        r[j] = 2 * cos_arg_r[j] * cosh_arg_i[j];
+        i[j] = -2 * sin_arg_r[j] * sinh_arg_i[j];
+        hi1[j] = hr1[j] = hi[j] = 0;
+        hr[j] = a[PROJ_ETMERC_ORDER - 1];
+    }
+    for (int k = PROJ_ETMERC_ORDER - 2; k >= 0; k--) {
+        for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+            const double hr2 = hr1[j];
+            const double hi2 = hi1[j];
+            hr1[j] = hr[j];
+            hi1[j] = hi[j];
+            hr[j] = -hr2 + r[j] * hr1[j] - i[j] * hi1[j] + a[k];
+            hi[j] = -hi2 + i[j] * hr1[j] + r[j] * hi1[j];
+        }
+    }
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        const double rr = sin_arg_r[j] * cosh_arg_i[j];
+        const double ii = cos_arg_r[j] * sinh_arg_i[j];
+        R[j] = rr * hr[j] - ii * hi[j];
+        I[j] = rr * hi[j] + ii * hr[j];
+    }
+}
+
+/* Ellipsoidal, forward, over a block: lam/phi in, easting/northing out.
+ * Returns a bitmask of the lanes outside of the projection domain. */
+TMERC_TARGET_CLONES
+static unsigned exact_e_fwd_block(const PoderEngsager *Q, double *lam_x,
+                                  double *phi_y) {
+    double cos_2phi[TMERC_BLOCK_SIZE], sin_2phi[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        cos_2phi[j] = cos(2 * phi_y[j]);
+        sin_2phi[j] = sin(2 * phi_y[j]);
+    }
+
+    /* ell. LAT, LNG -> Gaussian LAT, LNG */
+    double Cn[TMERC_BLOCK_SIZE];
+    gatg_block(Q->cbg, phi_y, cos_2phi, sin_2phi, Cn);
+
+    /* Gaussian LAT, LNG -> compl. sph. LAT */
+    double sin_Cn[TMERC_BLOCK_SIZE], cos_Cn_cos_Ce[TMERC_BLOCK_SIZE];
+    double inv_denom_tan_Ce[TMERC_BLOCK_SIZE], tan_Ce[TMERC_BLOCK_SIZE];
+    double Ce[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        sin_Cn[j] = sin(Cn[j]);
+        const double cos_Cn = cos(Cn[j]);
+        const double sin_Ce = sin(lam_x[j]);
+        const double cos_Ce = cos(lam_x[j]);
+
+        cos_Cn_cos_Ce[j] = cos_Cn * cos_Ce;
+        Cn[j] = atan2(sin_Cn[j], cos_Cn_cos_Ce[j]);
+
+        inv_denom_tan_Ce[j] = 1. / hypot(sin_Cn[j], cos_Cn_cos_Ce[j]);
+        tan_Ce[j] = sin_Ce * cos_Cn * inv_denom_tan_Ce[j];
+
+        /* compl. sph. N, E -> ell. norm. N, E */
+        Ce[j] = asinh(tan_Ce[j]);
+    }
+
+    double sin_arg_r[TMERC_BLOCK_SIZE], cos_arg_r[TMERC_BLOCK_SIZE];
+    double sinh_arg_i[TMERC_BLOCK_SIZE], cosh_arg_i[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        const double two_inv_denom_tan_Ce = 2 * inv_denom_tan_Ce[j];
+        const double two_inv_denom_tan_Ce_square =
+            two_inv_denom_tan_Ce * inv_denom_tan_Ce[j];
+        const double tmp_r = cos_Cn_cos_Ce[j] * two_inv_denom_tan_Ce_square;
+        sin_arg_r[j] = sin_Cn[j] * tmp_r;
+        cos_arg_r[j] = cos_Cn_cos_Ce[j] * tmp_r - 1;
+        sinh_arg_i[j] = tan_Ce[j] * two_inv_denom_tan_Ce;
+        cosh_arg_i[j] = two_inv_denom_tan_Ce_square - 1;
+    }
+
+    double dCn[TMERC_BLOCK_SIZE], dCe[TMERC_BLOCK_SIZE];
+    clenS_block(Q->gtu, sin_arg_r, cos_arg_r, sinh_arg_i, cosh_arg_i, dCn,
+                dCe);
+
+    unsigned failures = 0;
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        const double Cn_j = Cn[j] + dCn[j];
+        const double Ce_j = Ce[j] + dCe[j];
+        if (fabs(Ce_j) <= 2.623395162778) {
+            phi_y[j] = Q->Qn * Cn_j + Q->Zb; /* Northing */
+            lam_x[j] = Q->Qn * Ce_j;         /* Easting  */
+        } else {
+            failures |= 1U << j;
+        }
+    }
+    return failures;
+}
+
+/* Ellipsoidal, inverse, over a block: easting/northing in, lam/phi out.
+ * Returns a bitmask of the lanes outside of the projection domain. */
+TMERC_TARGET_CLONES
+static unsigned exact_e_inv_block(const PoderEngsager *Q, double *x_lam,
+                                  double *y_phi) {
+    unsigned failures = 0;
+
+    /* normalize N, E */
+    double Cn[TMERC_BLOCK_SIZE], Ce[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        Cn[j] = (y_phi[j] - Q->Zb) / Q->Qn;
+        Ce[j] = x_lam[j] / Q->Qn;
+        if (!(fabs(Ce[j]) <= 2.623395162778)) { /* 150 degrees */
+            failures |= 1U << j;
+            Cn[j] = Ce[j] = 0;
+        }
+    }
+
+    /* norm. N, E -> compl. sph. LAT, LNG */
+    double sin_arg_r[TMERC_BLOCK_SIZE], cos_arg_r[TMERC_BLOCK_SIZE];
+    double exp_2_Ce[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        sin_arg_r[j] = sin(2 * Cn[j]);
+        cos_arg_r[j] = cos(2 * Cn[j]);
+        exp_2_Ce[j] = exp(2 * Ce[j]);
+    }
+
+    double sinh_arg_i[TMERC_BLOCK_SIZE], cosh_arg_i[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        const double half_inv_exp_2_Ce = 0.5 / exp_2_Ce[j];
+        sinh_arg_i[j] = 0.5 * exp_2_Ce[j] - half_inv_exp_2_Ce;
+        cosh_arg_i[j] = 0.5 * exp_2_Ce[j] + half_inv_exp_2_Ce;
+    }
+
+    double dCn_ignored[TMERC_BLOCK_SIZE], dCe[TMERC_BLOCK_SIZE];
+    clenS_block(Q->utg, sin_arg_r, cos_arg_r, sinh_arg_i, cosh_arg_i,
+                dCn_ignored, dCe);
+
+    /* compl. sph. LAT -> Gaussian LAT, LNG */
+    double sin_Cn[TMERC_BLOCK_SIZE], sinhCe[TMERC_BLOCK_SIZE];
+    double modulus_Ce[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        Cn[j] += dCn_ignored[j];
+        Ce[j] += dCe[j];
+        sin_Cn[j] = sin(Cn[j]);
+        const double cos_Cn = cos(Cn[j]);
+        sinhCe[j] = sinh(Ce[j]);
+        Ce[j] = atan2(sinhCe[j], cos_Cn);
+        modulus_Ce[j] = hypot(sinhCe[j], cos_Cn);
+        Cn[j] = atan2(sin_Cn[j], modulus_Ce[j]);
+    }
+
+    /* Gaussian LAT, LNG -> ell. LAT, LNG */
+    double sin_2_Cn[TMERC_BLOCK_SIZE], cos_2_Cn[TMERC_BLOCK_SIZE];
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++) {
+        const double tmp = 2 * modulus_Ce[j] / (sinhCe[j] * sinhCe[j] + 1);
+        sin_2_Cn[j] = sin_Cn[j] * tmp;
+        cos_2_Cn[j] = tmp * modulus_Ce[j] - 1.;
+    }
+    gatg_block(Q->cgb, Cn, cos_2_Cn, sin_2_Cn, y_phi);
+    for (int j = 0; j < TMERC_BLOCK_SIZE; j++)
+        x_lam[j] = Ce[j];
+
+    return failures;
+}
+
+/* Gathers up to TMERC_BLOCK_SIZE valid points of coo into a block, runs
+ * kernel on it, and scatters the results back. */
+template <class Kernel>
+static void exact_e_batch(PJ_COORD *coo, size_t n, PJ *P, Kernel kernel) {
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    double u[TMERC_BLOCK_SIZE], v[TMERC_BLOCK_SIZE];
+    size_t idx[TMERC_BLOCK_SIZE];
+    bool error = false;
+    size_t i = 0;
+    while (i < n) {
+        int count = 0;
+        for (; i < n && count < TMERC_BLOCK_SIZE; i++) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            u[count] = coo[i].v[0];
+            v[count] = coo[i].v[1];
+            idx[count] = i;
+            count++;
+        }
+        if (count == 0)
+            break;
+        for (int j = count; j < TMERC_BLOCK_SIZE; j++) {
+            u[j] = 0;
+            v[j] = 0;
+        }
+        const unsigned failures = kernel(Q, u, v);
+        for (int j = 0; j < count; j++) {
+            if (failures & (1U << j)) {
+                coo[idx[j]] = proj_coord_error();
+                error = true;
+            } else {
+                coo[idx[j]].v[0] = u[j];
+                coo[idx[j]].v[1] = v[j];
+            }
+        }
+    }
+    if (error)
+        proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+}
+
+static void exact_e_fwd_batch(PJ_COORD *coo, size_t n, PJ *P) {
+    exact_e_batch(coo, n, P, exact_e_fwd_block);
+}
+
+static void exact_e_inv_batch(PJ_COORD *coo, size_t n, PJ *P) {
+    exact_e_batch(coo, n, P, exact_e_inv_block);
+}
+
 static PJ *setup_exact(PJ *P) {
     auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
 
@@ -644,6 +908,8 @@ static PJ *setup(PJ *P, TMercAlgo eAlg) {
         setup_exact(P);
         P->inv = exact_e_inv;
         P->fwd = exact_e_fwd;
+        P->fwd4d_batch = exact_e_fwd_batch;
+        P->inv4d_batch = exact_e_inv_batch;
         break;
     }
 
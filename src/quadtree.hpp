@@ -32,7 +32,11 @@
 
 #include "proj/util.hpp"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -74,6 +78,13 @@ struct RectObj {
         return minx <= x && maxx >= x && miny <= y && maxy >= y;
     }
 
+    /* Returns the squared distance of (x,y) to this rectangle */
+    inline double squaredDistance(double x, double y) const {
+        const double dx = std::max(std::max(minx - x, 0.0), x - maxx);
+        const double dy = std::max(std::max(miny - y, 0.0), y - maxy);
+        return dx * dx + dy * dy;
+    }
+
     /* Return whether this rectangles is different from other */
     inline bool operator!=(const RectObj &other) const {
         return minx != other.minx || miny != other.miny || maxx != other.maxx ||
@@ -123,6 +134,89 @@ template <class Feature> class QuadTree {
         search(root, x, y, features);
     }
 
+    /** Retrieve the (at most) k features nearest to (x,y), with their
+     * distance, by increasing distance.
+     *
+     * distance(feature, featureBounds) must return the squared distance of
+     * the feature to (x,y), which must not be smaller than the squared
+     * distance of (x,y) to featureBounds. Features for which it returns
+     * infinity are ignored. Among features at the same distance, the
+     * smallest ones (per operator<) come first.
+     */
+    template <class DistanceFunc>
+    void searchNearest(double x, double y, size_t k, DistanceFunc &&distance,
+                       std::vector<std::pair<Feature, double>> &results) const {
+        results.clear();
+        if (k == 0)
+            return;
+
+        // Best-first traversal: nodes are visited by increasing distance of
+        // their bounds to (x,y), until it exceeds the distance of the k-th
+        // nearest feature found so far.
+        const auto resultLess = [](const std::pair<Feature, double> &a,
+                                   const std::pair<Feature, double> &b) {
+            return a.second < b.second ||
+                   (a.second == b.second && a.first < b.first);
+        };
+        using NodeDist = std::pair<double, const Node *>;
+        const auto nodeGreater = [](const NodeDist &a, const NodeDist &b) {
+            return a.first > b.first;
+        };
+        std::priority_queue<NodeDist, std::vector<NodeDist>,
+                            decltype(nodeGreater)>
+            queue(nodeGreater);
+        queue.emplace(root.rect.squaredDistance(x, y), &root);
+        // results is kept as a max-heap (per resultLess) until the end
+        const auto worstDistance = [&results, k]() {
+            return results.size() < k
+                       ? std::numeric_limits<double>::infinity()
+                       : results.front().second;
+        };
+        while (!queue.empty()) {
+            const auto top = queue.top();
+            if (top.first > worstDistance())
+                break;
+            queue.pop();
+            const Node &node = *(top.second);
+            for (const auto &pair : node.features) {
+                if (pair.second.squaredDistance(x, y) > worstDistance())
+                    continue;
+                const double dist = distance(pair.first, pair.second);
+                if (dist == std::numeric_limits<double>::infinity())
+                    continue;
+                std::pair<Feature, double> candidate(pair.first, dist);
+                if (results.size() < k) {
+                    results.emplace_back(std::move(candidate));
+                    std::push_heap(results.begin(), results.end(), resultLess);
+                } else if (resultLess(candidate, results.front())) {
+                    std::pop_heap(results.begin(), results.end(), resultLess);
+                    results.back() = std::move(candidate);
+                    std::push_heap(results.begin(), results.end(), resultLess);
+                }
+            }
+            for (const auto &subnode : node.subnodes) {
+                const double dist = subnode.rect.squaredDistance(x, y);
+                if (dist <= worstDistance())
+                    queue.emplace(dist, &subnode);
+            }
+        }
+        std::sort_heap(results.begin(), results.end(), resultLess);
+    }
+
+    /** Retrieve the (at most) k features whose bounds are the nearest to
+     * (x,y), with the squared distance to their bounds, by increasing
+     * distance. */
+    void searchNearestBounds(
+        double x, double y, size_t k,
+        std::vector<std::pair<Feature, double>> &results) const {
+        searchNearest(
+            x, y, k,
+            [x, y](const Feature &, const RectObj &featureBounds) {
+                return featureBounds.squaredDistance(x, y);
+            },
+            results);
+    }
+
   private:
     void splitBounds(const RectObj &in, RectObj &out1, RectObj &out2) {
         // The output bounds will be very similar to the input bounds,
@@ -67,15 +67,17 @@ const char *proj_context_errno_string(PJ_CONTEXT *ctx, int err) {
         str = _("Unspecified error related to coordinate transformation");
     }
 
+    // Kept in the current handle while it runs a compiled transformation
+    PJ_TRANS_HANDLE *handle = pj_trans_handle_for(ctx);
+    std::string &lastFullErrorMessage =
+        handle ? handle->lastFullErrorMessage : ctx->lastFullErrorMessage;
     if (str) {
-        ctx->lastFullErrorMessage = str;
+        lastFullErrorMessage = str;
     } else {
-        ctx->lastFullErrorMessage.resize(50);
-        snprintf(&ctx->lastFullErrorMessage[0],
-                 ctx->lastFullErrorMessage.size(), _("Unknown error (code %d)"),
-                 err);
-        ctx->lastFullErrorMessage.resize(
-            strlen(ctx->lastFullErrorMessage.data()));
+        lastFullErrorMessage.resize(50);
+        snprintf(&lastFullErrorMessage[0], lastFullErrorMessage.size(),
+                 _("Unknown error (code %d)"), err);
+        lastFullErrorMessage.resize(strlen(lastFullErrorMessage.data()));
     }
-    return ctx->lastFullErrorMessage.c_str();
+    return lastFullErrorMessage.c_str();
 }
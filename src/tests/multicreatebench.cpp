@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ * Project:  PROJ
+ * Purpose:  Benchmark of concurrent creation of PJ objects, exercising the
+ *           process-wide caches (init files, known grids) shared by threads.
+ *
+ ******************************************************************************
+ * Copyright (c) 2024, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "proj.h"
+
+static const char *const default_definitions[] = {
+    "+init=ITRF2014:ITRF2008",
+    "+init=ITRF2008:ITRF2005",
+    "+proj=hgridshift +grids=ntv1_can.dat",
+    "+proj=hgridshift +grids=ntf_r93.gsb",
+    "+proj=vgridshift +grids=egm96_15.gtx +multiplier=1",
+    "+proj=gridshift +grids=ntv1_can.dat",
+    "+proj=utm +zone=31 +ellps=GRS80",
+};
+
+static void usage() {
+    printf("Usage: multicreatebench [--iterations N] [--max-threads N]\n"
+           "                        [definition]*\n"
+           "\n"
+           "Creates and destroys the given PROJ definitions in a loop,\n"
+           "from 1 to max-threads threads (each with its own context),\n"
+           "and reports the number of creations per second.\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    int iterations = 2000;
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 4)
+        max_threads = 4;
+    std::vector<std::string> definitions;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage();
+        } else {
+            definitions.push_back(argv[i]);
+        }
+    }
+    if (iterations <= 0 || max_threads <= 0)
+        usage();
+
+    // Only keep definitions that can be instantiated in this environment
+    // (grids may be missing).
+    {
+        std::vector<std::string> candidates(definitions);
+        if (candidates.empty()) {
+            for (const char *def : default_definitions)
+                candidates.push_back(def);
+        }
+        definitions.clear();
+        PJ_CONTEXT *ctx = proj_context_create();
+        proj_log_level(ctx, PJ_LOG_NONE);
+        for (const auto &def : candidates) {
+            PJ *P = proj_create(ctx, def.c_str());
+            if (P) {
+                definitions.push_back(def);
+                proj_destroy(P);
+            } else {
+                fprintf(stderr, "Skipping '%s': cannot be instantiated\n",
+                        def.c_str());
+            }
+        }
+        proj_context_destroy(ctx);
+    }
+    if (definitions.empty()) {
+        fprintf(stderr, "No definition could be instantiated\n");
+        return 1;
+    }
+
+    printf("%-8s %14s %14s\n", "threads", "creations/s", "per thread/s");
+    for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2) {
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < nthreads; t++) {
+            threads.emplace_back([&definitions, &failures, iterations, t]() {
+                PJ_CONTEXT *ctx = proj_context_create();
+                proj_log_level(ctx, PJ_LOG_NONE);
+                for (int i = 0; i < iterations; i++) {
+                    const auto &def =
+                        definitions[(i + t) % definitions.size()];
+                    PJ *P = proj_create(ctx, def.c_str());
+                    if (!P)
+                        ++failures;
+                    proj_destroy(P);
+                }
+                proj_context_destroy(ctx);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        const double elapsed = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        const double total = static_cast<double>(nthreads) * iterations;
+        printf("%-8d %14.0f %14.0f\n", nthreads, total / elapsed,
+               total / elapsed / nthreads);
+        if (failures)
+            fprintf(stderr, "%d creations failed\n", failures.load());
+    }
+
+    return 0;
+}
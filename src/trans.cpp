@@ -33,7 +33,15 @@
 #include "proj_internal.h"
 #include <math.h>
 
+#include <algorithm>
+#include <limits>
+
+#ifndef __MINGW32__
+#include <thread>
+#endif
+
 #include "proj/internal/io_internal.hpp"
+#include "quadtree.hpp"
 
 inline bool pj_coord_has_nans(PJ_COORD coo) {
     return std::isnan(coo.v[0]) || std::isnan(coo.v[1]) ||
@@ -41,34 +49,124 @@ inline bool pj_coord_has_nans(PJ_COORD coo) {
 }
 
 /**************************************************************************************/
-int pj_get_suggested_operation(PJ_CONTEXT *,
-                               const std::vector<PJCoordOperation> &opList,
-                               const int iExcluded[2], bool skipNonInstantiable,
-                               PJ_DIRECTION direction, PJ_COORD coord)
+struct PJCoordOperationIndex
 /**************************************************************************************/
 {
-    const auto normalizeLongitude = [](double x) {
-        if (x > 180.0) {
-            x -= 360.0;
-            if (x > 180.0)
-                x = fmod(x + 180.0, 360.0) - 180.0;
-        } else if (x < -180.0) {
-            x += 360.0;
-            if (x < -180.0)
-                x = fmod(x + 180.0, 360.0) - 180.0;
-        }
-        return x;
+    // Per-direction index. Only operations whose extent is expressed in the
+    // same CRS as the input coordinates are indexed in the quadtree. Others
+    // (geocentric ones, or with an invalid extent) are always candidates.
+    struct Side {
+        std::unique_ptr<NS_PROJ::QuadTree::QuadTree<int>> tree{};
+        std::vector<int> alwaysCandidates{};
+        bool hasLonLatDegree = false;
+        bool hasLatLonDegree = false;
+
+        // Sorted distinct edges of the indexed extents. Two points that fall
+        // in the same "cell" delimited by those edges are contained in the
+        // exact same set of extents.
+        std::vector<double> edgesX{};
+        std::vector<double> edgesY{};
     };
+    Side src{};
+    Side dst{};
+};
 
-    // Select the operations that match the area of use
-    // and has the best accuracy.
-    int iBest = -1;
-    double bestAccuracy = std::numeric_limits<double>::max();
-    const int nOperations = static_cast<int>(opList.size());
-    for (int i = 0; i < nOperations; i++) {
-        if (i == iExcluded[0] || i == iExcluded[1]) {
-            continue;
+/**************************************************************************************/
+std::shared_ptr<PJCoordOperationIndex>
+pj_create_coord_operation_index(const std::vector<PJCoordOperation> &opList)
+/**************************************************************************************/
+{
+    auto index = std::make_shared<PJCoordOperationIndex>();
+
+    const auto buildSide = [&opList](PJCoordOperationIndex::Side &side,
+                                     bool isSrc) {
+        NS_PROJ::QuadTree::RectObj globalBounds;
+        bool first = true;
+        std::vector<std::pair<int, NS_PROJ::QuadTree::RectObj>> rects;
+        for (int i = 0; i < static_cast<int>(opList.size()); ++i) {
+            const auto &alt = opList[i];
+            NS_PROJ::QuadTree::RectObj rect;
+            rect.minx = isSrc ? alt.minxSrc : alt.minxDst;
+            rect.miny = isSrc ? alt.minySrc : alt.minyDst;
+            rect.maxx = isSrc ? alt.maxxSrc : alt.maxxDst;
+            rect.maxy = isSrc ? alt.maxySrc : alt.maxyDst;
+            const bool isGeocentric = isSrc ? alt.pjSrcGeocentricToLonLat
+                                            : alt.pjDstGeocentricToLonLat;
+            if (isGeocentric || !(rect.minx <= rect.maxx) ||
+                !(rect.miny <= rect.maxy) || !std::isfinite(rect.minx) ||
+                !std::isfinite(rect.miny) || !std::isfinite(rect.maxx) ||
+                !std::isfinite(rect.maxy)) {
+                side.alwaysCandidates.push_back(i);
+                continue;
+            }
+            if (isSrc ? alt.srcIsLonLatDegree : alt.dstIsLonLatDegree)
+                side.hasLonLatDegree = true;
+            if (isSrc ? alt.srcIsLatLonDegree : alt.dstIsLatLonDegree)
+                side.hasLatLonDegree = true;
+            if (first) {
+                globalBounds = rect;
+                first = false;
+            } else {
+                globalBounds.minx = std::min(globalBounds.minx, rect.minx);
+                globalBounds.miny = std::min(globalBounds.miny, rect.miny);
+                globalBounds.maxx = std::max(globalBounds.maxx, rect.maxx);
+                globalBounds.maxy = std::max(globalBounds.maxy, rect.maxy);
+            }
+            side.edgesX.push_back(rect.minx);
+            side.edgesX.push_back(rect.maxx);
+            side.edgesY.push_back(rect.miny);
+            side.edgesY.push_back(rect.maxy);
+            rects.emplace_back(i, rect);
+        }
+        side.tree.reset(new NS_PROJ::QuadTree::QuadTree<int>(globalBounds));
+        for (const auto &pair : rects)
+            side.tree->insert(pair.first, pair.second);
+        for (auto *edges : {&side.edgesX, &side.edgesY}) {
+            std::sort(edges->begin(), edges->end());
+            edges->erase(std::unique(edges->begin(), edges->end()),
+                         edges->end());
         }
+    };
+    buildSide(index->src, true);
+    buildSide(index->dst, false);
+    return index;
+}
+
+/**************************************************************************************/
+static size_t pj_coord_operation_index_cell(const std::vector<double> &edges,
+                                            double v)
+/**************************************************************************************/
+{
+    // Odd values for points exactly on an edge, even values for points
+    // strictly between two edges, since extents are closed.
+    const auto iter = std::lower_bound(edges.begin(), edges.end(), v);
+    const size_t i = static_cast<size_t>(iter - edges.begin());
+    return (iter != edges.end() && *iter == v) ? 2 * i + 1 : 2 * i;
+}
+
+static double pj_normalize_longitude(double x) {
+    if (x > 180.0) {
+        x -= 360.0;
+        if (x > 180.0)
+            x = fmod(x + 180.0, 360.0) - 180.0;
+    } else if (x < -180.0) {
+        x += 360.0;
+        if (x < -180.0)
+            x = fmod(x + 180.0, 360.0) - 180.0;
+    }
+    return x;
+}
+
+/**************************************************************************************/
+int pj_get_suggested_operation(PJ_CONTEXT *,
+                               const std::vector<PJCoordOperation> &opList,
+                               const int iExcluded[2], bool skipNonInstantiable,
+                               PJ_DIRECTION direction, PJ_COORD coord,
+                               const PJCoordOperationIndex *index,
+                               PJCoordOperationMemo *memo)
+/**************************************************************************************/
+{
+    const auto isSpatialCriterionOK = [&opList, direction, &coord](int i) {
         const auto &alt = opList[i];
         bool spatialCriterionOK = false;
         if (direction == PJ_FWD) {
@@ -93,14 +191,16 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
                 spatialCriterionOK = true;
             } else if (alt.srcIsLonLatDegree && coord.xyzt.y >= alt.minySrc &&
                        coord.xyzt.y <= alt.maxySrc) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.x);
+                const double normalizedLon =
+                    pj_normalize_longitude(coord.xyzt.x);
                 if (normalizedLon >= alt.minxSrc &&
                     normalizedLon <= alt.maxxSrc) {
                     spatialCriterionOK = true;
                 }
             } else if (alt.srcIsLatLonDegree && coord.xyzt.x >= alt.minxSrc &&
                        coord.xyzt.x <= alt.maxxSrc) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.y);
+                const double normalizedLon =
+                    pj_normalize_longitude(coord.xyzt.y);
                 if (normalizedLon >= alt.minySrc &&
                     normalizedLon <= alt.maxySrc) {
                     spatialCriterionOK = true;
@@ -128,22 +228,35 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
                 spatialCriterionOK = true;
             } else if (alt.dstIsLonLatDegree && coord.xyzt.y >= alt.minyDst &&
                        coord.xyzt.y <= alt.maxyDst) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.x);
+                const double normalizedLon =
+                    pj_normalize_longitude(coord.xyzt.x);
                 if (normalizedLon >= alt.minxDst &&
                     normalizedLon <= alt.maxxDst) {
                     spatialCriterionOK = true;
                 }
             } else if (alt.dstIsLatLonDegree && coord.xyzt.x >= alt.minxDst &&
                        coord.xyzt.x <= alt.maxxDst) {
-                const double normalizedLon = normalizeLongitude(coord.xyzt.y);
+                const double normalizedLon =
+                    pj_normalize_longitude(coord.xyzt.y);
                 if (normalizedLon >= alt.minyDst &&
                     normalizedLon <= alt.maxyDst) {
                     spatialCriterionOK = true;
                 }
             }
         }
+        return spatialCriterionOK;
+    };
 
-        if (spatialCriterionOK) {
+    // Select the operations that match the area of use
+    // and has the best accuracy.
+    int iBest = -1;
+    double bestAccuracy = std::numeric_limits<double>::max();
+    const auto evaluate = [&](int i) {
+        if (i == iExcluded[0] || i == iExcluded[1]) {
+            return;
+        }
+        const auto &alt = opList[i];
+        if (isSpatialCriterionOK(i)) {
             // The offshore test is for the "Test bug 245 (use +datum=carthage)"
             // of test_cs2cs_various.yaml. The long=10 lat=34 point belongs
             // both to the onshore and offshore Tunisia area of uses, but is
@@ -161,19 +274,194 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
                  !alt.isOffshore)) {
 
                 if (skipNonInstantiable && !alt.isInstantiable()) {
-                    continue;
+                    return;
                 }
                 iBest = i;
                 bestAccuracy = alt.accuracy;
             }
         }
+    };
+
+    if (index == nullptr) {
+        const int nOperations = static_cast<int>(opList.size());
+        for (int i = 0; i < nOperations; i++) {
+            evaluate(i);
+        }
+        return iBest;
+    }
+
+    // Use the spatial index to restrict the operations to evaluate. The
+    // query points are the ones that isSpatialCriterionOK() may test.
+    const auto &side = direction == PJ_FWD ? index->src : index->dst;
+    double queryPoints[3][2];
+    int nQueryPoints = 0;
+    queryPoints[nQueryPoints][0] = coord.xyzt.x;
+    queryPoints[nQueryPoints][1] = coord.xyzt.y;
+    ++nQueryPoints;
+    if (side.hasLonLatDegree) {
+        queryPoints[nQueryPoints][0] = pj_normalize_longitude(coord.xyzt.x);
+        queryPoints[nQueryPoints][1] = coord.xyzt.y;
+        ++nQueryPoints;
+    }
+    if (side.hasLatLonDegree) {
+        queryPoints[nQueryPoints][0] = coord.xyzt.x;
+        queryPoints[nQueryPoints][1] = pj_normalize_longitude(coord.xyzt.y);
+        ++nQueryPoints;
+    }
+
+    // Consecutive points often fall in the same cell, in which case the
+    // candidates, and generally the best operation, are the previous ones.
+    size_t cellKey[6];
+    bool sameCell = false;
+    if (memo) {
+        for (int j = 0; j < nQueryPoints; ++j) {
+            cellKey[2 * j] =
+                pj_coord_operation_index_cell(side.edgesX, queryPoints[j][0]);
+            cellKey[2 * j + 1] =
+                pj_coord_operation_index_cell(side.edgesY, queryPoints[j][1]);
+        }
+        sameCell = memo->valid && memo->direction == direction &&
+                   memo->nCellKey == 2 * nQueryPoints &&
+                   std::equal(cellKey, cellKey + 2 * nQueryPoints,
+                              memo->cellKey);
+    }
+
+    // The result only depends on the cell, unless some operations need
+    // to transform the coordinate to be tested.
+    const bool bestIsCacheable = side.alwaysCandidates.empty() &&
+                                 iExcluded[0] < 0 && iExcluded[1] < 0;
+    if (sameCell && bestIsCacheable && memo->bestValid &&
+        memo->bestSkipNonInstantiable == skipNonInstantiable) {
+        return memo->best;
     }
 
+    std::vector<int> localCandidates;
+    std::vector<int> &candidates = memo ? memo->candidates : localCandidates;
+    if (!sameCell) {
+        candidates = side.alwaysCandidates;
+        for (int j = 0; j < nQueryPoints; ++j) {
+            side.tree->search(queryPoints[j][0], queryPoints[j][1],
+                              candidates);
+        }
+        // Evaluate in the same order as without index, so that ties are
+        // resolved identically.
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+        if (memo) {
+            memo->valid = true;
+            memo->bestValid = false;
+            memo->direction = direction;
+            memo->nCellKey = 2 * nQueryPoints;
+            std::copy(cellKey, cellKey + 2 * nQueryPoints, memo->cellKey);
+        }
+    }
+    for (int i : candidates) {
+        evaluate(i);
+    }
+
+    if (memo && bestIsCacheable) {
+        memo->bestValid = true;
+        memo->bestSkipNonInstantiable = skipNonInstantiable;
+        memo->best = iBest;
+    }
     return iBest;
 }
 
 /**************************************************************************************/
-void pj_warn_about_missing_grid(PJ *P)
+/* Compiled transformations and their per-thread handles */
+/**************************************************************************************/
+
+thread_local PJ_TRANS_HANDLE *pj_current_trans_handle = nullptr;
+
+PJTransHandleScratch::~PJTransHandleScratch() = default;
+
+/* Immutable state of a compiled transformation, shared by its handles */
+struct PJCompiledTransformationState {
+    PJ_CONTEXT *ctx = nullptr; /* private clone of the context of the source */
+    PJ *pj = nullptr;          /* clone of the source */
+
+    /* For each alternative operation of pj, whether it needs no grid, and
+     * the message logged when it fails for lack of grids, as computing them
+     * queries the database */
+    std::vector<bool> alternativeNeedsNoGrid{};
+    std::vector<std::string> alternativeMissingGridMessages{};
+
+    PJCompiledTransformationState() = default;
+    PJCompiledTransformationState(const PJCompiledTransformationState &) =
+        delete;
+    PJCompiledTransformationState &
+    operator=(const PJCompiledTransformationState &) = delete;
+
+    ~PJCompiledTransformationState() {
+        proj_destroy(pj);
+        if (ctx)
+            proj_context_destroy(ctx);
+    }
+};
+
+struct PJ_COMPILED_TRANSFORMATION {
+    std::shared_ptr<const PJCompiledTransformationState> state{};
+};
+
+/* Makes handle the current handle of the calling thread while in scope */
+struct PJTransHandleScope {
+    PJ_TRANS_HANDLE *previous;
+
+    explicit PJTransHandleScope(PJ_TRANS_HANDLE *handle)
+        : previous(pj_current_trans_handle) {
+        pj_current_trans_handle = handle;
+    }
+    PJTransHandleScope(const PJTransHandleScope &) = delete;
+    PJTransHandleScope &operator=(const PJTransHandleScope &) = delete;
+
+    ~PJTransHandleScope() { pj_current_trans_handle = previous; }
+};
+
+/**************************************************************************************/
+struct PJTransState
+/**************************************************************************************
+    State of P that proj_trans() changes. It is held by the current handle
+    when P is a compiled transformation, and not kept at all for the other
+    objects of a compiled transformation, as they are shared between threads.
+**************************************************************************************/
+{
+    int *iCurCoordOp;
+    PJCoordOperationMemo *memo;
+    bool *warnIfBestTransformationNotAvailable;
+    const PJCompiledTransformationState *compiled = nullptr;
+
+    int unusedCurCoordOp = -1;
+    bool unusedWarnIfBestTransformationNotAvailable;
+
+    explicit PJTransState(PJ *P)
+        : iCurCoordOp(&P->iCurCoordOp), memo(&P->coordOperationMemo),
+          warnIfBestTransformationNotAvailable(
+              &P->warnIfBestTransformationNotAvailable),
+          unusedWarnIfBestTransformationNotAvailable(
+              P->warnIfBestTransformationNotAvailable) {
+        PJ_TRANS_HANDLE *handle = pj_trans_handle_for(P->ctx);
+        if (handle == nullptr)
+            return;
+        if (handle->pj == P) {
+            iCurCoordOp = &handle->iCurCoordOp;
+            memo = &handle->coordOperationMemo;
+            warnIfBestTransformationNotAvailable =
+                &handle->warnIfBestTransformationNotAvailable;
+            compiled = handle->compiled.get();
+        } else {
+            iCurCoordOp = &unusedCurCoordOp;
+            memo = nullptr;
+            warnIfBestTransformationNotAvailable =
+                &unusedWarnIfBestTransformationNotAvailable;
+        }
+    }
+    PJTransState(const PJTransState &) = delete;
+    PJTransState &operator=(const PJTransState &) = delete;
+};
+
+/**************************************************************************************/
+static std::string pj_missing_grid_message(PJ *P)
 /**************************************************************************************/
 {
     std::string msg("Attempt to use coordinate operation ");
@@ -193,13 +481,21 @@ void pj_warn_about_missing_grid(PJ *P)
                    "Consult https://proj.org/resource_files.html for guidance.";
         }
     }
+    return msg;
+}
+
+/**************************************************************************************/
+static void pj_log_missing_grid(const PJ *P, std::string msg,
+                                bool &warnIfBestTransformationNotAvailable)
+/**************************************************************************************/
+{
     if (!P->errorIfBestTransformationNotAvailable &&
-        P->warnIfBestTransformationNotAvailable) {
+        warnIfBestTransformationNotAvailable) {
         msg += " This might become an error in a future PROJ major release. "
                "Set the ONLY_BEST option to YES or NO. "
                "This warning will no longer be emitted (for the current "
                "transformation instance).";
-        P->warnIfBestTransformationNotAvailable = false;
+        warnIfBestTransformationNotAvailable = false;
     }
     pj_log(P->ctx,
            P->errorIfBestTransformationNotAvailable ? PJ_LOG_ERROR
@@ -207,6 +503,14 @@ void pj_warn_about_missing_grid(PJ *P)
            msg.c_str());
 }
 
+/**************************************************************************************/
+void pj_warn_about_missing_grid(PJ *P)
+/**************************************************************************************/
+{
+    pj_log_missing_grid(P, pj_missing_grid_message(P),
+                        P->warnIfBestTransformationNotAvailable);
+}
+
 /**************************************************************************************/
 PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
     /***************************************************************************************
@@ -227,12 +531,15 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         return proj_coord_error();
     }
 
+    PJTransState state(P);
     if (!P->alternativeCoordinateOperations.empty()) {
         constexpr int N_MAX_RETRY = 2;
         int iExcluded[N_MAX_RETRY] = {-1, -1};
 
+        bool &warnIfBestTransformationNotAvailable =
+            *state.warnIfBestTransformationNotAvailable;
         bool skipNonInstantiable = P->skipNonInstantiable &&
-                                   !P->warnIfBestTransformationNotAvailable &&
+                                   !warnIfBestTransformationNotAvailable &&
                                    !P->errorIfBestTransformationNotAvailable;
         const int nOperations =
             static_cast<int>(P->alternativeCoordinateOperations.size());
@@ -247,7 +554,8 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
             // use and has the best accuracy.
             int iBest = pj_get_suggested_operation(
                 P->ctx, P->alternativeCoordinateOperations, iExcluded,
-                skipNonInstantiable, direction, coord);
+                skipNonInstantiable, direction, coord,
+                P->alternativeCoordinateOperationsIndex.get(), state.memo);
             if (iBest < 0) {
                 break;
             }
@@ -263,13 +571,13 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
             }
 
             const auto &alt = P->alternativeCoordinateOperations[iBest];
-            if (P->iCurCoordOp != iBest) {
+            if (*state.iCurCoordOp != iBest) {
                 if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
                     std::string msg("Using coordinate operation ");
                     msg += alt.name;
                     pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
                 }
-                P->iCurCoordOp = iBest;
+                *state.iCurCoordOp = iBest;
             }
             PJ_COORD res = coord;
             if (alt.pj->hasCoordinateEpoch)
@@ -284,13 +592,20 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
             if (res.xyzt.x != HUGE_VAL) {
                 return res;
             } else if (P->errorIfBestTransformationNotAvailable ||
-                       P->warnIfBestTransformationNotAvailable) {
-                pj_warn_about_missing_grid(alt.pj);
+                       warnIfBestTransformationNotAvailable) {
+                if (state.compiled) {
+                    pj_log_missing_grid(
+                        alt.pj,
+                        state.compiled->alternativeMissingGridMessages[iBest],
+                        warnIfBestTransformationNotAvailable);
+                } else {
+                    pj_warn_about_missing_grid(alt.pj);
+                }
                 if (P->errorIfBestTransformationNotAvailable) {
                     proj_errno_set(P, PROJ_ERR_COORD_TRANSFM_NO_OPERATION);
                     return res;
                 }
-                P->warnIfBestTransformationNotAvailable = false;
+                warnIfBestTransformationNotAvailable = false;
                 skipNonInstantiable = true;
             }
             if (iRetry == N_MAX_RETRY) {
@@ -304,7 +619,7 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         // use the first operation that does not require grids.
         NS_PROJ::io::DatabaseContextPtr dbContext;
         try {
-            if (P->ctx->cpp_context) {
+            if (P->ctx->cpp_context && !state.compiled) {
                 dbContext =
                     P->ctx->cpp_context->getDatabaseContext().as_nullable();
             }
@@ -312,29 +627,34 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         }
         for (int i = 0; i < nOperations; i++) {
             const auto &alt = P->alternativeCoordinateOperations[i];
-            auto coordOperation =
-                dynamic_cast<NS_PROJ::operation::CoordinateOperation *>(
-                    alt.pj->iso_obj.get());
-            if (coordOperation) {
-                if (coordOperation->gridsNeeded(dbContext, true).empty()) {
-                    if (P->iCurCoordOp != i) {
-                        if (proj_log_level(P->ctx, PJ_LOG_TELL) >=
-                            PJ_LOG_DEBUG) {
-                            std::string msg("Using coordinate operation ");
-                            msg += alt.name;
-                            msg += " as a fallback due to lack of more "
-                                   "appropriate operations";
-                            pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
-                        }
-                        P->iCurCoordOp = i;
-                    }
-                    if (direction == PJ_FWD) {
-                        pj_fwd4d(coord, alt.pj);
-                    } else {
-                        pj_inv4d(coord, alt.pj);
+            bool needsNoGrid;
+            if (state.compiled) {
+                needsNoGrid = state.compiled->alternativeNeedsNoGrid[i];
+            } else {
+                auto coordOperation =
+                    dynamic_cast<NS_PROJ::operation::CoordinateOperation *>(
+                        alt.pj->iso_obj.get());
+                needsNoGrid =
+                    coordOperation &&
+                    coordOperation->gridsNeeded(dbContext, true).empty();
+            }
+            if (needsNoGrid) {
+                if (*state.iCurCoordOp != i) {
+                    if (proj_log_level(P->ctx, PJ_LOG_TELL) >= PJ_LOG_DEBUG) {
+                        std::string msg("Using coordinate operation ");
+                        msg += alt.name;
+                        msg += " as a fallback due to lack of more "
+                               "appropriate operations";
+                        pj_log(P->ctx, PJ_LOG_DEBUG, msg.c_str());
                     }
-                    return coord;
+                    *state.iCurCoordOp = i;
+                }
+                if (direction == PJ_FWD) {
+                    pj_fwd4d(coord, alt.pj);
+                } else {
+                    pj_inv4d(coord, alt.pj);
                 }
+                return coord;
             }
         }
 
@@ -342,7 +662,7 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         return proj_coord_error();
     }
 
-    P->iCurCoordOp =
+    *state.iCurCoordOp =
         0; // dummy value, to be used by proj_trans_get_last_used_operation()
     if (P->hasCoordinateEpoch)
         coord.xyzt.t = P->coordinateEpoch;
@@ -373,6 +693,83 @@ object must be freed with proj_destroy().
                       P->alternativeCoordinateOperations[P->iCurCoordOp].pj);
 }
 
+/* Number of coordinates processed at once by the batch code path */
+constexpr size_t BATCH_SIZE = 256;
+
+/**************************************************************************************/
+static bool pj_can_trans_batch(const PJ *P, PJ_DIRECTION direction)
+/**************************************************************************************/
+{
+    // direction is assumed to already account for P->inverted
+    if (P->iso_obj != nullptr && !P->iso_obj_is_coordinate_operation)
+        return false;
+    if (!P->alternativeCoordinateOperations.empty())
+        return false;
+    if (direction == PJ_FWD)
+        return P->fwd4d_batch != nullptr;
+    if (direction == PJ_INV)
+        return P->inv4d_batch != nullptr;
+    return false;
+}
+
+/**************************************************************************************/
+static void pj_trans_batch(PJ *P, PJ_DIRECTION direction, size_t n,
+                           PJ_COORD *coord, int *errnos)
+/**************************************************************************************
+    Transform n (<= BATCH_SIZE) coordinates through the batch operator of P,
+    giving the same results as calling proj_trans() on each of them.
+
+    Coordinates that fail in the batch are transformed again with the scalar
+    path from their original value, so that the error code of each of them,
+    as well as the final context errno, match exactly what proj_trans()
+    would have produced. If errnos is not null, it receives the error code
+    of each coordinate.
+**************************************************************************************/
+{
+    PJ_COORD input[BATCH_SIZE];
+    bool hasNaN[BATCH_SIZE];
+
+    for (size_t i = 0; i < n; i++) {
+        if (P->hasCoordinateEpoch)
+            coord[i].xyzt.t = P->coordinateEpoch;
+        input[i] = coord[i];
+        hasNaN[i] = pj_coord_has_nans(coord[i]);
+        // Make the batch kernels skip it
+        if (hasNaN[i])
+            coord[i].v[0] = HUGE_VAL;
+    }
+
+    const int last_errno = proj_context_errno(P->ctx);
+    PJTransState state(P);
+    *state.iCurCoordOp = 0;
+    if (direction == PJ_FWD)
+        pj_fwd4d_batch(coord, n, P);
+    else
+        pj_inv4d_batch(coord, n, P);
+    proj_context_errno_set(P->ctx, last_errno);
+
+    for (size_t i = 0; i < n; i++) {
+        if (hasNaN[i]) {
+            coord[i].v[0] = coord[i].v[1] = coord[i].v[2] = coord[i].v[3] =
+                std::numeric_limits<double>::quiet_NaN();
+            if (errnos)
+                errnos[i] = 0;
+        } else if (coord[i].v[0] == HUGE_VAL) {
+            if (errnos)
+                proj_context_errno_set(P->ctx, 0);
+            coord[i] = input[i];
+            if (direction == PJ_FWD)
+                pj_fwd4d(coord[i], P);
+            else
+                pj_inv4d(coord[i], P);
+            if (errnos)
+                errnos[i] = proj_errno(P);
+        } else if (errnos) {
+            errnos[i] = 0;
+        }
+    }
+}
+
 /*****************************************************************************/
 int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
     /******************************************************************************
@@ -394,10 +791,7 @@ int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
     bool hasSetRetErrno = false;
     bool sameRetErrno = true;
 
-    for (i = 0; i < n; i++) {
-        proj_context_errno_set(P->ctx, 0);
-        coord[i] = proj_trans(P, direction, coord[i]);
-        int thisErrno = proj_errno(P);
+    const auto accumulateErrno = [&](int thisErrno) {
         if (thisErrno != 0) {
             if (!hasSetRetErrno) {
                 retErrno = thisErrno;
@@ -407,6 +801,26 @@ int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
                 retErrno = PROJ_ERR_COORD_TRANSFM;
             }
         }
+    };
+
+    const PJ_DIRECTION effectiveDirection =
+        P->inverted ? pj_opposite_direction(direction) : direction;
+    if (pj_can_trans_batch(P, effectiveDirection)) {
+        int errnos[BATCH_SIZE];
+        for (i = 0; i < n; i += BATCH_SIZE) {
+            const size_t nBlock = std::min(BATCH_SIZE, n - i);
+            pj_trans_batch(P, effectiveDirection, nBlock, coord + i, errnos);
+            for (size_t j = 0; j < nBlock; j++)
+                accumulateErrno(errnos[j]);
+        }
+        proj_context_errno_set(P->ctx, retErrno);
+        return retErrno;
+    }
+
+    for (i = 0; i < n; i++) {
+        proj_context_errno_set(P->ctx, 0);
+        coord[i] = proj_trans(P, direction, coord[i]);
+        accumulateErrno(proj_errno(P));
     }
 
     proj_context_errno_set(P->ctx, retErrno);
@@ -535,33 +949,84 @@ size_t proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x, size_t sx,
     /* Arrays of length >1 are iterated over (for the first nmin values) */
     /* The slightly convolved incremental indexing is used due           */
     /* to the stride, which may be any size supported by the platform    */
-    for (i = 0; i < nmin; i++) {
-        coord.xyzt.x = *x;
-        coord.xyzt.y = *y;
-        coord.xyzt.z = *z;
-        coord.xyzt.t = *t;
-
-        coord = proj_trans(P, direction, coord);
-
-        /* in all full length cases, we overwrite the input with the output,  */
-        /* and step on to the next element.                                   */
-        /* The casts are somewhat funky, but they compile down to no-ops and  */
-        /* they tell compilers and static analyzers that we know what we do   */
-        if (nx > 1) {
-            *x = coord.xyzt.x;
-            x = (double *)((void *)(((char *)x) + sx));
-        }
-        if (ny > 1) {
-            *y = coord.xyzt.y;
-            y = (double *)((void *)(((char *)y) + sy));
-        }
-        if (nz > 1) {
-            *z = coord.xyzt.z;
-            z = (double *)((void *)(((char *)z) + sz));
+    /* Note that proj_trans() below reverts again the direction if
+     * P->inverted, and the batch path must do the same */
+    const PJ_DIRECTION batchDirection =
+        P->inverted ? pj_opposite_direction(direction) : direction;
+    if (pj_can_trans_batch(P, batchDirection)) {
+        /* Gather blocks of coordinates, transform them at once, and scatter
+         * them back */
+        PJ_COORD block[BATCH_SIZE];
+        for (i = 0; i < nmin;) {
+            const size_t nBlock = std::min(BATCH_SIZE, nmin - i);
+            double *xb = x, *yb = y, *zb = z, *tb = t;
+            for (size_t j = 0; j < nBlock; j++) {
+                block[j].xyzt.x = *xb;
+                block[j].xyzt.y = *yb;
+                block[j].xyzt.z = *zb;
+                block[j].xyzt.t = *tb;
+                if (nx > 1)
+                    xb = (double *)((void *)(((char *)xb) + sx));
+                if (ny > 1)
+                    yb = (double *)((void *)(((char *)yb) + sy));
+                if (nz > 1)
+                    zb = (double *)((void *)(((char *)zb) + sz));
+                if (nt > 1)
+                    tb = (double *)((void *)(((char *)tb) + st));
+            }
+
+            pj_trans_batch(P, batchDirection, nBlock, block, nullptr);
+
+            for (size_t j = 0; j < nBlock; j++) {
+                coord = block[j];
+                if (nx > 1) {
+                    *x = coord.xyzt.x;
+                    x = (double *)((void *)(((char *)x) + sx));
+                }
+                if (ny > 1) {
+                    *y = coord.xyzt.y;
+                    y = (double *)((void *)(((char *)y) + sy));
+                }
+                if (nz > 1) {
+                    *z = coord.xyzt.z;
+                    z = (double *)((void *)(((char *)z) + sz));
+                }
+                if (nt > 1) {
+                    *t = coord.xyzt.t;
+                    t = (double *)((void *)(((char *)t) + st));
+                }
+            }
+            i += nBlock;
         }
-        if (nt > 1) {
-            *t = coord.xyzt.t;
-            t = (double *)((void *)(((char *)t) + st));
+    } else {
+        for (i = 0; i < nmin; i++) {
+            coord.xyzt.x = *x;
+            coord.xyzt.y = *y;
+            coord.xyzt.z = *z;
+            coord.xyzt.t = *t;
+
+            coord = proj_trans(P, direction, coord);
+
+            /* in all full length cases, we overwrite the input with the output,  */
+            /* and step on to the next element.                                   */
+            /* The casts are somewhat funky, but they compile down to no-ops and  */
+            /* they tell compilers and static analyzers that we know what we do   */
+            if (nx > 1) {
+                *x = coord.xyzt.x;
+                x = (double *)((void *)(((char *)x) + sx));
+            }
+            if (ny > 1) {
+                *y = coord.xyzt.y;
+                y = (double *)((void *)(((char *)y) + sy));
+            }
+            if (nz > 1) {
+                *z = coord.xyzt.z;
+                z = (double *)((void *)(((char *)z) + sz));
+            }
+            if (nt > 1) {
+                *t = coord.xyzt.t;
+                t = (double *)((void *)(((char *)t) + st));
+            }
         }
     }
 
@@ -579,6 +1044,383 @@ size_t proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x, size_t sx,
     return i;
 }
 
+/*************************************************************************************/
+size_t proj_trans_generic_mt(PJ *P, PJ_DIRECTION direction, double *x,
+                             size_t sx, size_t nx, double *y, size_t sy,
+                             size_t ny, double *z, size_t sz, size_t nz,
+                             double *t, size_t st, size_t nt,
+                             int thread_count) {
+    /**************************************************************************************
+
+        Same as proj_trans_generic(), but splits the work between up to
+    thread_count threads (or the number of hardware threads if thread_count
+    is 0). The calling thread processes the first chunk with P, and each of
+    the other threads a chunk with its own clone of P, attached to its own
+    clone of the context of P.
+
+        The transformed values, the error state of the context of P and the
+    operation returned by proj_trans_get_last_used_operation() are the same
+    as the ones proj_trans_generic() would give. Note however that the
+    logging callback of the context may be called from any of those threads.
+
+    **************************************************************************************/
+    constexpr size_t MIN_POINTS_PER_THREAD = 4096;
+
+    if (nullptr == P)
+        return 0;
+
+    const auto serial = [&]() {
+        return proj_trans_generic(P, direction, x, sx, nx, y, sy, ny, z, sz,
+                                  nz, t, st, nt);
+    };
+
+    if (nullptr == x)
+        nx = 0;
+    if (nullptr == y)
+        ny = 0;
+    if (nullptr == z)
+        nz = 0;
+    if (nullptr == t)
+        nt = 0;
+    size_t nmin = std::numeric_limits<size_t>::max();
+    for (size_t n : {nx, ny, nz, nt}) {
+        if (n > 1)
+            nmin = std::min(nmin, n);
+    }
+
+#ifdef __MINGW32__
+    // std::thread is not available with all MinGW toolchains
+    thread_count = 1;
+#else
+    if (thread_count <= 0)
+        thread_count = static_cast<int>(std::thread::hardware_concurrency());
+#endif
+    if (direction == PJ_IDENT || nmin == std::numeric_limits<size_t>::max() ||
+        thread_count <= 1 || nmin < 2 * MIN_POINTS_PER_THREAD) {
+        return serial();
+    }
+    const size_t nChunks = std::min(static_cast<size_t>(thread_count),
+                                    nmin / MIN_POINTS_PER_THREAD);
+
+    struct Chunk {
+        PJ_CONTEXT *ctx = nullptr;
+        PJ *pj = nullptr;
+        size_t start = 0;
+        size_t count = 0;
+        // Private copies of the length 1 (constant) arrays, since
+        // proj_trans_generic() updates them in place.
+        double constants[4] = {0, 0, 0, 0};
+        size_t processed = 0;
+    };
+    std::vector<Chunk> chunks(nChunks);
+
+    const auto cleanup = [&chunks]() {
+        for (auto &chunk : chunks) {
+            proj_destroy(chunk.pj);
+            chunk.pj = nullptr;
+            if (chunk.ctx)
+                proj_context_destroy(chunk.ctx);
+            chunk.ctx = nullptr;
+        }
+    };
+
+    // Errno value used to detect if a chunk has changed the error state, in
+    // which case the serial path would also have changed it at that point.
+    constexpr int ERRNO_UNCHANGED = std::numeric_limits<int>::min();
+
+    double *const arrays[4] = {x, y, z, t};
+    const size_t counts[4] = {nx, ny, nz, nt};
+    for (size_t i = 0; i < nChunks; ++i) {
+        auto &chunk = chunks[i];
+        chunk.start = nmin / nChunks * i;
+        chunk.count =
+            (i + 1 == nChunks) ? nmin - chunk.start : nmin / nChunks;
+        for (int j = 0; j < 4; ++j) {
+            if (counts[j] == 1)
+                chunk.constants[j] = *arrays[j];
+        }
+        if (i == 0) {
+            chunk.pj = P;
+            continue;
+        }
+        chunk.ctx = proj_context_clone(P->ctx);
+        if (chunk.ctx)
+            chunk.pj = proj_clone(chunk.ctx, P);
+        if (!chunk.pj || chunk.pj->inverted != P->inverted) {
+            // Not all objects can be cloned: fallback to the serial path
+            chunks[0].pj = nullptr;
+            cleanup();
+            return serial();
+        }
+        chunk.pj->iCurCoordOp = P->iCurCoordOp;
+        proj_context_errno_set(chunk.ctx, ERRNO_UNCHANGED);
+    }
+
+    const size_t strides[4] = {sx, sy, sz, st};
+    const auto runChunk = [&](Chunk &chunk) {
+        double *ptrs[4];
+        size_t ns[4];
+        for (int j = 0; j < 4; ++j) {
+            if (counts[j] > 1) {
+                ptrs[j] = reinterpret_cast<double *>(
+                    reinterpret_cast<char *>(arrays[j]) +
+                    chunk.start * strides[j]);
+                ns[j] = chunk.count;
+            } else if (counts[j] == 1) {
+                ptrs[j] = &chunk.constants[j];
+                ns[j] = 1;
+            } else {
+                ptrs[j] = nullptr;
+                ns[j] = 0;
+            }
+        }
+        chunk.processed = proj_trans_generic(
+            chunk.pj, direction, ptrs[0], strides[0], ns[0], ptrs[1],
+            strides[1], ns[1], ptrs[2], strides[2], ns[2], ptrs[3], strides[3],
+            ns[3]);
+    };
+
+#ifndef __MINGW32__
+    std::vector<std::thread> threads;
+    threads.reserve(nChunks - 1);
+    for (size_t i = 1; i < nChunks; ++i) {
+        try {
+            threads.emplace_back(runChunk, std::ref(chunks[i]));
+        } catch (const std::exception &) {
+            runChunk(chunks[i]);
+        }
+    }
+    runChunk(chunks[0]);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+#else
+    for (auto &chunk : chunks) {
+        runChunk(chunk);
+    }
+#endif
+
+    size_t processed = 0;
+    for (size_t i = 0; i < nChunks; ++i) {
+        const auto &chunk = chunks[i];
+        processed += chunk.processed;
+        if (i == 0)
+            continue;
+        const int chunkErrno = proj_context_errno(chunk.ctx);
+        if (chunkErrno != ERRNO_UNCHANGED)
+            proj_context_errno_set(P->ctx, chunkErrno);
+        if (!chunk.pj->warnIfBestTransformationNotAvailable)
+            P->warnIfBestTransformationNotAvailable = false;
+    }
+    P->iCurCoordOp = chunks.back().pj->iCurCoordOp;
+
+    // As proj_trans_generic(), update the length 1 arrays with their last
+    // transformed value
+    for (int j = 0; j < 4; ++j) {
+        if (counts[j] == 1)
+            *arrays[j] = chunks.back().constants[j];
+    }
+
+    chunks[0].pj = nullptr;
+    cleanup();
+    return processed;
+}
+
+/*************************************************************************************/
+PJ_COMPILED_TRANSFORMATION *proj_trans_compile(PJ *P) {
+    /**************************************************************************************
+
+        Create a compiled transformation from P, which any number of threads
+    can then run at the same time, each through its own handle created with
+    proj_trans_handle_create(). P is left untouched and can be destroyed once
+    the compiled transformation is created.
+
+        The compiled transformation is a clone of P, on a private clone of
+    its context, whose grids are all opened when it is created. Networking
+    is disabled in that context, so that the grids are local files.
+
+        Return nullptr, and set the error state of the context of P, if P
+    cannot be cloned (see proj_clone()), or if it uses operations that
+    change their own state while transforming (tinshift, defmodel).
+
+    **************************************************************************************/
+    if (nullptr == P)
+        return nullptr;
+
+    try {
+        auto state = std::make_shared<PJCompiledTransformationState>();
+        state->ctx = proj_context_clone(P->ctx);
+        if (state->ctx) {
+            // Grids are opened and read from local files only, as downloading
+            // them, or opening them on first use, would change shared objects
+            proj_context_set_enable_network(state->ctx, false);
+            state->ctx->gridReadAheadThreads = 0;
+            state->ctx->eager_grid_opening = true;
+            state->pj = proj_clone(state->ctx, P);
+        }
+        if (state->pj == nullptr || state->pj->inverted != P->inverted) {
+            proj_log_error(P, _("Object cannot be compiled"));
+            proj_errno_set(P, PROJ_ERR_OTHER_API_MISUSE);
+            return nullptr;
+        }
+
+        PJ *pj = state->pj;
+        bool shareable = pj->shareableBetweenThreads;
+        for (const auto &alt : pj->alternativeCoordinateOperations) {
+            shareable = shareable && alt.pj->shareableBetweenThreads;
+        }
+        if (!shareable) {
+            proj_log_error(P, _("Object cannot be shared between threads"));
+            proj_errno_set(P, PROJ_ERR_OTHER_API_MISUSE);
+            return nullptr;
+        }
+
+        // Compute what proj_trans() would otherwise compute, and cache in the
+        // alternative operations, when it first uses them
+        NS_PROJ::io::DatabaseContextPtr dbContext;
+        try {
+            if (state->ctx->cpp_context) {
+                dbContext = state->ctx->cpp_context->getDatabaseContext()
+                                .as_nullable();
+            }
+        } catch (const std::exception &) {
+        }
+        const bool needsMissingGridMessages =
+            pj->errorIfBestTransformationNotAvailable ||
+            pj->warnIfBestTransformationNotAvailable;
+        for (const auto &alt : pj->alternativeCoordinateOperations) {
+            alt.isInstantiable();
+            auto coordOperation =
+                dynamic_cast<NS_PROJ::operation::CoordinateOperation *>(
+                    alt.pj->iso_obj.get());
+            state->alternativeNeedsNoGrid.push_back(
+                coordOperation &&
+                coordOperation->gridsNeeded(dbContext, true).empty());
+            state->alternativeMissingGridMessages.push_back(
+                needsMissingGridMessages ? pj_missing_grid_message(alt.pj)
+                                         : std::string());
+        }
+        pj->iCurCoordOp = P->iCurCoordOp;
+
+        auto compiled = new PJ_COMPILED_TRANSFORMATION();
+        compiled->state = std::move(state);
+        return compiled;
+    } catch (const std::exception &e) {
+        proj_log_error(P, "%s", e.what());
+        proj_errno_set(P, PROJ_ERR_OTHER);
+        return nullptr;
+    }
+}
+
+/*************************************************************************************/
+void proj_trans_compiled_destroy(PJ_COMPILED_TRANSFORMATION *compiled) {
+    /**************************************************************************************
+
+        Destroy a compiled transformation. Handles created from it remain
+    valid, as they share its state.
+
+    **************************************************************************************/
+    delete compiled;
+}
+
+/*************************************************************************************/
+PJ_TRANS_HANDLE *
+proj_trans_handle_create(PJ_COMPILED_TRANSFORMATION *compiled) {
+    /**************************************************************************************
+
+        Create a handle to run a compiled transformation from one thread.
+    Several threads may create handles from the same compiled transformation
+    at the same time. A handle holds the state that running the
+    transformation changes (error state, operation last used among
+    alternative ones, last grid lines or blocks read, grid lookup hints), so
+    that the compiled transformation itself is only read.
+
+    **************************************************************************************/
+    if (nullptr == compiled)
+        return nullptr;
+
+    auto handle = new (std::nothrow) PJ_TRANS_HANDLE();
+    if (!handle)
+        return nullptr;
+    const auto &state = compiled->state;
+    handle->compiled = state;
+    handle->pj = state->pj;
+    handle->ctx = state->ctx;
+    handle->iCurCoordOp = state->pj->iCurCoordOp;
+    handle->warnIfBestTransformationNotAvailable =
+        state->pj->warnIfBestTransformationNotAvailable;
+    return handle;
+}
+
+/*************************************************************************************/
+void proj_trans_handle_destroy(PJ_TRANS_HANDLE *handle) {
+    /**************************************************************************************
+
+        Destroy a handle. The compiled transformation is destroyed with its
+    last handle, if proj_trans_compiled_destroy() has been called.
+
+    **************************************************************************************/
+    delete handle;
+}
+
+/*************************************************************************************/
+PJ_COORD proj_trans_with_handle(PJ_TRANS_HANDLE *handle, PJ_DIRECTION direction,
+                                PJ_COORD coord) {
+    /**************************************************************************************
+
+        Same as proj_trans(), with the compiled transformation of the handle.
+    Errors are reported by proj_trans_handle_errno().
+
+    **************************************************************************************/
+    if (nullptr == handle)
+        return proj_coord_error();
+    PJTransHandleScope scope(handle);
+    handle->last_errno = 0;
+    try {
+        return proj_trans(handle->pj, direction, coord);
+    } catch (const std::exception &e) {
+        pj_log(handle->ctx, PJ_LOG_ERROR, "%s", e.what());
+        handle->last_errno = PROJ_ERR_OTHER;
+        return proj_coord_error();
+    }
+}
+
+/*************************************************************************************/
+int proj_trans_array_with_handle(PJ_TRANS_HANDLE *handle,
+                                 PJ_DIRECTION direction, size_t n,
+                                 PJ_COORD *coord) {
+    /**************************************************************************************
+
+        Same as proj_trans_array(), with the compiled transformation of the
+    handle.
+
+    **************************************************************************************/
+    if (nullptr == handle)
+        return PROJ_ERR_OTHER_API_MISUSE;
+    PJTransHandleScope scope(handle);
+    handle->last_errno = 0;
+    try {
+        return proj_trans_array(handle->pj, direction, n, coord);
+    } catch (const std::exception &e) {
+        pj_log(handle->ctx, PJ_LOG_ERROR, "%s", e.what());
+        handle->last_errno = PROJ_ERR_OTHER;
+        return PROJ_ERR_OTHER;
+    }
+}
+
+/*************************************************************************************/
+int proj_trans_handle_errno(const PJ_TRANS_HANDLE *handle) {
+    /**************************************************************************************
+
+        Error state of the last call to proj_trans_with_handle() or
+    proj_trans_array_with_handle() with the handle.
+
+    **************************************************************************************/
+    if (nullptr == handle)
+        return 0;
+    return handle->last_errno;
+}
+
 static bool inline coord_is_all_nans(PJ_COORD coo) {
     return std::isnan(coo.v[0]) && std::isnan(coo.v[1]) &&
            std::isnan(coo.v[2]) && std::isnan(coo.v[3]);
@@ -27,13 +27,20 @@
  *****************************************************************************/
 
 #define FROM_PROJ_CPP
+#define LRU11_DO_NOT_DEFINE_OUT_OF_CLASS_METHODS
 
 #include "proj.h"
 #include "proj_internal.h"
 #include <math.h>
 
 #include <algorithm>
+#include <cmath>
+#include <initializer_list>
 #include <limits>
+#include <string>
+#include <vector>
+
+#include "proj/internal/lru_cache.hpp"
 
 // ---------------------------------------------------------------------------
 static double simple_min(const double *data, const int arr_len) {
@@ -330,6 +337,177 @@ static int target_crs_lon_lat_order(PJ_CONTEXT *transformer_ctx,
 
 // ---------------------------------------------------------------------------
 
+/* Results of proj_trans_bounds_adaptive() for a PJ object, keyed by its
+ * arguments, as it is often called repeatedly with the same
+ * bounds (e.g. for the tiles of a map server). The error status left by the
+ * computation is stored with the bounds, so that it is set again on a hit. */
+struct PJTransBoundsCache {
+    struct Result {
+        double bounds[4];
+        int err;
+    };
+    static constexpr size_t CACHE_SIZE = 64;
+    NS_PROJ::lru11::Cache<std::string, Result, NS_PROJ::lru11::NullLock>
+        cache{CACHE_SIZE};
+};
+
+// ---------------------------------------------------------------------------
+
+static std::string trans_bounds_cache_key(PJ_DIRECTION direction,
+                                          std::initializer_list<double> args) {
+    std::string key(reinterpret_cast<const char *>(&direction),
+                    sizeof(direction));
+    for (const double arg : args) {
+        key.append(reinterpret_cast<const char *>(&arg), sizeof(arg));
+    }
+    return key;
+}
+
+// ---------------------------------------------------------------------------
+
+static bool trans_bounds_get_from_cache(PJ *P, const std::string &key,
+                                        double *out_xmin, double *out_ymin,
+                                        double *out_xmax, double *out_ymax) {
+    if (!P->transBoundsCache)
+        return false;
+    PJTransBoundsCache::Result result;
+    if (!P->transBoundsCache->cache.tryGet(key, result))
+        return false;
+    *out_xmin = result.bounds[0];
+    *out_ymin = result.bounds[1];
+    *out_xmax = result.bounds[2];
+    *out_ymax = result.bounds[3];
+    // Same error status as after the computation
+    if (proj_errno(P) == 0)
+        proj_errno_set(P, result.err);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static void trans_bounds_insert_into_cache(PJ *P, const std::string &key,
+                                           double xmin, double ymin,
+                                           double xmax, double ymax, int err) {
+    if (!P->transBoundsCache)
+        P->transBoundsCache = std::make_shared<PJTransBoundsCache>();
+    P->transBoundsCache->cache.insert(key, {{xmin, ymin, xmax, ymax}, err});
+}
+
+// ---------------------------------------------------------------------------
+
+// Characteristics of the input and output of the transformation of a
+// boundary, common to the proj_trans_bounds() family of functions
+struct TransBoundsSetup {
+    bool degree_input = false;
+    bool degree_output = false;
+    bool input_lon_lat_order = false;
+    bool output_lon_lat_order = false;
+    bool north_pole_in_bounds = false;
+    bool south_pole_in_bounds = false;
+    // Length of the edges along the first and second axis, taking into
+    // account a crossing of the antimeridian
+    double x_span = 0;
+    double y_span = 0;
+};
+
+// ---------------------------------------------------------------------------
+
+// Completes setup, whose degree_input and degree_output members must have
+// been set by the caller. Returns false (and sets the error) if the bounds or
+// the transformation are not valid
+static bool trans_bounds_setup(PJ_CONTEXT *context, PJ *P,
+                               PJ_DIRECTION direction, const double xmin,
+                               const double ymin, const double xmax,
+                               const double ymax, TransBoundsSetup &setup) {
+    if (setup.degree_input) {
+        int in_order_lon_lat = target_crs_lon_lat_order(
+            context, P, pj_opposite_direction(direction));
+        if (in_order_lon_lat == -1)
+            return false;
+        setup.input_lon_lat_order = in_order_lon_lat != 0;
+    }
+    if (setup.degree_output) {
+        int out_order_lon_lat = target_crs_lon_lat_order(context, P, direction);
+        if (out_order_lon_lat == -1)
+            return false;
+        setup.output_lon_lat_order = out_order_lon_lat != 0;
+        setup.north_pole_in_bounds = contains_north_pole(
+            P, direction, xmin, ymin, xmax, ymax, setup.output_lon_lat_order);
+        setup.south_pole_in_bounds = contains_south_pole(
+            P, direction, xmin, ymin, xmax, ymax, setup.output_lon_lat_order);
+    }
+
+    if (setup.degree_input && xmax < xmin) {
+        if (!setup.input_lon_lat_order) {
+            proj_log_error(P, _("latitude max < latitude min."));
+            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+            return false;
+        }
+        // handle antimeridian
+        setup.x_span = xmax - xmin + 360.0;
+    } else {
+        setup.x_span = xmax - xmin;
+    }
+    if (setup.degree_input && ymax < ymin) {
+        if (setup.input_lon_lat_order) {
+            proj_log_error(P, _("latitude max < latitude min."));
+            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+            return false;
+        }
+        // handle antimeridian
+        setup.y_span = ymax - ymin + 360.0;
+    } else {
+        setup.y_span = ymax - ymin;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// Computes the output bounds from a transformed boundary, which must be a
+// linear ring.
+static void trans_bounds_compute_extent(const TransBoundsSetup &setup,
+                                        std::vector<double> &x_boundary_array,
+                                        std::vector<double> &y_boundary_array,
+                                        double *out_xmin, double *out_ymin,
+                                        double *out_xmax, double *out_ymax) {
+    const int boundary_len = static_cast<int>(x_boundary_array.size());
+    if (setup.output_lon_lat_order) {
+        // Use GIS frienly order
+        std::swap(x_boundary_array, y_boundary_array);
+    }
+
+    if (!setup.degree_output) {
+        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
+        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
+        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
+        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
+    } else if (setup.north_pole_in_bounds) {
+        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
+        *out_ymin = -180;
+        *out_xmax = 90;
+        *out_ymax = 180;
+    } else if (setup.south_pole_in_bounds) {
+        *out_xmin = -90;
+        *out_ymin = -180;
+        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
+        *out_ymax = 180;
+    } else {
+        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
+        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
+        *out_ymin = antimeridian_min(y_boundary_array.data(), boundary_len);
+        *out_ymax = antimeridian_max(y_boundary_array.data(), boundary_len);
+    }
+
+    if (setup.output_lon_lat_order) {
+        // Go back to CRS axis order
+        std::swap(*out_xmin, *out_ymin);
+        std::swap(*out_xmax, *out_ymax);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Transform boundary.
  *
  * Transform boundary densifying the edges to account for nonlinear
@@ -409,15 +587,19 @@ int proj_trans_bounds(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
         return true;
     }
 
-    bool degree_output = proj_degree_output(P, direction) != 0;
-    bool degree_input = proj_degree_input(P, direction) != 0;
-    if (degree_output && densify_pts < 2) {
+    TransBoundsSetup setup;
+    setup.degree_output = proj_degree_output(P, direction) != 0;
+    setup.degree_input = proj_degree_input(P, direction) != 0;
+    if (setup.degree_output && densify_pts < 2) {
         proj_log_error(
             P,
             _("densify_pts must be at least 2 if the output is geographic."));
         proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
         return false;
     }
+    if (!trans_bounds_setup(context, P, direction, xmin, ymin, xmax, ymax,
+                            setup))
+        return false;
 
     int side_pts = densify_pts + 1; // add one because we are densifying
     const int boundary_len = side_pts * 4;
@@ -432,52 +614,8 @@ int proj_trans_bounds(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
         proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
         return false;
     }
-    double delta_x = 0;
-    double delta_y = 0;
-    bool north_pole_in_bounds = false;
-    bool south_pole_in_bounds = false;
-    bool input_lon_lat_order = false;
-    bool output_lon_lat_order = false;
-    if (degree_input) {
-        int in_order_lon_lat = target_crs_lon_lat_order(
-            context, P, pj_opposite_direction(direction));
-        if (in_order_lon_lat == -1)
-            return false;
-        input_lon_lat_order = in_order_lon_lat != 0;
-    }
-    if (degree_output) {
-        int out_order_lon_lat = target_crs_lon_lat_order(context, P, direction);
-        if (out_order_lon_lat == -1)
-            return false;
-        output_lon_lat_order = out_order_lon_lat != 0;
-        north_pole_in_bounds = contains_north_pole(
-            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
-        south_pole_in_bounds = contains_south_pole(
-            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
-    }
-
-    if (degree_input && xmax < xmin) {
-        if (!input_lon_lat_order) {
-            proj_log_error(P, _("latitude max < latitude min."));
-            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
-            return false;
-        }
-        // handle antimeridian
-        delta_x = (xmax - xmin + 360.0) / side_pts;
-    } else {
-        delta_x = (xmax - xmin) / side_pts;
-    }
-    if (degree_input && ymax < ymin) {
-        if (input_lon_lat_order) {
-            proj_log_error(P, _("latitude max < latitude min."));
-            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
-            return false;
-        }
-        // handle antimeridian
-        delta_y = (ymax - ymin + 360.0) / side_pts;
-    } else {
-        delta_y = (ymax - ymin) / side_pts;
-    }
+    const double delta_x = setup.x_span / side_pts;
+    const double delta_y = setup.y_span / side_pts;
 
     // build densified bounding box
     // Note: must be a linear ring for antimeridian logic
@@ -499,38 +637,8 @@ int proj_trans_bounds(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
                        boundary_len, y_boundary_array.data(), sizeof(double),
                        boundary_len, nullptr, 0, 0, nullptr, 0, 0);
 
-    if (output_lon_lat_order) {
-        // Use GIS frienly order
-        std::swap(x_boundary_array, y_boundary_array);
-    }
-
-    if (!degree_output) {
-        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
-        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
-        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
-        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
-    } else if (north_pole_in_bounds) {
-        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
-        *out_ymin = -180;
-        *out_xmax = 90;
-        *out_ymax = 180;
-    } else if (south_pole_in_bounds) {
-        *out_xmin = -90;
-        *out_ymin = -180;
-        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
-        *out_ymax = 180;
-    } else {
-        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
-        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
-        *out_ymin = antimeridian_min(y_boundary_array.data(), boundary_len);
-        *out_ymax = antimeridian_max(y_boundary_array.data(), boundary_len);
-    }
-
-    if (output_lon_lat_order) {
-        // Go back to CRS axis order
-        std::swap(*out_xmin, *out_ymin);
-        std::swap(*out_xmax, *out_ymax);
-    }
+    trans_bounds_compute_extent(setup, x_boundary_array, y_boundary_array,
+                                out_xmin, out_ymin, out_xmax, out_ymax);
 
     return true;
 }
@@ -627,8 +735,10 @@ int proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
         return true;
     }
 
-    bool degree_output = proj_degree_output(P, direction) != 0;
-    bool degree_input = proj_degree_input(P, direction) != 0;
+    TransBoundsSetup setup;
+    setup.degree_output = proj_degree_output(P, direction) != 0;
+    setup.degree_input = proj_degree_input(P, direction) != 0;
+    const bool degree_output = setup.degree_output;
     if (degree_output && densify_pts < 2) {
         proj_log_error(
             P,
@@ -636,6 +746,12 @@ int proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
         proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
         return false;
     }
+    if (!trans_bounds_setup(context, P, direction, xmin, ymin, xmax, ymax,
+                            setup))
+        return false;
+    const bool north_pole_in_bounds = setup.north_pole_in_bounds;
+    const bool south_pole_in_bounds = setup.south_pole_in_bounds;
+    const bool output_lon_lat_order = setup.output_lon_lat_order;
 
     int side_pts = densify_pts + 1; // add one because we are densifying
     PJ *input_crs = get_input_crs(context, P, direction);
@@ -655,52 +771,8 @@ int proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
         proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
         return false;
     }
-    double delta_x = 0;
-    double delta_y = 0;
-    bool north_pole_in_bounds = false;
-    bool south_pole_in_bounds = false;
-    bool input_lon_lat_order = false;
-    bool output_lon_lat_order = false;
-    if (degree_input) {
-        int in_order_lon_lat = target_crs_lon_lat_order(
-            context, P, pj_opposite_direction(direction));
-        if (in_order_lon_lat == -1)
-            return false;
-        input_lon_lat_order = in_order_lon_lat != 0;
-    }
-    if (degree_output) {
-        int out_order_lon_lat = target_crs_lon_lat_order(context, P, direction);
-        if (out_order_lon_lat == -1)
-            return false;
-        output_lon_lat_order = out_order_lon_lat != 0;
-        north_pole_in_bounds = contains_north_pole(
-            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
-        south_pole_in_bounds = contains_south_pole(
-            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
-    }
-
-    if (degree_input && xmax < xmin) {
-        if (!input_lon_lat_order) {
-            proj_log_error(P, _("latitude max < latitude min."));
-            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
-            return false;
-        }
-        // handle antimeridian
-        delta_x = (xmax - xmin + 360.0) / side_pts;
-    } else {
-        delta_x = (xmax - xmin) / side_pts;
-    }
-    if (degree_input && ymax < ymin) {
-        if (input_lon_lat_order) {
-            proj_log_error(P, _("latitude max < latitude min."));
-            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
-            return false;
-        }
-        // handle antimeridian
-        delta_y = (ymax - ymin + 360.0) / side_pts;
-    } else {
-        delta_y = (ymax - ymin) / side_pts;
-    }
+    const double delta_x = setup.x_span / side_pts;
+    const double delta_y = setup.y_span / side_pts;
 
     *out_xmin = std::numeric_limits<double>::max();
     *out_ymin = std::numeric_limits<double>::max();
@@ -892,3 +964,259 @@ int proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
 
     return true;
 }
+
+// ---------------------------------------------------------------------------
+/** \brief Transform boundary, densifying the edges only where needed.
+ *
+ * This is similar to proj_trans_bounds(), except that instead of densifying
+ * each edge with a fixed number of points, the edges are recursively split
+ * in halves, and only the segments for which the transformed middle point
+ * differs from the middle of the transformed end points by more than
+ * tolerance are split again. The points of each level of refinement are
+ * transformed at once. This generally needs much less transformations than
+ * proj_trans_bounds() for mostly linear transformations, and more points
+ * where the transformation is strongly non-linear.
+ *
+ * The results are cached in P, so calling it again with the same arguments
+ * and context does not transform any point.
+ *
+ * @param context The PJ_CONTEXT object.
+ * @param P The PJ object representing the transformation.
+ * @param direction The direction of the transformation.
+ * @param xmin Minimum bounding coordinate of the first axis in source CRS
+ *             (target CRS if direction is inverse).
+ * @param ymin Minimum bounding coordinate of the second axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param xmax Maximum bounding coordinate of the first axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param ymax Maximum bounding coordinate of the second axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param out_xmin Minimum bounding coordinate of the first axis in target CRS
+ *             (source CRS if direction is inverse).
+ * @param out_ymin Minimum bounding coordinate of the second axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param out_xmax Maximum bounding coordinate of the first axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param out_ymax Maximum bounding coordinate of the second axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param tolerance Maximum deviation, along each axis and in the units of the
+ *     target CRS (source CRS if direction is inverse), between the
+ *     transformed edges and their approximation by segments. Must be strictly
+ *     positive.
+ * @return an integer. 1 if successful. 0 if failures encountered.
+ * @since 9.6
+ * @see proj_trans_bounds()
+ */
+int proj_trans_bounds_adaptive(PJ_CONTEXT *context, PJ *P,
+                               PJ_DIRECTION direction, const double xmin,
+                               const double ymin, const double xmax,
+                               const double ymax, double *out_xmin,
+                               double *out_ymin, double *out_xmax,
+                               double *out_ymax, const double tolerance) {
+    // Number of segments of each edge before refinement. At least 3 are
+    // needed by the antimeridian logic.
+    constexpr int INITIAL_SIDE_PTS = 4;
+    // Maximum number of times a segment is split
+    constexpr int MAX_REFINEMENT_LEVEL = 10;
+
+    *out_xmin = HUGE_VAL;
+    *out_ymin = HUGE_VAL;
+    *out_xmax = HUGE_VAL;
+    *out_ymax = HUGE_VAL;
+
+    if (P == nullptr) {
+        proj_log_error(P, _("NULL P object not allowed."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (!(tolerance > 0)) {
+        proj_log_error(P, _("tolerance must be strictly positive."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+
+    const auto cacheKey = trans_bounds_cache_key(
+        direction, {xmin, ymin, xmax, ymax, tolerance});
+    if (trans_bounds_get_from_cache(P, cacheKey, out_xmin, out_ymin, out_xmax,
+                                    out_ymax))
+        return true;
+
+    PJ_PROJ_INFO pj_info = proj_pj_info(P);
+    if (pj_info.id == nullptr) {
+        proj_log_error(P, _("NULL transformation not allowed,"));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (strcmp(pj_info.id, "noop") == 0 || direction == PJ_IDENT) {
+        *out_xmin = xmin;
+        *out_xmax = xmax;
+        *out_ymin = ymin;
+        *out_ymax = ymax;
+        return true;
+    }
+
+    TransBoundsSetup setup;
+    setup.degree_output = proj_degree_output(P, direction) != 0;
+    setup.degree_input = proj_degree_input(P, direction) != 0;
+    if (!trans_bounds_setup(context, P, direction, xmin, ymin, xmax, ymax,
+                            setup))
+        return false;
+
+    // Vertices of the boundary, as a linear ring, in input and output CRS,
+    // and whether the segment starting at each vertex must be split.
+    std::vector<double> x_boundary_array;
+    std::vector<double> y_boundary_array;
+    std::vector<double> out_x_boundary_array;
+    std::vector<double> out_y_boundary_array;
+    std::vector<bool> refine_array;
+
+    const double delta_x = setup.x_span / INITIAL_SIDE_PTS;
+    const double delta_y = setup.y_span / INITIAL_SIDE_PTS;
+    x_boundary_array.resize(INITIAL_SIDE_PTS * 4);
+    y_boundary_array.resize(INITIAL_SIDE_PTS * 4);
+    for (int iii = 0; iii < INITIAL_SIDE_PTS; iii++) {
+        // xmin boundary
+        y_boundary_array[iii] = ymax - iii * delta_y;
+        x_boundary_array[iii] = xmin;
+        // ymin boundary
+        y_boundary_array[iii + INITIAL_SIDE_PTS] = ymin;
+        x_boundary_array[iii + INITIAL_SIDE_PTS] = xmin + iii * delta_x;
+        // xmax boundary
+        y_boundary_array[iii + INITIAL_SIDE_PTS * 2] = ymin + iii * delta_y;
+        x_boundary_array[iii + INITIAL_SIDE_PTS * 2] = xmax;
+        // ymax boundary
+        y_boundary_array[iii + INITIAL_SIDE_PTS * 3] = ymax;
+        x_boundary_array[iii + INITIAL_SIDE_PTS * 3] = xmax - iii * delta_x;
+    }
+    out_x_boundary_array = x_boundary_array;
+    out_y_boundary_array = y_boundary_array;
+    const int last_errno = proj_errno_reset(P);
+    proj_trans_generic(P, direction, out_x_boundary_array.data(),
+                       sizeof(double), out_x_boundary_array.size(),
+                       out_y_boundary_array.data(), sizeof(double),
+                       out_y_boundary_array.size(), nullptr, 0, 0, nullptr, 0,
+                       0);
+    refine_array.resize(x_boundary_array.size(), true);
+
+    // Returns the middle of a and b, which are longitudes if is_lon is set.
+    const auto middle = [](double a, double b, bool is_lon) {
+        if (is_lon) {
+            // Segments spanning the antimeridian
+            if (b - a > 180)
+                b -= 360;
+            else if (b - a < -180)
+                b += 360;
+        }
+        return (a + b) / 2;
+    };
+
+    // Returns whether the segment between the transformed points (ax, ay)
+    // and (bx, by), whose middle is transformed to (mx, my), must be split.
+    const bool input_x_is_lon = setup.degree_input && setup.input_lon_lat_order;
+    const bool input_y_is_lon =
+        setup.degree_input && !setup.input_lon_lat_order;
+    const bool output_x_is_lon =
+        setup.degree_output && setup.output_lon_lat_order;
+    const bool output_y_is_lon =
+        setup.degree_output && !setup.output_lon_lat_order;
+    const auto must_split = [&middle, output_x_is_lon, output_y_is_lon,
+                             tolerance](double ax, double ay, double bx,
+                                        double by, double mx, double my) {
+        const bool a_valid = ax != HUGE_VAL && ay != HUGE_VAL;
+        const bool b_valid = bx != HUGE_VAL && by != HUGE_VAL;
+        const bool m_valid = mx != HUGE_VAL && my != HUGE_VAL;
+        if (!a_valid || !b_valid) {
+            // Locate where the transformation starts or stops failing
+            return a_valid || b_valid || m_valid;
+        }
+        if (!m_valid)
+            return true;
+        double error_x = mx - middle(ax, bx, output_x_is_lon);
+        double error_y = my - middle(ay, by, output_y_is_lon);
+        if (output_x_is_lon)
+            error_x = std::remainder(error_x, 360.0);
+        if (output_y_is_lon)
+            error_y = std::remainder(error_y, 360.0);
+        return std::fabs(error_x) > tolerance || std::fabs(error_y) > tolerance;
+    };
+
+    std::vector<double> mid_x_array;
+    std::vector<double> mid_y_array;
+    std::vector<double> mid_out_x_array;
+    std::vector<double> mid_out_y_array;
+    for (int level = 0; level < MAX_REFINEMENT_LEVEL; ++level) {
+        const size_t boundary_len = x_boundary_array.size();
+        mid_x_array.clear();
+        mid_y_array.clear();
+        for (size_t i = 0; i < boundary_len; ++i) {
+            if (!refine_array[i])
+                continue;
+            const size_t j = (i + 1) % boundary_len;
+            mid_x_array.push_back(middle(x_boundary_array[i],
+                                         x_boundary_array[j], input_x_is_lon));
+            mid_y_array.push_back(middle(y_boundary_array[i],
+                                         y_boundary_array[j], input_y_is_lon));
+        }
+        if (mid_x_array.empty())
+            break;
+
+        // Transform all the points of this level at once
+        mid_out_x_array = mid_x_array;
+        mid_out_y_array = mid_y_array;
+        proj_trans_generic(P, direction, mid_out_x_array.data(),
+                           sizeof(double), mid_out_x_array.size(),
+                           mid_out_y_array.data(), sizeof(double),
+                           mid_out_y_array.size(), nullptr, 0, 0, nullptr, 0,
+                           0);
+
+        std::vector<double> new_x_boundary_array;
+        std::vector<double> new_y_boundary_array;
+        std::vector<double> new_out_x_boundary_array;
+        std::vector<double> new_out_y_boundary_array;
+        std::vector<bool> new_refine_array;
+        const size_t new_boundary_len = boundary_len + mid_x_array.size();
+        new_x_boundary_array.reserve(new_boundary_len);
+        new_y_boundary_array.reserve(new_boundary_len);
+        new_out_x_boundary_array.reserve(new_boundary_len);
+        new_out_y_boundary_array.reserve(new_boundary_len);
+        new_refine_array.reserve(new_boundary_len);
+        size_t k = 0;
+        for (size_t i = 0; i < boundary_len; ++i) {
+            new_x_boundary_array.push_back(x_boundary_array[i]);
+            new_y_boundary_array.push_back(y_boundary_array[i]);
+            new_out_x_boundary_array.push_back(out_x_boundary_array[i]);
+            new_out_y_boundary_array.push_back(out_y_boundary_array[i]);
+            if (!refine_array[i]) {
+                new_refine_array.push_back(false);
+                continue;
+            }
+            const size_t j = (i + 1) % boundary_len;
+            const bool split =
+                level + 1 < MAX_REFINEMENT_LEVEL &&
+                must_split(out_x_boundary_array[i], out_y_boundary_array[i],
+                           out_x_boundary_array[j], out_y_boundary_array[j],
+                           mid_out_x_array[k], mid_out_y_array[k]);
+            new_refine_array.push_back(split);
+            new_x_boundary_array.push_back(mid_x_array[k]);
+            new_y_boundary_array.push_back(mid_y_array[k]);
+            new_out_x_boundary_array.push_back(mid_out_x_array[k]);
+            new_out_y_boundary_array.push_back(mid_out_y_array[k]);
+            new_refine_array.push_back(split);
+            ++k;
+        }
+        x_boundary_array = std::move(new_x_boundary_array);
+        y_boundary_array = std::move(new_y_boundary_array);
+        out_x_boundary_array = std::move(new_out_x_boundary_array);
+        out_y_boundary_array = std::move(new_out_y_boundary_array);
+        refine_array = std::move(new_refine_array);
+    }
+
+    trans_bounds_compute_extent(setup, out_x_boundary_array,
+                                out_y_boundary_array, out_xmin, out_ymin,
+                                out_xmax, out_ymax);
+
+    trans_bounds_insert_into_cache(P, cacheKey, *out_xmin, *out_ymin,
+                                   *out_xmax, *out_ymax, proj_errno(P));
+    proj_errno_restore(P, last_errno);
+    return true;
+}
@@ -26,16 +26,19 @@
  *****************************************************************************/
 
 #define PROJ_COMPILATION
+#define LRU11_DO_NOT_DEFINE_OUT_OF_CLASS_METHODS
 
 #include "defmodel.hpp"
 #include "filemanager.hpp"
 #include "grids.hpp"
+#include "proj/internal/lru_cache.hpp"
 #include "proj_internal.h"
 
 #include <assert.h>
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 PROJ_HEAD(defmodel, "Deformation model");
@@ -329,6 +332,12 @@ struct defmodelData {
     defmodelData &operator=(const defmodelData &) = delete;
 };
 
+// Parsed master files of the most recently used deformation models, keyed by
+// file identity (resolved name and size).
+NS_PROJ::lru11::Cache<std::string, std::shared_ptr<const MasterFile>,
+                      std::mutex>
+    gMasterFileCache{8, 0};
+
 } // namespace
 
 static PJ *destructor(PJ *P, int errlev) {
@@ -398,6 +407,9 @@ PJ *PJ_TRANSFORMATION(defmodel, 1) {
     P->opaque = (void *)Q;
     P->destructor = destructor;
     P->reassign_context = reassign_context;
+    // The evaluator caches the grids it opens and the last time function
+    // value
+    P->shareableBetweenThreads = false;
 
     const char *model = pj_param(P->ctx, P->params, "smodel").s;
     if (!model) {
@@ -419,17 +431,31 @@ PJ *PJ_TRANSFORMATION(defmodel, 1) {
         proj_log_error(P, _("File %s too large"), model);
         return destructor(P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
     }
-    file->seek(0);
-    std::string jsonStr;
-    jsonStr.resize(static_cast<size_t>(size));
-    if (file->read(&jsonStr[0], jsonStr.size()) != jsonStr.size()) {
-        proj_log_error(P, _("Cannot read %s"), model);
-        return destructor(P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+
+    const std::string cacheKey = file->contentIdentity();
+    std::shared_ptr<const MasterFile> masterFile;
+    if (!gMasterFileCache.tryGet(cacheKey, masterFile)) {
+        file->seek(0);
+        std::string jsonStr;
+        jsonStr.resize(static_cast<size_t>(size));
+        if (file->read(&jsonStr[0], jsonStr.size()) != jsonStr.size()) {
+            proj_log_error(P, _("Cannot read %s"), model);
+            return destructor(P,
+                              PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+        try {
+            masterFile = MasterFile::parse(jsonStr);
+        } catch (const std::exception &e) {
+            proj_log_error(P, _("invalid model: %s"), e.what());
+            return destructor(P,
+                              PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+        gMasterFileCache.insert(cacheKey, masterFile);
     }
 
     try {
         Q->evaluator.reset(new Evaluator<Grid, GridSet, EvaluatorIface>(
-            MasterFile::parse(jsonStr), Q->evaluatorIface, P->a, P->b));
+            masterFile, Q->evaluatorIface, P->a, P->b));
     } catch (const std::exception &e) {
         proj_log_error(P, _("invalid model: %s"), e.what());
         return destructor(P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
@@ -448,3 +474,7 @@ PJ *PJ_TRANSFORMATION(defmodel, 1) {
 
     return P;
 }
+
+// ---------------------------------------------------------------------------
+
+void pj_clear_defmodel_cache() { gMasterFileCache.clear(); }
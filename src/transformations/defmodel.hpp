@@ -589,8 +589,11 @@ template <class Grid = GridPrototype, class GridSet = GridSetPrototype<>,
           class EvaluatorIface = EvaluatorIfacePrototype<>>
 class Evaluator {
   public:
-    /** Constructor. May throw EvaluatorException */
-    explicit Evaluator(std::unique_ptr<MasterFile> &&model,
+    /** Constructor. May throw EvaluatorException.
+     *
+     * The model is not modified, and can thus be shared with other
+     * evaluators. */
+    explicit Evaluator(std::shared_ptr<const MasterFile> model,
                        EvaluatorIface &iface, double a, double b);
 
     /** Evaluate displacement of a position given by (x,y,z,t) and
@@ -614,7 +617,7 @@ class Evaluator {
     bool isGeographicCRS() const { return mIsGeographicCRS; }
 
   private:
-    std::unique_ptr<MasterFile> mModel;
+    std::shared_ptr<const MasterFile> mModel;
     const double mA;
     const double mB;
     const double mEs;
@@ -723,7 +723,7 @@ inline void DeltaEastingNorthingToLongLat(double cosphi, double de, double dn,
 
 template <class Grid, class GridSet, class EvaluatorIface>
 Evaluator<Grid, GridSet, EvaluatorIface>::Evaluator(
-    std::unique_ptr<MasterFile> &&model, EvaluatorIface &iface, double a,
+    std::shared_ptr<const MasterFile> model, EvaluatorIface &iface, double a,
     double b)
     : mModel(std::move(model)), mA(a), mB(b), mEs(1 - (b * b) / (a * a)),
       mIsHorizontalUnitDegree(mModel->horizontalOffsetUnit() == STR_DEGREE),
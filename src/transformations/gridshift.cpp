@@ -30,13 +30,13 @@
 #endif
 
 #include <errno.h>
-#include <mutex>
 #include <stddef.h>
 #include <string.h>
 #include <time.h>
 
 #include "grids.hpp"
 #include "proj/internal/internal.hpp"
+#include "proj/internal/snapshot_map.hpp"
 #include "proj_internal.h"
 
 #include <algorithm>
@@ -47,9 +47,8 @@
 
 PROJ_HEAD(gridshift, "Generic grid shift");
 
-static std::mutex gMutex{};
 // Map of (name, isProjected)
-static std::map<std::string, bool> gKnownGrids{};
+static NS_PROJ::internal::SnapshotMap<std::string, bool> gKnownGrids{};
 
 using namespace NS_PROJ;
 
@@ -75,6 +74,13 @@ struct GridInfo {
     IXY lastIdxXY = IXY{-1, -1};
 };
 
+// Grid information of a gridshiftData used through a handle of a compiled
+// transformation, which holds it instead of gridshiftData::m_cacheGridInfo
+// as the lookups update the shifts and lastIdxXY.
+struct GridInfoScratch : PJTransHandleScratch {
+    std::map<const GenericShiftGrid *, GridInfo> cacheGridInfo{};
+};
+
 // ---------------------------------------------------------------------------
 
 struct gridshiftData {
@@ -247,8 +253,10 @@ PJ_XYZ gridshiftData::grid_interpolate(PJ_CONTEXT *ctx, const std::string &type,
     val.z = 0;
 
     const bool isProjectedCoord = !grid->extentAndRes().isGeographic;
-    auto iterCache = m_cacheGridInfo.find(grid);
-    if (iterCache == m_cacheGridInfo.end()) {
+    auto scratch = pj_trans_handle_scratch<GridInfoScratch>(ctx, this);
+    auto &cacheGridInfo = scratch ? scratch->cacheGridInfo : m_cacheGridInfo;
+    auto iterCache = cacheGridInfo.find(grid);
+    if (iterCache == cacheGridInfo.end()) {
         bool eastingNorthingOffset = false;
         const auto samplesPerPixel = grid->samplesPerPixel();
         int idxSampleY = -1;
@@ -371,7 +379,7 @@ PJ_XYZ gridshiftData::grid_interpolate(PJ_CONTEXT *ctx, const std::string &type,
             gridInfo.idxSampleXYZ[1] = idxSampleY;
         }
         gridInfo.idxSampleXYZ[2] = idxSampleZ;
-        iterCache = m_cacheGridInfo.emplace(grid, std::move(gridInfo)).first;
+        iterCache = cacheGridInfo.emplace(grid, std::move(gridInfo)).first;
     }
     // cppcheck-suppress derefInvalidIteratorRedundantCheck
     GridInfo &gridInfo = iterCache->second;
@@ -756,17 +764,17 @@ PJ_XYZ gridshiftData::apply(PJ *P, PJ_DIRECTION direction, PJ_XYZ xyz) {
     out.y = HUGE_VAL;
     out.z = HUGE_VAL;
 
-    std::string &type = m_mainGridType;
+    const std::string *type = &m_mainGridType;
     bool bFoundGeog3DOffset = false;
     while (true) {
         GenericShiftGridSet *gridset = nullptr;
-        const GenericShiftGrid *grid = findGrid(type, xyz, gridset);
+        const GenericShiftGrid *grid = findGrid(*type, xyz, gridset);
         if (!grid) {
             if (m_mainGridTypeIsGeographic3DOffset && m_bHasHorizontalOffset) {
                 // If we have a mix of grids with GEOGRAPHIC_3D_OFFSET
                 // and HORIZONTAL_OFFSET+ELLIPSOIDAL_HEIGHT_OFFSET
-                type = sHORIZONTAL_OFFSET;
-                grid = findGrid(type, xyz, gridset);
+                type = &sHORIZONTAL_OFFSET;
+                grid = findGrid(*type, xyz, gridset);
             }
             if (!grid) {
                 proj_context_errno_set(P->ctx,
@@ -784,7 +792,8 @@ PJ_XYZ gridshiftData::apply(PJ *P, PJ_DIRECTION direction, PJ_XYZ xyz) {
         }
         bool shouldRetry = false;
         out = grid_apply_internal(
-            P->ctx, type, !(m_bHasGeographic3DOffset || m_bHasHorizontalOffset),
+            P->ctx, *type,
+            !(m_bHasGeographic3DOffset || m_bHasHorizontalOffset),
             xyz, direction, grid, gridset, shouldRetry);
         if (!shouldRetry) {
             break;
@@ -921,17 +930,12 @@ PJ *PJ_TRANSFORMATION(gridshift, 0) {
     if (!P->ctx->defer_grid_opening ||
         !pj_param(P->ctx, P->params, "tcoord_type").i) {
         const char *gridnames = pj_param(P->ctx, P->params, "sgrids").s;
-        gMutex.lock();
-        const auto iter = gKnownGrids.find(gridnames);
-        isKnownGrid = iter != gKnownGrids.end();
-        if (isKnownGrid) {
-            Q->m_defer_grid_opening = true;
-            isProjectedCoord = iter->second;
-        }
-        gMutex.unlock();
+        isKnownGrid = gKnownGrids.find(gridnames, isProjectedCoord);
     }
 
-    if (P->ctx->defer_grid_opening || isKnownGrid) {
+    // Grids of compiled transformations are opened now, as they are shared
+    if (P->ctx->defer_grid_opening ||
+        (isKnownGrid && !P->ctx->eager_grid_opening)) {
         Q->m_defer_grid_opening = true;
     } else {
         const char *gridnames = pj_param(P->ctx, P->params, "sgrids").s;
@@ -947,9 +951,7 @@ PJ *PJ_TRANSFORMATION(gridshift, 0) {
                 P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
         }
 
-        gMutex.lock();
-        gKnownGrids[gridnames] = isProjectedCoord;
-        gMutex.unlock();
+        gKnownGrids.insert(gridnames, isProjectedCoord);
     }
 
     if (pj_param(P->ctx, P->params, "tinterpolation").i) {
@@ -1023,6 +1025,5 @@ PJ *PJ_TRANSFORMATION(gridshift, 0) {
 // ---------------------------------------------------------------------------
 
 void pj_clear_gridshift_knowngrids_cache() {
-    std::lock_guard<std::mutex> lock(gMutex);
     gKnownGrids.clear();
 }
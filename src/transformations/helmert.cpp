@@ -55,9 +55,6 @@ Last update: 2018-10-26
 PROJ_HEAD(helmert, "3(6)-, 4(8)- and 7(14)-parameter Helmert shift");
 PROJ_HEAD(molobadekas, "Molodensky-Badekas transformation");
 
-static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P);
-static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P);
-
 /***********************************************************************/
 namespace { // anonymous namespace
 struct pj_opaque_helmert {
@@ -82,6 +79,13 @@ struct pj_opaque_helmert {
     int no_rotation, exact, fourparam;
     int is_position_vector; /* 1 = position_vector, 0 = coordinate_frame */
 };
+
+/* Parameters at the observation time of the last coordinate transformed
+ * through a PJ_TRANS_HANDLE, as the ones of the PJ are then shared */
+struct pj_helmert_scratch : PJTransHandleScratch {
+    pj_opaque_helmert params{};
+    bool initialized = false;
+};
 } // anonymous namespace
 
 /* Make the maths of the rotation operations somewhat more readable and textbook
@@ -99,7 +103,7 @@ struct pj_opaque_helmert {
 #define R22 (Q->R[2][2])
 
 /**************************************************************************/
-static void update_parameters(PJ *P) {
+static void update_parameters(PJ *P, struct pj_opaque_helmert *Q) {
     /***************************************************************************
 
         Update transformation parameters.
@@ -125,7 +129,6 @@ static void update_parameters(PJ *P) {
 
     *******************************************************************************/
 
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     double dt = Q->t_obs - Q->t_epoch;
 
     Q->xyz.x = Q->xyz_0.x + Q->dxyz.x * dt;
@@ -158,7 +161,7 @@ static void update_parameters(PJ *P) {
 }
 
 /**************************************************************************/
-static void build_rot_matrix(PJ *P) {
+static void build_rot_matrix(PJ *P, struct pj_opaque_helmert *Q) {
     /***************************************************************************
 
         Build rotation matrix.
@@ -225,8 +228,6 @@ static void build_rot_matrix(PJ *P) {
         between the conventions.
 
     ***************************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
-
     double f, t, p;    /* phi/fi , theta, psi  */
     double cf, ct, cp; /* cos (fi, theta, psi) */
     double sf, st, sp; /* sin (fi, theta, psi) */
@@ -321,9 +322,9 @@ static void build_rot_matrix(PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
+static PJ_XY helmert_apply_forward(PJ_LP lp,
+                                   const struct pj_opaque_helmert *Q) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double x, y, cr, sr;
     point.lp = lp;
@@ -340,9 +341,9 @@ static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
+static PJ_LP helmert_apply_reverse(PJ_XY xy,
+                                   const struct pj_opaque_helmert *Q) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double x, y, sr, cr;
     point.xy = xy;
@@ -359,16 +360,16 @@ static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
+static PJ_XYZ helmert_apply_forward_3d(PJ_LPZ lpz,
+                                       const struct pj_opaque_helmert *Q) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double X, Y, Z, scale;
 
     point.lpz = lpz;
 
     if (Q->fourparam) {
-        const auto xy = helmert_forward(point.lp, P);
+        const auto xy = helmert_apply_forward(point.lp, Q);
         point.xy = xy;
         return point.xyz;
     }
@@ -399,16 +400,16 @@ static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
 }
 
 /***********************************************************************/
-static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
+static PJ_LPZ helmert_apply_reverse_3d(PJ_XYZ xyz,
+                                       const struct pj_opaque_helmert *Q) {
     /***********************************************************************/
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
     PJ_COORD point = {{0, 0, 0, 0}};
     double X, Y, Z, scale;
 
     point.xyz = xyz;
 
     if (Q->fourparam) {
-        const auto lp = helmert_reverse(point.xy, P);
+        const auto lp = helmert_apply_reverse(point.xy, Q);
         point.lp = lp;
         return point.lpz;
     }
@@ -435,41 +436,78 @@ static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
     return point.lpz;
 }
 
-static void helmert_forward_4d(PJ_COORD &point, PJ *P) {
+/***********************************************************************/
+static PJ_XY helmert_forward(PJ_LP lp, PJ *P) {
+    /***********************************************************************/
+    return helmert_apply_forward(
+        lp, static_cast<const struct pj_opaque_helmert *>(P->opaque));
+}
+
+/***********************************************************************/
+static PJ_LP helmert_reverse(PJ_XY xy, PJ *P) {
+    /***********************************************************************/
+    return helmert_apply_reverse(
+        xy, static_cast<const struct pj_opaque_helmert *>(P->opaque));
+}
+
+/***********************************************************************/
+static PJ_XYZ helmert_forward_3d(PJ_LPZ lpz, PJ *P) {
+    /***********************************************************************/
+    return helmert_apply_forward_3d(
+        lpz, static_cast<const struct pj_opaque_helmert *>(P->opaque));
+}
+
+/***********************************************************************/
+static PJ_LPZ helmert_reverse_3d(PJ_XYZ xyz, PJ *P) {
+    /***********************************************************************/
+    return helmert_apply_reverse_3d(
+        xyz, static_cast<const struct pj_opaque_helmert *>(P->opaque));
+}
+
+/***********************************************************************/
+static const struct pj_opaque_helmert *
+helmert_parameters_at(const PJ_COORD &point, PJ *P) {
+    /***********************************************************************
+        Return the parameters of P at the observation time of point. They
+        are kept in P, or in the PJ_TRANS_HANDLE running P if any.
+    ***********************************************************************/
     struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
+    if (auto scratch = pj_trans_handle_scratch<pj_helmert_scratch>(P->ctx, Q)) {
+        if (!scratch->initialized) {
+            scratch->params = *Q;
+            scratch->initialized = true;
+        }
+        Q = &scratch->params;
+    }
 
     /* We only need to rebuild the rotation matrix if the
      * observation time is different from the last call */
     double t_obs = (point.xyzt.t == HUGE_VAL) ? Q->t_epoch : point.xyzt.t;
     if (t_obs != Q->t_obs) {
         Q->t_obs = t_obs;
-        update_parameters(P);
-        build_rot_matrix(P);
+        update_parameters(P, Q);
+        build_rot_matrix(P, Q);
     }
+    return Q;
+}
+
+static void helmert_forward_4d(PJ_COORD &point, PJ *P) {
+    const auto Q = helmert_parameters_at(point, P);
 
     // Assigning in 2 steps avoids cppcheck warning
     // "Overlapping read/write of union is undefined behavior"
     // Cf https://github.com/OSGeo/PROJ/pull/3527#pullrequestreview-1233332710
-    const auto xyz = helmert_forward_3d(point.lpz, P);
+    const auto xyz = helmert_apply_forward_3d(point.lpz, Q);
     point.xyz = xyz;
 }
 
 static void helmert_reverse_4d(PJ_COORD &point, PJ *P) {
-    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *)P->opaque;
-
-    /* We only need to rebuild the rotation matrix if the
-     * observation time is different from the last call */
-    double t_obs = (point.xyzt.t == HUGE_VAL) ? Q->t_epoch : point.xyzt.t;
-    if (t_obs != Q->t_obs) {
-        Q->t_obs = t_obs;
-        update_parameters(P);
-        build_rot_matrix(P);
-    }
+    const auto Q = helmert_parameters_at(point, P);
 
     // Assigning in 2 steps avoids cppcheck warning
     // "Overlapping read/write of union is undefined behavior"
     // Cf https://github.com/OSGeo/PROJ/pull/3527#pullrequestreview-1233332710
-    const auto lpz = helmert_reverse_3d(point.xyz, P);
+    const auto lpz = helmert_apply_reverse_3d(point.xyz, Q);
     point.lpz = lpz;
 }
 
@@ -689,8 +727,8 @@ PJ *PJ_TRANSFORMATION(helmert, 0) {
         proj_log_trace(P, "ds= %8.5f  t_epoch=%8.5f", Q->dscale, Q->t_epoch);
     }
 
-    update_parameters(P);
-    build_rot_matrix(P);
+    update_parameters(P, Q);
+    build_rot_matrix(P, Q);
 
     return P;
 }
@@ -754,7 +792,7 @@ PJ *PJ_TRANSFORMATION(molobadekas, 0) {
 
     Q->xyz = Q->xyz_0;
 
-    build_rot_matrix(P);
+    build_rot_matrix(P, Q);
 
     return P;
 }
@@ -1,18 +1,18 @@
 
 
 #include <errno.h>
-#include <mutex>
 #include <stddef.h>
 #include <string.h>
 #include <time.h>
 
 #include "grids.hpp"
+#include "proj/internal/snapshot_map.hpp"
 #include "proj_internal.h"
 
 PROJ_HEAD(hgridshift, "Horizontal grid shift");
 
-static std::mutex gMutexHGridShift{};
-static std::set<std::string> gKnownGridsHGridShift{};
+static NS_PROJ::internal::SnapshotMap<std::string, bool>
+    gKnownGridsHGridShift{};
 
 using namespace NS_PROJ;
 
@@ -186,11 +186,10 @@ PJ *PJ_TRANSFORMATION(hgridshift, 0) {
         Q->defer_grid_opening = true;
     } else {
         const char *gridnames = pj_param(P->ctx, P->params, "sgrids").s;
-        gMutexHGridShift.lock();
-        const bool isKnownGrid = gKnownGridsHGridShift.find(gridnames) !=
-                                 gKnownGridsHGridShift.end();
-        gMutexHGridShift.unlock();
-        if (isKnownGrid) {
+        const bool isKnownGrid = gKnownGridsHGridShift.contains(gridnames);
+        // Grids of compiled transformations are opened now, as they are
+        // shared
+        if (isKnownGrid && !P->ctx->eager_grid_opening) {
             Q->defer_grid_opening = true;
         } else {
             Q->grids = pj_hgrid_init(P, "grids");
@@ -201,9 +200,7 @@ PJ *PJ_TRANSFORMATION(hgridshift, 0) {
                     P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
             }
 
-            gMutexHGridShift.lock();
-            gKnownGridsHGridShift.insert(gridnames);
-            gMutexHGridShift.unlock();
+            gKnownGridsHGridShift.insert(gridnames, true);
         }
     }
 
@@ -211,6 +208,5 @@ PJ *PJ_TRANSFORMATION(hgridshift, 0) {
 }
 
 void pj_clear_hgridshift_knowngrids_cache() {
-    std::lock_guard<std::mutex> lock(gMutexHGridShift);
     gKnownGridsHGridShift.clear();
 }
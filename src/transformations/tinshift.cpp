@@ -26,11 +26,15 @@
  *****************************************************************************/
 
 #define PROJ_COMPILATION
+#define LRU11_DO_NOT_DEFINE_OUT_OF_CLASS_METHODS
 
 #include "tinshift.hpp"
 #include "filemanager.hpp"
+#include "proj/internal/lru_cache.hpp"
 #include "proj_internal.h"
 
+#include <mutex>
+
 PROJ_HEAD(tinshift, "Triangulation based transformation");
 
 using namespace TINSHIFT_NAMESPACE;
@@ -46,6 +50,13 @@ struct tinshiftData {
     tinshiftData &operator=(const tinshiftData &) = delete;
 };
 
+// Evaluators of the most recently opened files, with their spatial indices
+// built, keyed by file identity (resolved name and size). PJ objects use
+// copies of them, which share the file content and the indices.
+NS_PROJ::lru11::Cache<std::string, std::shared_ptr<const Evaluator>,
+                      std::mutex>
+    gEvaluatorCache{8, 0};
+
 } // namespace
 
 static PJ *pj_tinshift_destructor(PJ *P, int errlev) {
@@ -101,31 +112,65 @@ PJ *PJ_TRANSFORMATION(tinshift, 1) {
         return pj_tinshift_destructor(
             P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
     }
-    file->seek(0);
-    std::string jsonStr;
-    try {
-        jsonStr.resize(static_cast<size_t>(size));
-    } catch (const std::bad_alloc &) {
-        proj_log_error(P, _("Cannot read %s. Not enough memory"), filename);
-        return pj_tinshift_destructor(P, PROJ_ERR_OTHER);
-    }
-    if (file->read(&jsonStr[0], jsonStr.size()) != jsonStr.size()) {
-        proj_log_error(P, _("Cannot read %s"), filename);
-        return pj_tinshift_destructor(
-            P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-    }
 
     auto Q = new tinshiftData();
     P->opaque = (void *)Q;
     P->destructor = pj_tinshift_destructor;
-
-    try {
-        Q->evaluator.reset(new Evaluator(TINShiftFile::parse(jsonStr)));
-    } catch (const std::exception &e) {
-        proj_log_error(P, _("invalid model: %s"), e.what());
-        return pj_tinshift_destructor(
-            P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+    // The evaluator keeps the indices of the candidate triangles of the last
+    // lookup
+    P->shareableBetweenThreads = false;
+
+    const std::string cacheKey = file->contentIdentity();
+    std::shared_ptr<const Evaluator> sharedEvaluator;
+    if (!gEvaluatorCache.tryGet(cacheKey, sharedEvaluator)) {
+        // Use the memory-mapped content of the file when available, to
+        // avoid copying binary encoded files.
+        unsigned long long mappedSize = 0;
+        const unsigned char *mappedData = file->mappedData(mappedSize);
+        std::string content;
+        if (mappedData == nullptr || mappedSize != size) {
+            mappedData = nullptr;
+            file->seek(0);
+            try {
+                content.resize(static_cast<size_t>(size));
+            } catch (const std::bad_alloc &) {
+                proj_log_error(P, _("Cannot read %s. Not enough memory"),
+                               filename);
+                return pj_tinshift_destructor(P, PROJ_ERR_OTHER);
+            }
+            if (file->read(&content[0], content.size()) != content.size()) {
+                proj_log_error(P, _("Cannot read %s"), filename);
+                return pj_tinshift_destructor(
+                    P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+            }
+        }
+        const void *data =
+            mappedData ? static_cast<const void *>(mappedData) : content.data();
+
+        try {
+            std::unique_ptr<TINShiftFile> tinshiftFile;
+            if (TINShiftFile::isBinary(data, static_cast<size_t>(size))) {
+                tinshiftFile =
+                    TINShiftFile::parseBinary(data, static_cast<size_t>(size));
+            } else if (mappedData) {
+                tinshiftFile = TINShiftFile::parse(
+                    std::string(static_cast<const char *>(data),
+                                static_cast<size_t>(size)));
+            } else {
+                tinshiftFile = TINShiftFile::parse(content);
+            }
+            auto evaluator = std::make_shared<Evaluator>(
+                std::shared_ptr<const TINShiftFile>(std::move(tinshiftFile)));
+            evaluator->buildSpatialIndices();
+            sharedEvaluator = std::move(evaluator);
+        } catch (const std::exception &e) {
+            proj_log_error(P, _("invalid model: %s"), e.what());
+            return pj_tinshift_destructor(
+                P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+        gEvaluatorCache.insert(cacheKey, sharedEvaluator);
     }
+    Q->evaluator.reset(new Evaluator(*sharedEvaluator));
 
     P->fwd4d = tinshift_forward_4d;
     P->inv4d = tinshift_reverse_4d;
@@ -134,3 +179,7 @@ PJ *PJ_TRANSFORMATION(tinshift, 1) {
 
     return P;
 }
+
+// ---------------------------------------------------------------------------
+
+void pj_clear_tinshift_cache() { gEvaluatorCache.clear(); }
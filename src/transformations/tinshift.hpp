@@ -36,6 +36,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <limits>
@@ -72,6 +74,20 @@ class TINShiftFile {
      */
     static std::unique_ptr<TINShiftFile> parse(const std::string &text);
 
+    /** Return whether the provided content starts with the signature of
+     * the binary encoding of a TINShift file. */
+    static bool isBinary(const void *data, size_t size);
+
+    /** Parse the provided binary encoded content and return an object.
+     *
+     * @throws ParsingException in case of error.
+     */
+    static std::unique_ptr<TINShiftFile> parseBinary(const void *data,
+                                                     size_t size);
+
+    /** Return the binary encoding of this object. */
+    std::string toBinary() const;
+
     /** Get file type. Should always be "triangulation_file" */
     const std::string &fileType() const { return mFileType; }
 
@@ -207,6 +223,9 @@ class TINShiftFile {
   private:
     TINShiftFile() = default;
 
+    void parseMetadata(const json &j);
+    json metadataAsJson() const;
+
     std::string mFileType{};
     std::string mFormatVersion{};
     std::string mName{};
@@ -228,11 +247,16 @@ class TINShiftFile {
 
 // ---------------------------------------------------------------------------
 
-/** Class to evaluate the transformation of a coordinate */
+/** Class to evaluate the transformation of a coordinate.
+ *
+ * Copies of an Evaluator share the file and the spatial indices of the
+ * original object, which are never modified once built. A copy can thus be
+ * used from another thread than the original one.
+ */
 class Evaluator {
   public:
     /** Constructor. */
-    explicit Evaluator(std::unique_ptr<TINShiftFile> &&fileIn);
+    explicit Evaluator(std::shared_ptr<const TINShiftFile> fileIn);
 
     /** Get file */
     const TINShiftFile &file() const { return *(mFile.get()); }
@@ -247,14 +271,26 @@ class Evaluator {
     bool inverse(double x, double y, double z, double &x_out, double &y_out,
                  double &z_out);
 
+    /** Build the spatial indices used by forward() and inverse(), which are
+     * otherwise built on their first invocation. */
+    void buildSpatialIndices();
+
   private:
-    std::unique_ptr<TINShiftFile> mFile;
+    std::shared_ptr<const TINShiftFile> mFile;
 
     // Reused between invocations to save memory allocations
     std::vector<unsigned> mTriangleIndices{};
+    std::vector<std::pair<unsigned, double>> mNearestTriangles{};
 
-    std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>> mQuadTreeForward{};
-    std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>> mQuadTreeInverse{};
+    std::shared_ptr<const NS_PROJ::QuadTree::QuadTree<unsigned>>
+        mQuadTreeForward{};
+    std::shared_ptr<const NS_PROJ::QuadTree::QuadTree<unsigned>>
+        mQuadTreeInverse{};
+
+    bool useForwardQuadTreeForInverse() const {
+        return !mFile->transformHorizontalComponent() &&
+               mFile->transformVerticalComponent();
+    }
 };
 
 // ---------------------------------------------------------------------------
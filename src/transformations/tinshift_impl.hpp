@@ -74,38 +74,28 @@ static json getArrayMember(const json &j, const char *key) {
 
 // ---------------------------------------------------------------------------
 
-std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
-    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
-    json j;
-    try {
-        j = json::parse(text);
-    } catch (const std::exception &e) {
-        throw ParsingException(e.what());
-    }
-    if (!j.is_object()) {
-        throw ParsingException("Not an object");
-    }
-    tinshiftFile->mFileType = getReqString(j, "file_type");
-    tinshiftFile->mFormatVersion = getReqString(j, "format_version");
-    tinshiftFile->mName = getOptString(j, "name");
-    tinshiftFile->mVersion = getOptString(j, "version");
-    tinshiftFile->mLicense = getOptString(j, "license");
-    tinshiftFile->mDescription = getOptString(j, "description");
-    tinshiftFile->mPublicationDate = getOptString(j, "publication_date");
-
-    tinshiftFile->mFallbackStrategy = FALLBACK_NONE;
+void TINShiftFile::parseMetadata(const json &j) {
+    mFileType = getReqString(j, "file_type");
+    mFormatVersion = getReqString(j, "format_version");
+    mName = getOptString(j, "name");
+    mVersion = getOptString(j, "version");
+    mLicense = getOptString(j, "license");
+    mDescription = getOptString(j, "description");
+    mPublicationDate = getOptString(j, "publication_date");
+
+    mFallbackStrategy = FALLBACK_NONE;
     if (j.contains("fallback_strategy")) {
-        if (tinshiftFile->mFormatVersion != "1.1") {
+        if (mFormatVersion != "1.1") {
             throw ParsingException(
                 "fallback_strategy needs format_version 1.1");
         }
         const auto fallback_strategy = getOptString(j, "fallback_strategy");
         if (fallback_strategy == "nearest_side") {
-            tinshiftFile->mFallbackStrategy = FALLBACK_NEAREST_SIDE;
+            mFallbackStrategy = FALLBACK_NEAREST_SIDE;
         } else if (fallback_strategy == "nearest_centroid") {
-            tinshiftFile->mFallbackStrategy = FALLBACK_NEAREST_CENTROID;
+            mFallbackStrategy = FALLBACK_NEAREST_CENTROID;
         } else if (fallback_strategy == "none") {
-            tinshiftFile->mFallbackStrategy = FALLBACK_NONE;
+            mFallbackStrategy = FALLBACK_NONE;
         } else {
             throw ParsingException("invalid fallback_strategy");
         }
@@ -116,10 +106,10 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
         if (!jAuthority.is_object()) {
             throw ParsingException("authority is not a object");
         }
-        tinshiftFile->mAuthority.name = getOptString(jAuthority, "name");
-        tinshiftFile->mAuthority.url = getOptString(jAuthority, "url");
-        tinshiftFile->mAuthority.address = getOptString(jAuthority, "address");
-        tinshiftFile->mAuthority.email = getOptString(jAuthority, "email");
+        mAuthority.name = getOptString(jAuthority, "name");
+        mAuthority.url = getOptString(jAuthority, "url");
+        mAuthority.address = getOptString(jAuthority, "address");
+        mAuthority.email = getOptString(jAuthority, "email");
     }
 
     if (j.contains("links")) {
@@ -136,11 +126,27 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
             link.rel = getOptString(jLink, "rel");
             link.type = getOptString(jLink, "type");
             link.title = getOptString(jLink, "title");
-            tinshiftFile->mLinks.emplace_back(std::move(link));
+            mLinks.emplace_back(std::move(link));
         }
     }
-    tinshiftFile->mInputCRS = getOptString(j, "input_crs");
-    tinshiftFile->mOutputCRS = getOptString(j, "output_crs");
+    mInputCRS = getOptString(j, "input_crs");
+    mOutputCRS = getOptString(j, "output_crs");
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
+    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
+    json j;
+    try {
+        j = json::parse(text);
+    } catch (const std::exception &e) {
+        throw ParsingException(e.what());
+    }
+    if (!j.is_object()) {
+        throw ParsingException("Not an object");
+    }
+    tinshiftFile->parseMetadata(j);
 
     const auto jTransformedComponents =
         getArrayMember(j, "transformed_components");
@@ -359,6 +365,235 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
 
 // ---------------------------------------------------------------------------
 
+json TINShiftFile::metadataAsJson() const {
+    json j;
+    j["file_type"] = mFileType;
+    j["format_version"] = mFormatVersion;
+    const auto setIfNotEmpty = [](json &obj, const char *key,
+                                  const std::string &value) {
+        if (!value.empty())
+            obj[key] = value;
+    };
+    setIfNotEmpty(j, "name", mName);
+    setIfNotEmpty(j, "version", mVersion);
+    setIfNotEmpty(j, "license", mLicense);
+    setIfNotEmpty(j, "description", mDescription);
+    setIfNotEmpty(j, "publication_date", mPublicationDate);
+    if (mFallbackStrategy == FALLBACK_NEAREST_SIDE) {
+        j["fallback_strategy"] = "nearest_side";
+    } else if (mFallbackStrategy == FALLBACK_NEAREST_CENTROID) {
+        j["fallback_strategy"] = "nearest_centroid";
+    }
+    json jAuthority = json::object();
+    setIfNotEmpty(jAuthority, "name", mAuthority.name);
+    setIfNotEmpty(jAuthority, "url", mAuthority.url);
+    setIfNotEmpty(jAuthority, "address", mAuthority.address);
+    setIfNotEmpty(jAuthority, "email", mAuthority.email);
+    if (!jAuthority.empty())
+        j["authority"] = jAuthority;
+    if (!mLinks.empty()) {
+        json jLinks = json::array();
+        for (const auto &link : mLinks) {
+            json jLink = json::object();
+            setIfNotEmpty(jLink, "href", link.href);
+            setIfNotEmpty(jLink, "rel", link.rel);
+            setIfNotEmpty(jLink, "type", link.type);
+            setIfNotEmpty(jLink, "title", link.title);
+            jLinks.push_back(jLink);
+        }
+        j["links"] = jLinks;
+    }
+    setIfNotEmpty(j, "input_crs", mInputCRS);
+    setIfNotEmpty(j, "output_crs", mOutputCRS);
+    return j;
+}
+
+// ---------------------------------------------------------------------------
+
+/* Binary encoding of a TINShift file. All values are little-endian.
+ *
+ * Offset  Type       Content
+ * 0       char[8]    Signature "TINSHIFT"
+ * 8       uint32     Version of the encoding (1)
+ * 12      uint32     Flags: 1 = horizontal component transformed,
+ *                           2 = vertical component transformed
+ * 16      uint64     Size in bytes of the metadata (M)
+ * 24      uint64     Number of vertices (V)
+ * 32      uint64     Number of triangles (T)
+ * 40      char[M]    Metadata: JSON object with the members of the JSON
+ *                    encoding, except the transformed_components, vertices
+ *                    and triangles related ones. Padded with zero bytes to a
+ *                    multiple of 8 bytes.
+ * ...     float64[]  V * verticesColumnCount() values, as in vertices()
+ * ...     uint32[]   T * 3 vertex indices, as in triangles()
+ */
+constexpr char BINARY_SIGNATURE[] = {'T', 'I', 'N', 'S', 'H', 'I', 'F', 'T'};
+constexpr uint32_t BINARY_VERSION = 1;
+constexpr size_t BINARY_HEADER_SIZE = 40;
+constexpr uint32_t BINARY_FLAG_HORIZONTAL = 1;
+constexpr uint32_t BINARY_FLAG_VERTICAL = 2;
+
+static bool isLittleEndian() {
+    const uint16_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+static uint64_t readUInt64LE(const unsigned char *p, int nBytes = 8) {
+    uint64_t v = 0;
+    for (int i = nBytes - 1; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static void writeUInt64LE(std::string &out, uint64_t v, int nBytes = 8) {
+    for (int i = 0; i < nBytes; ++i) {
+        out.push_back(static_cast<char>(v & 0xff));
+        v >>= 8;
+    }
+}
+
+static size_t paddedTo8(size_t size) { return (size + 7) & ~size_t(7); }
+
+// ---------------------------------------------------------------------------
+
+bool TINShiftFile::isBinary(const void *data, size_t size) {
+    return size >= sizeof(BINARY_SIGNATURE) &&
+           std::memcmp(data, BINARY_SIGNATURE, sizeof(BINARY_SIGNATURE)) == 0;
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<TINShiftFile> TINShiftFile::parseBinary(const void *data,
+                                                        size_t size) {
+    if (!isBinary(data, size)) {
+        throw ParsingException("Not a binary TINShift file");
+    }
+    if (size < BINARY_HEADER_SIZE) {
+        throw ParsingException("Truncated binary TINShift file");
+    }
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    if (readUInt64LE(bytes + 8, 4) != BINARY_VERSION) {
+        throw ParsingException("Unsupported binary TINShift file version");
+    }
+    const auto flags = static_cast<uint32_t>(readUInt64LE(bytes + 12, 4));
+    const uint64_t metadataSize = readUInt64LE(bytes + 16);
+    const uint64_t vertexCount = readUInt64LE(bytes + 24);
+    const uint64_t triangleCount = readUInt64LE(bytes + 32);
+
+    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
+    tinshiftFile->mTransformHorizontalComponent =
+        (flags & BINARY_FLAG_HORIZONTAL) != 0;
+    tinshiftFile->mTransformVerticalComponent =
+        (flags & BINARY_FLAG_VERTICAL) != 0;
+    tinshiftFile->mVerticesColumnCount = 2;
+    if (tinshiftFile->mTransformHorizontalComponent)
+        tinshiftFile->mVerticesColumnCount += 2;
+    if (tinshiftFile->mTransformVerticalComponent)
+        tinshiftFile->mVerticesColumnCount += 1;
+    const unsigned colCount = tinshiftFile->mVerticesColumnCount;
+
+    // Check sizes while avoiding integer overflows
+    size_t remaining = size - BINARY_HEADER_SIZE;
+    if (metadataSize > remaining || paddedTo8(metadataSize) > remaining) {
+        throw ParsingException("Truncated binary TINShift file");
+    }
+    const size_t metadataOffset = BINARY_HEADER_SIZE;
+    remaining -= paddedTo8(metadataSize);
+    if (vertexCount > remaining / (colCount * sizeof(double))) {
+        throw ParsingException("Truncated binary TINShift file");
+    }
+    const size_t verticesOffset =
+        metadataOffset + paddedTo8(static_cast<size_t>(metadataSize));
+    const size_t valueCount = static_cast<size_t>(vertexCount) * colCount;
+    remaining -= valueCount * sizeof(double);
+    if (triangleCount != remaining / (3 * sizeof(uint32_t)) ||
+        remaining % (3 * sizeof(uint32_t)) != 0) {
+        throw ParsingException("Invalid size for binary TINShift file");
+    }
+    const size_t trianglesOffset = verticesOffset + valueCount * sizeof(double);
+
+    json j;
+    try {
+        j = json::parse(bytes + metadataOffset,
+                        bytes + metadataOffset + metadataSize);
+    } catch (const std::exception &e) {
+        throw ParsingException(e.what());
+    }
+    if (!j.is_object()) {
+        throw ParsingException("Metadata is not an object");
+    }
+    tinshiftFile->parseMetadata(j);
+
+    tinshiftFile->mVertices.resize(valueCount);
+    if (isLittleEndian()) {
+        std::memcpy(tinshiftFile->mVertices.data(), bytes + verticesOffset,
+                    valueCount * sizeof(double));
+    } else {
+        for (size_t i = 0; i < valueCount; ++i) {
+            const uint64_t v =
+                readUInt64LE(bytes + verticesOffset + i * sizeof(double));
+            std::memcpy(&tinshiftFile->mVertices[i], &v, sizeof(double));
+        }
+    }
+
+    const size_t triangleCountSizeT = static_cast<size_t>(triangleCount);
+    tinshiftFile->mTriangles.resize(triangleCountSizeT);
+    const unsigned char *p = bytes + trianglesOffset;
+    for (size_t i = 0; i < triangleCountSizeT; ++i, p += 3 * sizeof(uint32_t)) {
+        auto &vi = tinshiftFile->mTriangles[i];
+        vi.idx1 = static_cast<unsigned>(readUInt64LE(p, 4));
+        vi.idx2 = static_cast<unsigned>(readUInt64LE(p + 4, 4));
+        vi.idx3 = static_cast<unsigned>(readUInt64LE(p + 8, 4));
+        if (vi.idx1 >= vertexCount || vi.idx2 >= vertexCount ||
+            vi.idx3 >= vertexCount) {
+            throw ParsingException("Invalid value for a vertex index");
+        }
+    }
+
+    return tinshiftFile;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string TINShiftFile::toBinary() const {
+    const std::string metadata = metadataAsJson().dump();
+    const size_t vertexCount =
+        mVerticesColumnCount ? mVertices.size() / mVerticesColumnCount : 0;
+
+    std::string out;
+    out.reserve(BINARY_HEADER_SIZE + paddedTo8(metadata.size()) +
+                mVertices.size() * sizeof(double) +
+                mTriangles.size() * 3 * sizeof(uint32_t));
+    out.append(BINARY_SIGNATURE, sizeof(BINARY_SIGNATURE));
+    writeUInt64LE(out, BINARY_VERSION, 4);
+    uint32_t flags = 0;
+    if (mTransformHorizontalComponent)
+        flags |= BINARY_FLAG_HORIZONTAL;
+    if (mTransformVerticalComponent)
+        flags |= BINARY_FLAG_VERTICAL;
+    writeUInt64LE(out, flags, 4);
+    writeUInt64LE(out, metadata.size());
+    writeUInt64LE(out, vertexCount);
+    writeUInt64LE(out, mTriangles.size());
+    out += metadata;
+    out.resize(paddedTo8(out.size()), '\0');
+    for (double v : mVertices) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(double));
+        writeUInt64LE(out, bits);
+    }
+    for (const auto &vi : mTriangles) {
+        writeUInt64LE(out, vi.idx1, 4);
+        writeUInt64LE(out, vi.idx2, 4);
+        writeUInt64LE(out, vi.idx3, 4);
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+
 static NS_PROJ::QuadTree::RectObj GetBounds(const TINShiftFile &file,
                                             bool forward) {
     NS_PROJ::QuadTree::RectObj rect;
@@ -423,11 +658,20 @@ BuildQuadTree(const TINShiftFile &file, bool forward) {
 
 // ---------------------------------------------------------------------------
 
-Evaluator::Evaluator(std::unique_ptr<TINShiftFile> &&fileIn)
+Evaluator::Evaluator(std::shared_ptr<const TINShiftFile> fileIn)
     : mFile(std::move(fileIn)) {}
 
 // ---------------------------------------------------------------------------
 
+void Evaluator::buildSpatialIndices() {
+    if (!mQuadTreeForward)
+        mQuadTreeForward = BuildQuadTree(*(mFile.get()), true);
+    if (!useForwardQuadTreeForInverse() && !mQuadTreeInverse)
+        mQuadTreeInverse = BuildQuadTree(*(mFile.get()), false);
+}
+
+// ---------------------------------------------------------------------------
+
 static inline double sqr(double x) { return x * x; }
 static inline double squared_distance(double x1, double y1, double x2,
                                       double y2) {
@@ -453,8 +697,10 @@ static double distance_point_segment(double x, double y, double x1, double y1,
 static const TINShiftFile::VertexIndices *
 FindTriangle(const TINShiftFile &file,
              const NS_PROJ::QuadTree::QuadTree<unsigned> &quadtree,
-             std::vector<unsigned> &triangleIndices, double x, double y,
-             bool forward, double &lambda1, double &lambda2, double &lambda3) {
+             std::vector<unsigned> &triangleIndices,
+             std::vector<std::pair<unsigned, double>> &nearestTriangles,
+             double x, double y, bool forward, double &lambda1,
+             double &lambda2, double &lambda3) {
 #define USE_QUADTREE
 #ifdef USE_QUADTREE
     triangleIndices.clear();
@@ -497,12 +743,9 @@ FindTriangle(const TINShiftFile &file,
         return nullptr;
     }
     // find triangle with the shortest squared distance
-    //
-    // TODO: extend quadtree to support nearest neighbor search
-    double closest_dist = std::numeric_limits<double>::infinity();
-    double closest_dist2 = std::numeric_limits<double>::infinity();
-    size_t closest_i = 0;
-    for (size_t i = 0; i < triangles.size(); ++i) {
+    const auto fallbackStrategy = file.fallbackStrategy();
+    const auto distance = [&](unsigned i,
+                              const NS_PROJ::QuadTree::RectObj &) -> double {
         const auto &triangle = triangles[i];
         const unsigned i1 = triangle.idx1;
         const unsigned i2 = triangle.idx2;
@@ -514,61 +757,34 @@ FindTriangle(const TINShiftFile &file,
         const double x3 = vertices[i3 * colCount + idxX];
         const double y3 = vertices[i3 * colCount + idxY];
 
-        // don't check this triangle if the query point plusminus the
-        // currently closest found distance is outside the triangle's AABB
-        if (x + closest_dist < std::min(x1, std::min(x2, x3)) ||
-            x - closest_dist > std::max(x1, std::max(x2, x3)) ||
-            y + closest_dist < std::min(y1, std::min(y2, y3)) ||
-            y - closest_dist > std::max(y1, std::max(y2, y3))) {
-            continue;
-        }
-
         double dist12 = squared_distance(x1, y1, x2, y2);
         double dist23 = squared_distance(x2, y2, x3, y3);
         double dist13 = squared_distance(x1, y1, x3, y3);
         if (dist12 < EPS || dist23 < EPS || dist13 < EPS) {
             // do not use degenerate triangles
-            continue;
+            return std::numeric_limits<double>::infinity();
         }
-        double dist2;
-        if (file.fallbackStrategy() == FALLBACK_NEAREST_SIDE) {
+        if (fallbackStrategy == FALLBACK_NEAREST_SIDE) {
             // we don't know whether the points of the triangle are given
             // clockwise or counter-clockwise, so we have to check the distance
             // of the point to all three sides of the triangle
-            dist2 = distance_point_segment(x, y, x1, y1, x2, y2, dist12);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-            dist2 = distance_point_segment(x, y, x2, y2, x3, y3, dist23);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-            dist2 = distance_point_segment(x, y, x1, y1, x3, y3, dist13);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-        } else if (file.fallbackStrategy() == FALLBACK_NEAREST_CENTROID) {
-            double c_x = (x1 + x2 + x3) / 3.0;
-            double c_y = (y1 + y2 + y3) / 3.0;
-            dist2 = squared_distance(x, y, c_x, c_y);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-        }
-    }
-    if (std::isinf(closest_dist)) {
+            return std::min(
+                distance_point_segment(x, y, x1, y1, x2, y2, dist12),
+                std::min(distance_point_segment(x, y, x2, y2, x3, y3, dist23),
+                         distance_point_segment(x, y, x1, y1, x3, y3, dist13)));
+        }
+        // FALLBACK_NEAREST_CENTROID
+        double c_x = (x1 + x2 + x3) / 3.0;
+        double c_y = (y1 + y2 + y3) / 3.0;
+        return squared_distance(x, y, c_x, c_y);
+    };
+    quadtree.searchNearest(x, y, 1, distance, nearestTriangles);
+    if (nearestTriangles.empty()) {
         // nothing was found due to empty triangle list or only degenerate
         // triangles
         return nullptr;
     }
+    const size_t closest_i = nearestTriangles[0].first;
     const auto &triangle = triangles[closest_i];
     const unsigned i1 = triangle.idx1;
     const unsigned i2 = triangle.idx2;
@@ -601,8 +817,8 @@ bool Evaluator::forward(double x, double y, double z, double &x_out,
     double lambda2 = 0.0;
     double lambda3 = 0.0;
     const auto *triangle =
-        FindTriangle(*mFile, *mQuadTreeForward, mTriangleIndices, x, y, true,
-                     lambda1, lambda2, lambda3);
+        FindTriangle(*mFile, *mQuadTreeForward, mTriangleIndices,
+                     mNearestTriangles, x, y, true, lambda1, lambda2, lambda3);
     if (!triangle)
         return false;
     const auto &vertices = mFile->vertices();
@@ -638,9 +854,8 @@ bool Evaluator::forward(double x, double y, double z, double &x_out,
 
 bool Evaluator::inverse(double x, double y, double z, double &x_out,
                         double &y_out, double &z_out) {
-    NS_PROJ::QuadTree::QuadTree<unsigned> *quadtree;
-    if (!mFile->transformHorizontalComponent() &&
-        mFile->transformVerticalComponent()) {
+    const NS_PROJ::QuadTree::QuadTree<unsigned> *quadtree;
+    if (useForwardQuadTreeForInverse()) {
         if (!mQuadTreeForward)
             mQuadTreeForward = BuildQuadTree(*(mFile.get()), true);
         quadtree = mQuadTreeForward.get();
@@ -653,8 +868,9 @@ bool Evaluator::inverse(double x, double y, double z, double &x_out,
     double lambda1 = 0.0;
     double lambda2 = 0.0;
     double lambda3 = 0.0;
-    const auto *triangle = FindTriangle(*mFile, *quadtree, mTriangleIndices, x,
-                                        y, false, lambda1, lambda2, lambda3);
+    const auto *triangle =
+        FindTriangle(*mFile, *quadtree, mTriangleIndices, mNearestTriangles, x,
+                     y, false, lambda1, lambda2, lambda3);
     if (!triangle)
         return false;
     const auto &vertices = mFile->vertices();
@@ -1,18 +1,18 @@
 
 
 #include <errno.h>
-#include <mutex>
 #include <stddef.h>
 #include <string.h>
 #include <time.h>
 
 #include "grids.hpp"
+#include "proj/internal/snapshot_map.hpp"
 #include "proj_internal.h"
 
 PROJ_HEAD(vgridshift, "Vertical grid shift");
 
-static std::mutex gMutexVGridShift{};
-static std::set<std::string> gKnownGridsVGridShift{};
+static NS_PROJ::internal::SnapshotMap<std::string, bool>
+    gKnownGridsVGridShift{};
 
 using namespace NS_PROJ;
 
@@ -212,12 +212,11 @@ PJ *PJ_TRANSFORMATION(vgridshift, 0) {
         Q->defer_grid_opening = true;
     } else {
         const char *gridnames = pj_param(P->ctx, P->params, "sgrids").s;
-        gMutexVGridShift.lock();
-        const bool isKnownGrid = gKnownGridsVGridShift.find(gridnames) !=
-                                 gKnownGridsVGridShift.end();
-        gMutexVGridShift.unlock();
+        const bool isKnownGrid = gKnownGridsVGridShift.contains(gridnames);
 
-        if (isKnownGrid) {
+        // Grids of compiled transformations are opened now, as they are
+        // shared
+        if (isKnownGrid && !P->ctx->eager_grid_opening) {
             Q->defer_grid_opening = true;
         } else {
             /* Build gridlist. P->vgridlist_geoid can be empty if +grids only
@@ -231,9 +230,7 @@ PJ *PJ_TRANSFORMATION(vgridshift, 0) {
                     P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
             }
 
-            gMutexVGridShift.lock();
-            gKnownGridsVGridShift.insert(gridnames);
-            gMutexVGridShift.unlock();
+            gKnownGridsVGridShift.insert(gridnames, true);
         }
     }
 
@@ -251,6 +248,5 @@ PJ *PJ_TRANSFORMATION(vgridshift, 0) {
 }
 
 void pj_clear_vgridshift_knowngrids_cache() {
-    std::lock_guard<std::mutex> lock(gMutexVGridShift);
     gKnownGridsVGridShift.clear();
 }
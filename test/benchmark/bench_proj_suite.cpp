@@ -0,0 +1,502 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark suite covering representative operation families
+ *
+ ******************************************************************************
+ * Copyright (c) 2024, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+// Runs a fixed set of transformations, each over the same pseudo-random
+// points, through the scalar (proj_trans()), batch (proj_trans_generic()) and
+// multithreaded (proj_trans_generic_mt()) APIs, and reports throughputs as a
+// table or as JSON, so that results can be compared between releases.
+//
+// Grids and models are looked up from the PROJ resource path. The test
+// resources of the build tree contain all of them:
+//   PROJ_DATA=build/data/for_tests bench_proj_suite --json
+
+#include "proj.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchCase {
+    const char *name;
+    const char *family;
+    // PROJ string, or source CRS when targetCRS is set
+    const char *definition;
+    const char *targetCRS;
+    // Area of the input points. Longitude/latitude in degrees for geographic
+    // inputs, whatever the axis order of the operation.
+    double xmin, xmax, ymin, ymax;
+    double z;
+    double t;
+    bool usesGrids;
+};
+
+const BenchCase benchCases[] = {
+    {"tmerc_poder_engsager", "tmerc",
+     "+proj=tmerc +algo=poder_engsager +lon_0=3 +k=0.9996 +x_0=500000 "
+     "+ellps=GRS80",
+     nullptr, -3, 9, 0, 80, 0, HUGE_VAL, false},
+    {"tmerc_evenden_snyder", "tmerc",
+     "+proj=tmerc +algo=evenden_snyder +lon_0=3 +k=0.9996 +x_0=500000 "
+     "+ellps=GRS80",
+     nullptr, 0, 6, 0, 80, 0, HUGE_VAL, false},
+    {"utm_crs_to_crs", "tmerc", "EPSG:4326", "EPSG:32631", 0, 6, 0, 80, 0,
+     HUGE_VAL, false},
+    {"lcc", "lcc",
+     "+proj=lcc +lat_1=44 +lat_2=49 +lat_0=46.5 +lon_0=3 +x_0=700000 "
+     "+y_0=6600000 +ellps=GRS80",
+     nullptr, -5, 10, 41, 51, 0, HUGE_VAL, false},
+    {"helmert_7_params", "helmert",
+     "+proj=pipeline +step +proj=cart +ellps=GRS80 "
+     "+step +proj=helmert +x=0.0127 +y=0.0065 +z=-0.0209 +rx=-0.00039 "
+     "+ry=0.00080 +rz=-0.00114 +s=-0.00245 +convention=position_vector "
+     "+step +inv +proj=cart +ellps=GRS80",
+     nullptr, -10, 30, 35, 70, 100, HUGE_VAL, false},
+    {"hgridshift_ntv2", "hgridshift", "+proj=hgridshift +grids=ntv2_0.gsb",
+     nullptr, -95, -70, 45, 55, 0, HUGE_VAL, true},
+    {"hgridshift_gtiff", "hgridshift",
+     "+proj=hgridshift +grids=tests/test_hgrid.tif", nullptr, 4.2, 4.8, 52.2,
+     52.8, 0, HUGE_VAL, true},
+    {"vgridshift_gtx", "vgridshift",
+     "+proj=vgridshift +grids=egm96_15.gtx +multiplier=1", nullptr, -180, 180,
+     -80, 80, 0, HUGE_VAL, true},
+    {"vgridshift_gtiff", "vgridshift",
+     "+proj=vgridshift +grids=tests/test_vgrid_deflate.tif +multiplier=1",
+     nullptr, 4.2, 4.8, 52.2, 52.8, 0, HUGE_VAL, true},
+    {"gridshift_gtiff", "gridshift",
+     "+proj=gridshift "
+     "+grids=tests/us_noaa_nadcon5_nad83_2007_nad83_2011_conus_extract.tif",
+     nullptr, -96, -95, 36.5, 37.5, 10, HUGE_VAL, true},
+    {"tinshift", "tinshift",
+     "+proj=tinshift +file=tests/tinshift_simplified_kkj_etrs.json", nullptr,
+     3208000, 3212000, 6698000, 6702000, 0, HUGE_VAL, false},
+    {"defmodel", "defmodel",
+     "+proj=defmodel +model=tests/simple_model_degree_horizontal.json",
+     nullptr, 2, 3, 49, 50, 30, 2020, true},
+    {"crs_to_crs_nad27_nad83", "crs_to_crs", "EPSG:4267", "EPSG:4269", -120,
+     -75, 30, 48, 0, HUGE_VAL, true},
+};
+
+struct Options {
+    size_t points = 100 * 1000;
+    int repeat = 5;
+    int maxThreads = 0;
+    bool json = false;
+    std::string output{};
+    std::vector<std::string> filters{};
+};
+
+struct Result {
+    std::string caseName{};
+    std::string family{};
+    std::string mode{};
+    int threads = 1;
+    size_t points = 0;
+    double bestSeconds = 0;
+    double meanSeconds = 0;
+    size_t failures = 0;
+};
+
+void usage() {
+    printf("Usage: bench_proj_suite [--points number] [--repeat number]\n");
+    printf("                        [--threads number] [--filter string]*\n");
+    printf("                        [--json] [--output filename] [--list]\n");
+    printf("\n");
+    printf("--points: number of coordinates per run (default 100000)\n");
+    printf("--repeat: number of timed runs per mode, the best one being "
+           "reported (default 5)\n");
+    printf("--threads: maximum number of threads for multithreaded runs "
+           "(default: number of cores)\n");
+    printf("--filter: only run the cases whose name or family contains the "
+           "string. Can be repeated\n");
+    printf("--json: output results as JSON\n");
+    printf("--output: write results to a file instead of stdout\n");
+    printf("--list: list the benchmark cases and exit\n");
+    exit(1);
+}
+
+// Small deterministic generator, so that all runs use the same points
+class Random {
+    uint64_t state_;
+
+  public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+    double next(double minVal, double maxVal) {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return minVal + (maxVal - minVal) * static_cast<double>(state_ >> 11) /
+                            static_cast<double>(1ULL << 53);
+    }
+};
+
+PJ *createOperation(PJ_CONTEXT *ctx, const BenchCase &benchCase) {
+    if (benchCase.targetCRS == nullptr)
+        return proj_create(ctx, benchCase.definition);
+    PJ *P = proj_create_crs_to_crs(ctx, benchCase.definition,
+                                   benchCase.targetCRS, nullptr);
+    if (P == nullptr)
+        return nullptr;
+    PJ *normalized = proj_normalize_for_visualization(ctx, P);
+    proj_destroy(P);
+    return normalized;
+}
+
+std::vector<PJ_COORD> generatePoints(PJ *P, const BenchCase &benchCase,
+                                     size_t count) {
+    const bool radians = proj_angular_input(P, PJ_FWD) != 0;
+    Random random(0x9E3779B97F4A7C15ULL);
+    std::vector<PJ_COORD> points(count);
+    for (auto &coord : points) {
+        coord.v[0] = random.next(benchCase.xmin, benchCase.xmax);
+        coord.v[1] = random.next(benchCase.ymin, benchCase.ymax);
+        coord.v[2] = benchCase.z;
+        coord.v[3] = benchCase.t;
+        if (radians) {
+            coord.v[0] = proj_torad(coord.v[0]);
+            coord.v[1] = proj_torad(coord.v[1]);
+        }
+    }
+    return points;
+}
+
+size_t countFailures(const std::vector<PJ_COORD> &points) {
+    return static_cast<size_t>(
+        std::count_if(points.begin(), points.end(), [](const PJ_COORD &c) {
+            return c.v[0] == HUGE_VAL || std::isnan(c.v[0]);
+        }));
+}
+
+size_t transGeneric(PJ *P, std::vector<PJ_COORD> &points, int threads) {
+    constexpr size_t stride = sizeof(PJ_COORD);
+    const size_t n = points.size();
+    if (threads <= 1) {
+        return proj_trans_generic(P, PJ_FWD, &points[0].v[0], stride, n,
+                                  &points[0].v[1], stride, n, &points[0].v[2],
+                                  stride, n, &points[0].v[3], stride, n);
+    }
+    return proj_trans_generic_mt(P, PJ_FWD, &points[0].v[0], stride, n,
+                                 &points[0].v[1], stride, n, &points[0].v[2],
+                                 stride, n, &points[0].v[3], stride, n,
+                                 threads);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Times `repeat` runs of fn over fresh copies of the input points
+template <class Fn>
+Result timeRuns(const Options &options, const std::vector<PJ_COORD> &input,
+                Fn fn) {
+    Result result;
+    result.points = input.size();
+    std::vector<PJ_COORD> work;
+    double total = 0;
+    for (int i = 0; i < options.repeat; ++i) {
+        work = input;
+        const auto start = Clock::now();
+        fn(work);
+        const double elapsed = secondsSince(start);
+        total += elapsed;
+        if (i == 0 || elapsed < result.bestSeconds)
+            result.bestSeconds = elapsed;
+    }
+    result.meanSeconds = total / options.repeat;
+    result.failures = countFailures(work);
+    return result;
+}
+
+bool runCase(const Options &options, const BenchCase &benchCase,
+             std::vector<Result> &results) {
+    const auto addResult = [&results, &benchCase](Result &&result,
+                                                  const char *mode,
+                                                  int threads) {
+        result.caseName = benchCase.name;
+        result.family = benchCase.family;
+        result.mode = mode;
+        result.threads = threads;
+        results.emplace_back(std::move(result));
+    };
+
+    // Cold: everything, including the creation of the context and the
+    // opening of the database and grids, is done in the timed section.
+    Result cold;
+    cold.points = options.points;
+    std::vector<PJ_COORD> input;
+    for (int i = 0; i < options.repeat; ++i) {
+        proj_cleanup();
+        const auto start = Clock::now();
+        PJ_CONTEXT *ctx = proj_context_create();
+        proj_log_level(ctx, PJ_LOG_NONE);
+        PJ *P = createOperation(ctx, benchCase);
+        if (P == nullptr) {
+            proj_context_destroy(ctx);
+            fprintf(stderr, "%s: cannot create operation, skipped\n",
+                    benchCase.name);
+            return false;
+        }
+        if (input.empty()) {
+            input = generatePoints(P, benchCase, options.points);
+        }
+        std::vector<PJ_COORD> work(input);
+        transGeneric(P, work, 1);
+        const double elapsed = secondsSince(start);
+        proj_destroy(P);
+        proj_context_destroy(ctx);
+        if (i == 0 || elapsed < cold.bestSeconds)
+            cold.bestSeconds = elapsed;
+        cold.meanSeconds += elapsed / options.repeat;
+        cold.failures = countFailures(work);
+    }
+    // Typically a grid in a format not supported by this build
+    if (cold.failures == options.points) {
+        fprintf(stderr, "%s: all points failed, skipped\n", benchCase.name);
+        return false;
+    }
+    addResult(std::move(cold), "cold", 1);
+
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_log_level(ctx, PJ_LOG_NONE);
+    PJ *P = createOperation(ctx, benchCase);
+    if (P == nullptr) {
+        proj_context_destroy(ctx);
+        return false;
+    }
+
+    // Warm up the grid caches
+    {
+        std::vector<PJ_COORD> work(input);
+        transGeneric(P, work, 1);
+    }
+
+    addResult(timeRuns(options, input,
+                       [P](std::vector<PJ_COORD> &points) {
+                           for (auto &coord : points)
+                               coord = proj_trans(P, PJ_FWD, coord);
+                       }),
+              "scalar", 1);
+
+    addResult(timeRuns(options, input,
+                       [P](std::vector<PJ_COORD> &points) {
+                           proj_trans_array(P, PJ_FWD, points.size(),
+                                            points.data());
+                       }),
+              "array", 1);
+
+    addResult(timeRuns(options, input,
+                       [P](std::vector<PJ_COORD> &points) {
+                           transGeneric(P, points, 1);
+                       }),
+              "batch", 1);
+
+    for (int threads = 2; threads <= options.maxThreads; threads *= 2) {
+        addResult(timeRuns(options, input,
+                           [P, threads](std::vector<PJ_COORD> &points) {
+                               transGeneric(P, points, threads);
+                           }),
+                  "multithreaded", threads);
+    }
+
+    if (benchCase.usesGrids) {
+        // Same as batch, but with the process-wide grid cache
+        proj_grid_shared_cache_set_max_size(256 * 1024 * 1024);
+        PJ_CONTEXT *ctxShared = proj_context_create();
+        proj_log_level(ctxShared, PJ_LOG_NONE);
+        PJ *PShared = createOperation(ctxShared, benchCase);
+        if (PShared) {
+            std::vector<PJ_COORD> work(input);
+            transGeneric(PShared, work, 1);
+            addResult(timeRuns(options, input,
+                               [PShared](std::vector<PJ_COORD> &points) {
+                                   transGeneric(PShared, points, 1);
+                               }),
+                      "batch_shared_grid_cache", 1);
+        }
+        proj_destroy(PShared);
+        proj_context_destroy(ctxShared);
+        proj_grid_shared_cache_set_max_size(0);
+        proj_grid_shared_cache_clear();
+    }
+
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+    return true;
+}
+
+bool matchesFilters(const Options &options, const BenchCase &benchCase) {
+    if (options.filters.empty())
+        return true;
+    for (const auto &filter : options.filters) {
+        if (strstr(benchCase.name, filter.c_str()) ||
+            strstr(benchCase.family, filter.c_str())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double throughput(const Result &result) {
+    return result.bestSeconds > 0
+               ? 1e-6 * static_cast<double>(result.points) / result.bestSeconds
+               : 0;
+}
+
+void writeTable(FILE *f, const std::vector<Result> &results) {
+    fprintf(f, "%-26s %-24s %7s %10s %10s %12s %9s\n", "case", "mode",
+            "threads", "best (ms)", "mean (ms)", "Mcoords/s", "failures");
+    for (const auto &result : results) {
+        fprintf(f, "%-26s %-24s %7d %10.2f %10.2f %12.3f %9u\n",
+                result.caseName.c_str(), result.mode.c_str(), result.threads,
+                1e3 * result.bestSeconds, 1e3 * result.meanSeconds,
+                throughput(result), static_cast<unsigned>(result.failures));
+    }
+}
+
+void writeJSON(FILE *f, const Options &options,
+               const std::vector<Result> &results,
+               const std::vector<std::string> &skipped) {
+    const PJ_INFO info = proj_info();
+    fprintf(f, "{\n");
+    fprintf(f, "  \"proj_version\": \"%s\",\n", info.version);
+    fprintf(f, "  \"points\": %u,\n", static_cast<unsigned>(options.points));
+    fprintf(f, "  \"repeat\": %d,\n", options.repeat);
+    fprintf(f, "  \"hardware_concurrency\": %u,\n",
+            std::thread::hardware_concurrency());
+    fprintf(f, "  \"results\": [");
+    bool first = true;
+    for (const auto &result : results) {
+        fprintf(f, "%s\n    {", first ? "" : ",");
+        first = false;
+        fprintf(f, "\"case\": \"%s\", ", result.caseName.c_str());
+        fprintf(f, "\"family\": \"%s\", ", result.family.c_str());
+        fprintf(f, "\"mode\": \"%s\", ", result.mode.c_str());
+        fprintf(f, "\"threads\": %d, ", result.threads);
+        fprintf(f, "\"points\": %u, ", static_cast<unsigned>(result.points));
+        fprintf(f, "\"best_seconds\": %.9g, ", result.bestSeconds);
+        fprintf(f, "\"mean_seconds\": %.9g, ", result.meanSeconds);
+        fprintf(f, "\"million_coords_per_second\": %.6g, ",
+                throughput(result));
+        fprintf(f, "\"failures\": %u}", static_cast<unsigned>(result.failures));
+    }
+    fprintf(f, "\n  ],\n");
+    fprintf(f, "  \"skipped\": [");
+    first = true;
+    for (const auto &name : skipped) {
+        fprintf(f, "%s\"%s\"", first ? "" : ", ", name.c_str());
+        first = false;
+    }
+    fprintf(f, "]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    options.maxThreads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--points") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            options.points = static_cast<size_t>(atol(argv[i + 1]));
+            ++i;
+        } else if (strcmp(argv[i], "--repeat") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            options.repeat = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            options.maxThreads = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--filter") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            options.filters.emplace_back(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--output") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            options.output = argv[i + 1];
+            ++i;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            options.json = true;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (const auto &benchCase : benchCases) {
+                printf("%-26s %-12s %s%s%s\n", benchCase.name,
+                       benchCase.family, benchCase.definition,
+                       benchCase.targetCRS ? " -> " : "",
+                       benchCase.targetCRS ? benchCase.targetCRS : "");
+            }
+            return 0;
+        } else {
+            usage();
+        }
+    }
+    if (options.points == 0 || options.repeat <= 0)
+        usage();
+
+    std::vector<Result> results;
+    std::vector<std::string> skipped;
+    for (const auto &benchCase : benchCases) {
+        if (!matchesFilters(options, benchCase))
+            continue;
+        if (!options.json) {
+            fprintf(stderr, "Running %s...\n", benchCase.name);
+        }
+        if (!runCase(options, benchCase, results))
+            skipped.emplace_back(benchCase.name);
+    }
+
+    FILE *f = stdout;
+    if (!options.output.empty()) {
+        f = fopen(options.output.c_str(), "wb");
+        if (f == nullptr) {
+            fprintf(stderr, "Cannot create %s\n", options.output.c_str());
+            return 1;
+        }
+    }
+    if (options.json)
+        writeJSON(f, options, results, skipped);
+    else
+        writeTable(f, results);
+    if (f != stdout)
+        fclose(f);
+
+    return 0;
+}
@@ -37,6 +37,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -300,6 +301,71 @@ TEST_F(gieTest, proj_create_crs_to_crs) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(gieTest, proj_create_crs_to_crs_spatial_index) {
+    // NAD27 to NAD83 has many alternative operations. Check that selecting
+    // them through the spatial index gives the same result as the linear
+    // scan, which is used when the index is reset.
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269", nullptr);
+    ASSERT_TRUE(P != nullptr);
+    ASSERT_GT(P->alternativeCoordinateOperations.size(), 2U);
+    ASSERT_TRUE(P->alternativeCoordinateOperationsIndex != nullptr);
+
+    auto PClone = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(PClone != nullptr);
+    // The index is immutable, and thus shared by clones
+    EXPECT_EQ(PClone->alternativeCoordinateOperationsIndex,
+              P->alternativeCoordinateOperationsIndex);
+
+    auto PLinear = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269",
+                                          nullptr);
+    ASSERT_TRUE(PLinear != nullptr);
+    PLinear->alternativeCoordinateOperationsIndex.reset();
+
+    const auto check = [&](const PJ_COORD &coord, PJ_DIRECTION dir) {
+        const auto a = proj_trans(P, dir, coord);
+        const int iA = P->iCurCoordOp;
+        const auto b = proj_trans(PLinear, dir, coord);
+        const int iB = PLinear->iCurCoordOp;
+        EXPECT_EQ(iA, iB) << coord.xy.x << " " << coord.xy.y;
+        for (int i = 0; i < 2; ++i) {
+            if (std::isnan(a.v[i]) || std::isnan(b.v[i]))
+                EXPECT_TRUE(std::isnan(a.v[i]) && std::isnan(b.v[i]));
+            else
+                EXPECT_EQ(a.v[i], b.v[i]);
+        }
+    };
+
+    for (double lat = -10; lat <= 90; lat += 1.25) {
+        for (double lon = -200; lon <= -30; lon += 1.5) {
+            for (auto dir : {PJ_FWD, PJ_INV}) {
+                check(proj_coord(lat, lon, 0, 0), dir);
+            }
+        }
+    }
+
+    // Points on the edge of an extent
+    for (const auto &alt : P->alternativeCoordinateOperations) {
+        check(proj_coord(alt.minxSrc, alt.maxySrc, 0, 0), PJ_FWD);
+    }
+
+    // Consecutive points in the same cell reuse the last selected operation,
+    // while the clone, which keeps its own last lookup, alternates directions
+    for (double lon = -100.5; lon <= -99.5; lon += 0.01) {
+        check(proj_coord(40, lon, 0, 0), PJ_FWD);
+        const auto a = proj_trans(PClone, PJ_INV, proj_coord(40, lon, 0, 0));
+        const auto b = proj_trans(PLinear, PJ_INV, proj_coord(40, lon, 0, 0));
+        EXPECT_EQ(PClone->iCurCoordOp, PLinear->iCurCoordOp);
+        EXPECT_EQ(a.xy.x, b.xy.x);
+        EXPECT_EQ(a.xy.y, b.xy.y);
+    }
+
+    proj_destroy(PLinear);
+    proj_destroy(PClone);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(gieTest, proj_create_crs_to_crs_EPSG_4326) {
 
     auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4326", "EPSG:32631",
@@ -1254,6 +1320,146 @@ TEST(gie, proj_trans_generic) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, proj_trans_array_pipeline_same_as_proj_trans) {
+    // Pipelines are transformed block by block through their batch path:
+    // check that it gives the same results, and errors, as proj_trans()
+    auto P = proj_create(
+        PJ_DEFAULT_CTX,
+        "+proj=pipeline +step +proj=axisswap +order=2,1 "
+        "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+        "+step +proj=push +v_3 "
+        "+step +proj=cart +ellps=GRS80 "
+        "+step +proj=helmert +x=10 +y=20 +z=30 "
+        "+step +inv +proj=cart +ellps=WGS84 "
+        "+step +proj=pop +v_3 "
+        "+step +proj=utm +zone=32 +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+
+    constexpr int N = 600;
+    std::vector<PJ_COORD> coords;
+    for (int i = 0; i < N; i++) {
+        if (i == 10 || i == 300)
+            coords.push_back(proj_coord(95, 12, 0, 0)); // invalid latitude
+        else if (i == 20)
+            coords.push_back(proj_coord(NAN, 12, 0, 0));
+        else
+            coords.push_back(proj_coord(50 + i * 0.01, 5 + i * 0.01, i, 0));
+    }
+    std::vector<PJ_COORD> expected;
+    for (const auto &coord : coords)
+        expected.push_back(proj_trans(P, PJ_FWD, coord));
+
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()),
+              PROJ_ERR_COORD_TRANSFM_INVALID_COORD);
+    for (int i = 0; i < N; i++) {
+        if (i == 20) {
+            EXPECT_TRUE(std::isnan(coords[i].xyzt.x));
+            continue;
+        }
+        EXPECT_EQ(coords[i].xyzt.x, expected[i].xyzt.x) << i;
+        EXPECT_EQ(coords[i].xyzt.y, expected[i].xyzt.y) << i;
+        EXPECT_EQ(coords[i].xyzt.z, expected[i].xyzt.z) << i;
+        EXPECT_EQ(coords[i].xyzt.t, expected[i].xyzt.t) << i;
+    }
+
+    // And back with proj_trans_generic()
+    std::vector<double> x, y, z;
+    for (int i = 0; i < N; i++) {
+        x.push_back(expected[i].xyzt.x);
+        y.push_back(expected[i].xyzt.y);
+        z.push_back(expected[i].xyzt.z);
+    }
+    EXPECT_EQ(proj_trans_generic(P, PJ_INV, x.data(), sizeof(double), N,
+                                 y.data(), sizeof(double), N, z.data(),
+                                 sizeof(double), N, nullptr, 0, 0),
+              static_cast<size_t>(N));
+    for (int i = 0; i < N; i++) {
+        if (i == 20)
+            continue;
+        const auto res = proj_trans(P, PJ_INV, expected[i]);
+        EXPECT_EQ(x[i], res.xyzt.x) << i;
+        EXPECT_EQ(y[i], res.xyzt.y) << i;
+        EXPECT_EQ(z[i], res.xyzt.z) << i;
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_tmerc_exact_same_as_proj_trans) {
+    // The exact tmerc has a block kernel: check that it gives the same
+    // results, and errors, as proj_trans(), including for a number of
+    // points that is not a multiple of the block size. Both paths do the
+    // same operations, so results are identical, unless the compiler may
+    // contract them into FMA instructions.
+#ifdef __FP_FAST_FMA
+#define EXPECT_SAME_AS_SCALAR(a, b) EXPECT_NEAR(a, b, 1e-8)
+#else
+#define EXPECT_SAME_AS_SCALAR(a, b) EXPECT_EQ(a, b)
+#endif
+    auto P = proj_create(PJ_DEFAULT_CTX,
+                         "+proj=tmerc +algo=poder_engsager +lat_0=10 +lon_0=9 "
+                         "+k=0.9996 +x_0=500000 +y_0=100000 +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+
+    constexpr int N = 1001;
+    std::vector<PJ_COORD> coords;
+    for (int i = 0; i < N; i++) {
+        if (i == 10 || i == 500)
+            coords.push_back(proj_coord(proj_torad(99), 0, 0, 0)); // 90 deg
+        else if (i == 20)
+            coords.push_back(proj_coord(HUGE_VAL, HUGE_VAL, 0, 0));
+        else
+            coords.push_back(proj_coord(proj_torad(-20 + i * 0.04),
+                                        proj_torad(-85 + i * 0.17), i, 0));
+    }
+    const std::vector<PJ_COORD> input(coords);
+    std::vector<PJ_COORD> expected;
+    for (const auto &coord : coords)
+        expected.push_back(proj_trans(P, PJ_FWD, coord));
+
+    EXPECT_EQ(proj_trans_array(P, PJ_FWD, coords.size(), coords.data()),
+              PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+    for (int i = 0; i < N; i++) {
+        if (i == 10 || i == 20 || i == 500) {
+            EXPECT_EQ(coords[i].xyzt.x, HUGE_VAL) << i;
+            continue;
+        }
+        EXPECT_SAME_AS_SCALAR(coords[i].xyzt.x, expected[i].xyzt.x) << i;
+        EXPECT_SAME_AS_SCALAR(coords[i].xyzt.y, expected[i].xyzt.y) << i;
+        EXPECT_EQ(coords[i].xyzt.z, expected[i].xyzt.z) << i;
+    }
+
+    // And back, including a point outside of the domain
+    expected[10] = proj_coord(1e8, 0, 0, 0);
+    std::vector<double> x, y;
+    for (int i = 0; i < N; i++) {
+        x.push_back(expected[i].xyzt.x);
+        y.push_back(expected[i].xyzt.y);
+    }
+    EXPECT_EQ(proj_trans_generic(P, PJ_INV, x.data(), sizeof(double), N,
+                                 y.data(), sizeof(double), N, nullptr, 0, 0,
+                                 nullptr, 0, 0),
+              static_cast<size_t>(N));
+    for (int i = 0; i < N; i++) {
+        if (i == 10 || i == 20 || i == 500) {
+            EXPECT_EQ(x[i], HUGE_VAL) << i;
+            continue;
+        }
+        const auto res = proj_trans(P, PJ_INV, expected[i]);
+        EXPECT_SAME_AS_SCALAR(x[i], res.xyzt.x) << i;
+        EXPECT_SAME_AS_SCALAR(y[i], res.xyzt.y) << i;
+        EXPECT_NEAR(x[i], input[i].xyzt.x, 1e-12) << i;
+        EXPECT_NEAR(y[i], input[i].xyzt.y, 1e-12) << i;
+    }
+#undef EXPECT_SAME_AS_SCALAR
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, proj_trans_with_a_crs) {
     auto P = proj_create(PJ_DEFAULT_CTX, "EPSG:4326");
     PJ_COORD input;
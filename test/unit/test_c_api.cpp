@@ -55,6 +55,8 @@
 #include <thread>
 #endif
 
+#include <vector>
+
 using namespace osgeo::proj::common;
 using namespace osgeo::proj::crs;
 using namespace osgeo::proj::cs;
@@ -2187,6 +2189,50 @@ TEST_F(CApi, proj_create_operations_allow_ballpark_transformations) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_create_operations_thread_count) {
+    auto ctxt = proj_create_operation_factory_context(m_ctxt, nullptr);
+    ASSERT_NE(ctxt, nullptr);
+    ContextKeeper keeper_ctxt(ctxt);
+
+    auto source_crs = proj_create_from_database(
+        m_ctxt, "EPSG", "4267", PJ_CATEGORY_CRS, false, nullptr); // NAD27
+    ASSERT_NE(source_crs, nullptr);
+    ObjectKeeper keeper_source_crs(source_crs);
+
+    auto target_crs = proj_create_from_database(
+        m_ctxt, "EPSG", "4269", PJ_CATEGORY_CRS, false, nullptr); // NAD83
+    ASSERT_NE(target_crs, nullptr);
+    ObjectKeeper keeper_target_crs(target_crs);
+
+    proj_operation_factory_context_set_spatial_criterion(
+        m_ctxt, ctxt, PROJ_SPATIAL_CRITERION_PARTIAL_INTERSECTION);
+
+    auto resSerial =
+        proj_create_operations(m_ctxt, source_crs, target_crs, ctxt);
+    ASSERT_NE(resSerial, nullptr);
+    ObjListKeeper keeper_resSerial(resSerial);
+
+    proj_operation_factory_context_set_thread_count(m_ctxt, ctxt, 4);
+
+    auto res = proj_create_operations(m_ctxt, source_crs, target_crs, ctxt);
+    ASSERT_NE(res, nullptr);
+    ObjListKeeper keeper_res(res);
+
+    const int count = proj_list_get_count(res);
+    EXPECT_GE(count, 10);
+    ASSERT_EQ(count, proj_list_get_count(resSerial));
+    for (int i = 0; i < count; ++i) {
+        auto op = proj_list_get(m_ctxt, res, i);
+        ObjectKeeper keeper_op(op);
+        auto opSerial = proj_list_get(m_ctxt, resSerial, i);
+        ObjectKeeper keeper_opSerial(opSerial);
+        EXPECT_EQ(std::string(proj_get_name(op)),
+                  std::string(proj_get_name(opSerial)));
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_context_set_database_path_null) {
 
     EXPECT_TRUE(
@@ -3315,6 +3361,192 @@ TEST_F(CApi, proj_clone_of_obj_with_alternative_operations) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_trans_generic_mt) {
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", nullptr);
+    ObjectKeeper keeper(P);
+    ASSERT_NE(P, nullptr);
+
+    constexpr size_t N = 50000;
+    std::vector<double> xRef, yRef;
+    for (size_t i = 0; i < N; ++i) {
+        xRef.push_back(40 + 10.0 * i / N);
+        yRef.push_back(3 + 1.0 * i / N);
+    }
+    // Invalid latitude in the last chunk
+    xRef[N - 10] = 100;
+    std::vector<double> x(xRef), y(yRef);
+    double zRef = 10;
+    double z = zRef;
+
+    proj_errno_reset(P);
+    EXPECT_EQ(proj_trans_generic(P, PJ_FWD, xRef.data(), sizeof(double), N,
+                                 yRef.data(), sizeof(double), N, &zRef,
+                                 sizeof(double), 1, nullptr, 0, 0),
+              N);
+    const int errnoRef = proj_errno(P);
+    EXPECT_NE(errnoRef, 0);
+
+    proj_errno_reset(P);
+    EXPECT_EQ(proj_trans_generic_mt(P, PJ_FWD, x.data(), sizeof(double), N,
+                                    y.data(), sizeof(double), N, &z,
+                                    sizeof(double), 1, nullptr, 0, 0, 4),
+              N);
+    EXPECT_EQ(proj_errno(P), errnoRef);
+    EXPECT_EQ(z, zRef);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(x[i], xRef[i]) << i;
+        EXPECT_EQ(y[i], yRef[i]) << i;
+    }
+
+    // Error state set before the call is preserved if no point fails
+    x.assign(N, 45);
+    y.assign(N, 3);
+    proj_errno_set(P, PROJ_ERR_COORD_TRANSFM);
+    EXPECT_EQ(proj_trans_generic_mt(P, PJ_FWD, x.data(), sizeof(double), N,
+                                    y.data(), sizeof(double), N, nullptr, 0, 0,
+                                    nullptr, 0, 0, 0),
+              N);
+    EXPECT_EQ(proj_errno(P), PROJ_ERR_COORD_TRANSFM);
+    proj_errno_reset(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_compile) {
+    EXPECT_EQ(proj_trans_compile(nullptr), nullptr);
+    EXPECT_EQ(proj_trans_handle_create(nullptr), nullptr);
+
+    // Runs P, compiled, from several threads through their own handle, and
+    // checks that they all get the results of proj_trans() on P
+    const auto checkFromThreads = [](PJ *P,
+                                     const std::vector<PJ_COORD> &input) {
+        std::vector<PJ_COORD> ref;
+        for (const auto &coord : input)
+            ref.push_back(proj_trans(P, PJ_FWD, coord));
+
+        auto compiled = proj_trans_compile(P);
+        ASSERT_NE(compiled, nullptr);
+        constexpr int THREAD_COUNT = 4;
+        std::vector<PJ_TRANS_HANDLE *> handles;
+        for (int i = 0; i < THREAD_COUNT; ++i) {
+            handles.push_back(proj_trans_handle_create(compiled));
+            ASSERT_NE(handles.back(), nullptr);
+        }
+        // Handles keep the compiled transformation alive
+        proj_trans_compiled_destroy(compiled);
+
+        std::vector<size_t> mismatches(THREAD_COUNT);
+        const auto run = [&](int idx) {
+            for (int iter = 0; iter < 10; ++iter) {
+                for (size_t i = 0; i < input.size(); ++i) {
+                    const auto c =
+                        proj_trans_with_handle(handles[idx], PJ_FWD, input[i]);
+                    if (c.xyzt.x != ref[i].xyzt.x ||
+                        c.xyzt.y != ref[i].xyzt.y ||
+                        c.xyzt.z != ref[i].xyzt.z)
+                        ++mismatches[idx];
+                }
+            }
+        };
+#ifndef __MINGW32__
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREAD_COUNT; ++i)
+            threads.emplace_back(run, i);
+        for (auto &thread : threads)
+            thread.join();
+#else
+        for (int i = 0; i < THREAD_COUNT; ++i)
+            run(i);
+#endif
+        for (int i = 0; i < THREAD_COUNT; ++i)
+            EXPECT_EQ(mismatches[i], 0U) << i;
+
+        for (auto handle : handles)
+            proj_trans_handle_destroy(handle);
+    };
+
+    constexpr size_t N = 1000;
+    {
+        auto P =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", nullptr);
+        ObjectKeeper keeper(P);
+        ASSERT_NE(P, nullptr);
+        std::vector<PJ_COORD> input;
+        for (size_t i = 0; i < N; ++i)
+            input.push_back(
+                proj_coord(40 + 10.0 * i / N, 3 + 1.0 * i / N, 0, 0));
+        checkFromThreads(P, input);
+    }
+
+    {
+        // Grids read line by line, and a time-dependent Helmert
+        // transformation
+        auto P = proj_create(
+            m_ctxt, "+proj=pipeline "
+                    "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+                    "+step +proj=hgridshift "
+                    "+grids=tests/ntv2_0_downsampled.gsb "
+                    "+step +proj=vgridshift "
+                    "+grids=tests/egm96_15_downsampled.gtx +multiplier=1 "
+                    "+step +proj=cart +ellps=GRS80 "
+                    "+step +proj=helmert +x=0.1 +dx=0.01 +rz=0.001 +drz=0.0001 "
+                    "+t_epoch=2010 +convention=position_vector "
+                    "+step +inv +proj=cart +ellps=GRS80 "
+                    "+step +proj=unitconvert +xy_in=rad +xy_out=deg");
+        ObjectKeeper keeper(P);
+        ASSERT_NE(P, nullptr);
+        std::vector<PJ_COORD> input;
+        for (size_t i = 0; i < N; ++i)
+            input.push_back(proj_coord(-80 + 20.0 * i / N, 45 + 10.0 * i / N,
+                                       0, 2000 + static_cast<double>(i % 20)));
+        ASSERT_NE(proj_trans(P, PJ_FWD, input[0]).xyzt.x, HUGE_VAL);
+        checkFromThreads(P, input);
+    }
+
+    // Operations that change their own state while transforming are rejected
+    {
+        auto P = proj_create(
+            m_ctxt, "+proj=pipeline +step +proj=unitconvert +xy_in=deg "
+                    "+xy_out=rad +step +proj=defmodel "
+                    "+model=tests/simple_model_degree_3d.json");
+        ObjectKeeper keeper(P);
+        ASSERT_NE(P, nullptr);
+        EXPECT_EQ(proj_trans_compile(P), nullptr);
+        EXPECT_EQ(proj_errno(P), PROJ_ERR_OTHER_API_MISUSE);
+        proj_errno_reset(P);
+    }
+
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", nullptr);
+    ObjectKeeper keeper(P);
+    ASSERT_NE(P, nullptr);
+    auto compiled = proj_trans_compile(P);
+    ASSERT_NE(compiled, nullptr);
+    auto handle0 = proj_trans_handle_create(compiled);
+    auto handle1 = proj_trans_handle_create(compiled);
+    proj_trans_compiled_destroy(compiled);
+    ASSERT_NE(handle0, nullptr);
+    ASSERT_NE(handle1, nullptr);
+
+    // Errors are reported per handle
+    auto c = proj_trans_with_handle(handle0, PJ_FWD, proj_coord(100, 3, 0, 0));
+    EXPECT_EQ(c.xyzt.x, HUGE_VAL);
+    EXPECT_NE(proj_trans_handle_errno(handle0), 0);
+    EXPECT_EQ(proj_trans_handle_errno(handle1), 0);
+    EXPECT_EQ(proj_errno(P), 0);
+
+    const auto ref = proj_trans(P, PJ_FWD, proj_coord(40, 3, 0, 0));
+    PJ_COORD coords[2] = {proj_coord(40, 3, 0, 0), proj_coord(45, 3, 0, 0)};
+    EXPECT_EQ(proj_trans_array_with_handle(handle0, PJ_FWD, 2, coords), 0);
+    EXPECT_EQ(proj_trans_handle_errno(handle0), 0);
+    EXPECT_EQ(coords[0].xyzt.x, ref.xyzt.x);
+    EXPECT_EQ(coords[0].xyzt.y, ref.xyzt.y);
+
+    proj_trans_handle_destroy(handle0);
+    proj_trans_handle_destroy(handle1);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_crs_alter_geodetic_crs) {
     auto projCRS = proj_create_from_wkt(
         m_ctxt,
@@ -4288,6 +4520,67 @@ TEST_F(CApi, proj_get_units_from_database) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_context_get_db_query_stats) {
+    { proj_db_query_stats_list_destroy(nullptr); }
+
+    // Not enabled
+    {
+        int result_count = -1;
+        auto list = proj_context_get_db_query_stats(m_ctxt, &result_count);
+        ASSERT_NE(list, nullptr);
+        EXPECT_EQ(result_count, 0);
+        EXPECT_EQ(list[0], nullptr);
+        proj_db_query_stats_list_destroy(list);
+    }
+
+    proj_context_set_db_query_profiling(m_ctxt, true);
+    {
+        auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269",
+                                        nullptr);
+        ObjectKeeper keeper_P(P);
+        ASSERT_NE(P, nullptr);
+    }
+    proj_context_set_db_query_profiling(m_ctxt, false);
+
+    int result_count = 0;
+    auto list = proj_context_get_db_query_stats(m_ctxt, &result_count);
+    ASSERT_NE(list, nullptr);
+    EXPECT_GT(result_count, 0);
+    unsigned long long totalCount = 0;
+    for (int i = 0; i < result_count; ++i) {
+        ASSERT_NE(list[i], nullptr);
+        ASSERT_NE(list[i]->sql, nullptr);
+        EXPECT_GT(list[i]->count, 0U);
+        EXPECT_GE(list[i]->total_time_ms, 0.0);
+        if (i > 0) {
+            EXPECT_GE(list[i - 1]->total_time_ms, list[i]->total_time_ms);
+        }
+        totalCount += list[i]->count;
+    }
+    EXPECT_EQ(list[result_count], nullptr);
+    proj_db_query_stats_list_destroy(list);
+
+    // Statistics are kept after disabling the collection, but no longer
+    // updated
+    {
+        auto crs = proj_create(m_ctxt, "EPSG:32631");
+        ObjectKeeper keeper_crs(crs);
+        ASSERT_NE(crs, nullptr);
+        int result_count2 = 0;
+        auto list2 = proj_context_get_db_query_stats(m_ctxt, &result_count2);
+        ASSERT_NE(list2, nullptr);
+        EXPECT_EQ(result_count2, result_count);
+        unsigned long long totalCount2 = 0;
+        for (int i = 0; i < result_count2; ++i) {
+            totalCount2 += list2[i]->count;
+        }
+        EXPECT_EQ(totalCount2, totalCount);
+        proj_db_query_stats_list_destroy(list2);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_get_celestial_body_list_from_database) {
     { proj_celestial_body_list_destroy(nullptr); }
 
@@ -4839,6 +5132,233 @@ TEST_F(CApi, proj_create_crs_to_crs_from_pj_ballpark_filter) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_crs_to_crs_cache) {
+
+    proj_crs_to_crs_cache_set_max_size(m_ctxt, 10);
+
+    const auto checkSameResults = [](PJ *P1, PJ *P2) {
+        for (double lon = -120; lon <= -70; lon += 10) {
+            for (double lat = 30; lat <= 50; lat += 5) {
+                const PJ_COORD c = proj_coord(lat, lon, 0, HUGE_VAL);
+                const PJ_COORD res1 = proj_trans(P1, PJ_FWD, c);
+                const PJ_COORD res2 = proj_trans(P2, PJ_FWD, c);
+                EXPECT_EQ(res1.xy.x, res2.xy.x) << lon << " " << lat;
+                EXPECT_EQ(res1.xy.y, res2.xy.y) << lon << " " << lat;
+            }
+        }
+    };
+
+    // Set of several operations. A hit returns a new object, which can be
+    // used and destroyed independently of the first one.
+    {
+        auto P1 = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269",
+                                         nullptr);
+        ASSERT_NE(P1, nullptr);
+
+        auto P2 = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269",
+                                         nullptr);
+        ObjectKeeper keeper_P2(P2);
+        ASSERT_NE(P2, nullptr);
+        EXPECT_NE(P1, P2);
+        checkSameResults(P1, P2);
+
+        auto P3 = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269",
+                                         nullptr);
+        ObjectKeeper keeper_P3(P3);
+        ASSERT_NE(P3, nullptr);
+        proj_destroy(P1);
+        checkSameResults(P2, P3);
+    }
+
+    // Single operation, with an area of interest
+    {
+        auto area = proj_area_create();
+        proj_area_set_bbox(area, 2, 49, 3, 50);
+        auto P1 =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", area);
+        ObjectKeeper keeper_P1(P1);
+        ASSERT_NE(P1, nullptr);
+        auto P2 =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", area);
+        ObjectKeeper keeper_P2(P2);
+        ASSERT_NE(P2, nullptr);
+        EXPECT_NE(P1, P2);
+        EXPECT_TRUE(proj_is_equivalent_to(P1, P2, PJ_COMP_STRICT));
+
+        // The area of interest is part of the key
+        auto P3 =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4326", "EPSG:32631", nullptr);
+        ObjectKeeper keeper_P3(P3);
+        ASSERT_NE(P3, nullptr);
+        EXPECT_NE(P1, P3);
+        const PJ_COORD c = proj_coord(49.5, 2.5, 0, HUGE_VAL);
+        EXPECT_EQ(proj_trans(P1, PJ_FWD, c).xy.x,
+                  proj_trans(P3, PJ_FWD, c).xy.x);
+        proj_area_destroy(area);
+    }
+
+    // Options are part of the key
+    auto src = proj_create(m_ctxt, "EPSG:4267"); // NAD 27
+    ObjectKeeper keeper_src(src);
+    ASSERT_NE(src, nullptr);
+
+    auto dst = proj_create(m_ctxt, "EPSG:4258"); // ETRS89
+    ObjectKeeper keeper_dst(dst);
+    ASSERT_NE(dst, nullptr);
+
+    for (int i = 0; i < 2; ++i) {
+        {
+            auto P = proj_create_crs_to_crs_from_pj(m_ctxt, src, dst, nullptr,
+                                                    nullptr);
+            ObjectKeeper keeper_P(P);
+            ASSERT_NE(P, nullptr);
+        }
+
+        {
+            const char *const options[] = {"ALLOW_BALLPARK=NO", nullptr};
+            auto P = proj_create_crs_to_crs_from_pj(m_ctxt, src, dst, nullptr,
+                                                    options);
+            ObjectKeeper keeper_P(P);
+            ASSERT_EQ(P, nullptr);
+        }
+    }
+
+    // A result outlives the cache
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269", nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    proj_crs_to_crs_cache_clear(m_ctxt);
+    proj_crs_to_crs_cache_set_max_size(m_ctxt, 0);
+    auto Pnocache =
+        proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269", nullptr);
+    ObjectKeeper keeper_Pnocache(Pnocache);
+    ASSERT_NE(Pnocache, nullptr);
+    checkSameResults(P, Pnocache);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_create_cache) {
+
+    proj_create_cache_set_max_size(m_ctxt, 2);
+
+    for (const char *text :
+         {"EPSG:4326", "+proj=merc +type=crs",
+          "+proj=pipeline +step +proj=axisswap +order=2,1"}) {
+        auto P1 = proj_create(m_ctxt, text);
+        ObjectKeeper keeper_P1(P1);
+        ASSERT_NE(P1, nullptr) << text;
+        auto P2 = proj_create(m_ctxt, text);
+        ObjectKeeper keeper_P2(P2);
+        ASSERT_NE(P2, nullptr) << text;
+        // A hit returns a new object, equivalent to the first one
+        EXPECT_NE(P1, P2);
+        EXPECT_EQ(proj_get_type(P1), proj_get_type(P2)) << text;
+        EXPECT_TRUE(proj_is_equivalent_to(P1, P2, PJ_COMP_STRICT)) << text;
+    }
+
+    // Entries are evicted when the cache is full, without affecting the
+    // objects already returned
+    {
+        auto P1 = proj_create(m_ctxt, "+proj=merc +type=crs");
+        ObjectKeeper keeper_P1(P1);
+        ASSERT_NE(P1, nullptr);
+        for (int zone = 31; zone <= 33; ++zone) {
+            auto P = proj_create(
+                m_ctxt,
+                ("+proj=utm +zone=" + std::to_string(zone) + " +type=crs")
+                    .c_str());
+            ObjectKeeper keeper_P(P);
+            ASSERT_NE(P, nullptr);
+        }
+        auto P2 = proj_create(m_ctxt, "+proj=merc +type=crs");
+        ObjectKeeper keeper_P2(P2);
+        ASSERT_NE(P2, nullptr);
+        EXPECT_TRUE(proj_is_equivalent_to(P1, P2, PJ_COMP_STRICT));
+        EXPECT_STREQ(proj_get_name(P1), proj_get_name(P2));
+    }
+
+    // Invalid definitions are not cached
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(proj_create(m_ctxt, "EPSG:i_do_not_exist"), nullptr);
+    }
+
+    // An object outlives the cache
+    auto P = proj_create(m_ctxt, "+proj=merc +type=crs");
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    proj_create_cache_clear(m_ctxt);
+    proj_create_cache_set_max_size(m_ctxt, 0);
+    auto Pnocache = proj_create(m_ctxt, "+proj=merc +type=crs");
+    ObjectKeeper keeper_Pnocache(Pnocache);
+    ASSERT_NE(Pnocache, nullptr);
+    EXPECT_TRUE(proj_is_equivalent_to(P, Pnocache, PJ_COMP_STRICT));
+    EXPECT_NE(proj_as_wkt(m_ctxt, P, PJ_WKT2_2019, nullptr), nullptr);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_db_shared_cache) {
+    proj_db_shared_cache_clear();
+
+    PJ_DB_SHARED_CACHE_STATS stats;
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.max_size, 0U);
+    EXPECT_EQ(stats.entry_count, 0U);
+
+    proj_db_shared_cache_set_max_size(1000);
+
+    const auto createObjects = [](PJ_CONTEXT *ctx) {
+        auto crs = proj_create_from_database(ctx, "EPSG", "32631",
+                                             PJ_CATEGORY_CRS, false, nullptr);
+        ObjectKeeper keeper_crs(crs);
+        EXPECT_NE(crs, nullptr);
+        auto P = proj_create_crs_to_crs(ctx, "EPSG:4267", "EPSG:4269", nullptr);
+        ObjectKeeper keeper_P(P);
+        EXPECT_NE(P, nullptr);
+        const char *wkt = proj_as_wkt(ctx, crs, PJ_WKT2_2019, nullptr);
+        return std::string(wkt ? wkt : "");
+    };
+
+    auto ctx1 = proj_context_create();
+    PjContextKeeper keeper_ctx1(ctx1);
+    const auto wkt1 = createObjects(ctx1);
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.max_size, 1000U);
+    EXPECT_GT(stats.entry_count, 0U);
+    EXPECT_GT(stats.miss_count, 0U);
+    const auto entryCount = stats.entry_count;
+    const auto hitCount = stats.hit_count;
+
+    // A new context finds the objects instantiated by the first one
+    auto ctx2 = proj_context_create();
+    PjContextKeeper keeper_ctx2(ctx2);
+    const auto wkt2 = createObjects(ctx2);
+    EXPECT_EQ(wkt1, wkt2);
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_GT(stats.hit_count, hitCount);
+    EXPECT_EQ(stats.entry_count, entryCount);
+
+    // Reducing the size empties the cache
+    proj_db_shared_cache_set_max_size(16);
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.entry_count, 0U);
+    auto ctx3 = proj_context_create();
+    PjContextKeeper keeper_ctx3(ctx3);
+    EXPECT_EQ(createObjects(ctx3), wkt1);
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_LE(stats.entry_count, 16U);
+    EXPECT_GT(stats.eviction_count, 0U);
+
+    proj_db_shared_cache_set_max_size(0);
+    proj_db_shared_cache_clear();
+    proj_db_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.entry_count, 0U);
+    EXPECT_EQ(stats.hit_count, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_create_crs_to_crs_coordinate_metadata_in_src) {
 
     auto P =
@@ -6543,6 +7063,140 @@ TEST_F(CApi, proj_trans_bounds_to_compound_crs) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_trans_bounds_adaptive) {
+    {
+        auto P = proj_create_crs_to_crs(
+            m_ctxt, "EPSG:4326",
+            "+proj=laea +lat_0=45 +lon_0=-100 +x_0=0 +y_0=0 "
+            "+a=6370997 +b=6370997 +units=m +no_defs",
+            nullptr);
+        ObjectKeeper keeper_P(P);
+        ASSERT_NE(P, nullptr);
+        double out_left;
+        double out_bottom;
+        double out_right;
+        double out_top;
+        EXPECT_FALSE(proj_trans_bounds_adaptive(
+            m_ctxt, P, PJ_FWD, 40, -120, 64, -80, &out_left, &out_bottom,
+            &out_right, &out_top, 0));
+        // Expected values are the ones of proj_trans_bounds() with
+        // densify_pts = 10000
+        for (int i = 0; i < 2; ++i) {
+            // Second iteration uses the cached result
+            int success = proj_trans_bounds_adaptive(
+                m_ctxt, P, PJ_FWD, 40, -120, 64, -80, &out_left, &out_bottom,
+                &out_right, &out_top, 0.1);
+            EXPECT_TRUE(success == 1);
+            EXPECT_NEAR(out_left, -1684649.41338, 1);
+            EXPECT_NEAR(out_bottom, -555797.97003, 1);
+            EXPECT_NEAR(out_right, 1684649.41338, 1);
+            EXPECT_NEAR(out_top, 2234551.18559, 1);
+        }
+    }
+
+    // Cache hit: no point is transformed again, which is observed through
+    // the trace messages of the vertical grid lookups.
+    {
+        PJ_CONTEXT *ctxt = proj_context_create();
+        int lookups = 0;
+        proj_log_level(ctxt, PJ_LOG_TRACE);
+        proj_log_func(ctxt, &lookups,
+                      [](void *user_data, int, const char *msg) {
+                          if (strstr(msg, "proj_vgrid_value") != nullptr)
+                              ++*static_cast<int *>(user_data);
+                      });
+        auto P = proj_create(ctxt, "+proj=vgridshift +grids=egm96_15.gtx");
+        ASSERT_NE(P, nullptr);
+        double out[4];
+        double out_cached[4];
+        EXPECT_TRUE(proj_trans_bounds_adaptive(
+            ctxt, P, PJ_FWD, 0.1, 0.7, 0.2, 0.8, &out[0], &out[1], &out[2],
+            &out[3], 1e-3));
+        EXPECT_GT(lookups, 0);
+        lookups = 0;
+        EXPECT_TRUE(proj_trans_bounds_adaptive(
+            ctxt, P, PJ_FWD, 0.1, 0.7, 0.2, 0.8, &out_cached[0],
+            &out_cached[1], &out_cached[2], &out_cached[3], 1e-3));
+        EXPECT_EQ(lookups, 0);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(out_cached[i], out[i]);
+        }
+        // Different arguments are not a hit
+        EXPECT_TRUE(proj_trans_bounds_adaptive(
+            ctxt, P, PJ_FWD, 0.1, 0.7, 0.2, 0.9, &out_cached[0],
+            &out_cached[1], &out_cached[2], &out_cached[3], 1e-3));
+        EXPECT_GT(lookups, 0);
+        // Nor after assigning another context, which logs to the same
+        // counter
+        PJ_CONTEXT *ctxt2 = proj_context_clone(ctxt);
+        proj_assign_context(P, ctxt2);
+        lookups = 0;
+        EXPECT_TRUE(proj_trans_bounds_adaptive(
+            ctxt2, P, PJ_FWD, 0.1, 0.7, 0.2, 0.8, &out_cached[0],
+            &out_cached[1], &out_cached[2], &out_cached[3], 1e-3));
+        EXPECT_GT(lookups, 0);
+        proj_destroy(P);
+        proj_context_destroy(ctxt2);
+        proj_context_destroy(ctxt);
+    }
+
+    // Antimeridian
+    {
+        auto P =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4167", "EPSG:3851", nullptr);
+        ObjectKeeper keeper_P(P);
+        ASSERT_NE(P, nullptr);
+        double out_left;
+        double out_bottom;
+        double out_right;
+        double out_top;
+        int success = proj_trans_bounds_adaptive(
+            m_ctxt, P, PJ_FWD, -55.95, 160.6, -25.88, -171.2, &out_left,
+            &out_bottom, &out_right, &out_top, 1);
+        EXPECT_TRUE(success == 1);
+        EXPECT_NEAR(out_left, 5228058.6143420935, 1);
+        EXPECT_NEAR(out_bottom, 1722483.900174921, 1);
+        EXPECT_NEAR(out_right, 8692678.10639, 1);
+        EXPECT_NEAR(out_top, 4624385.494808555, 1);
+        double out_left_inv;
+        double out_bottom_inv;
+        double out_right_inv;
+        double out_top_inv;
+        int success_inv = proj_trans_bounds_adaptive(
+            m_ctxt, P, PJ_INV, 5228058.6143420935, 1722483.900174921,
+            8692574.544944234, 4624385.494808555, &out_left_inv,
+            &out_bottom_inv, &out_right_inv, &out_top_inv, 1e-6);
+        EXPECT_TRUE(success_inv == 1);
+        EXPECT_NEAR(out_left_inv, -56.7484638, 1e-6);
+        EXPECT_NEAR(out_bottom_inv, 153.2799922, 1);
+        EXPECT_NEAR(out_right_inv, -24.6148194, 1);
+        EXPECT_NEAR(out_top_inv, -162.1813873, 1);
+    }
+
+    // South pole
+    {
+        auto P =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:32761", "EPSG:4326", nullptr);
+        ObjectKeeper keeper_P(P);
+        ASSERT_NE(P, nullptr);
+        double out_left;
+        double out_bottom;
+        double out_right;
+        double out_top;
+        int success = proj_trans_bounds_adaptive(
+            m_ctxt, P, PJ_FWD, -1405880.71737131, -1371213.7625429356,
+            5405880.71737131, 5371213.762542935, &out_left, &out_bottom,
+            &out_right, &out_top, 1e-6);
+        EXPECT_TRUE(success == 1);
+        EXPECT_NEAR(out_left, -90.0, 1);
+        EXPECT_NEAR(out_bottom, -180.0, 1);
+        EXPECT_NEAR(out_right, -48.656, 1);
+        EXPECT_NEAR(out_top, 180.0, 1);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_trans_bounds_3d_densify_0_geog3D_to_proj2D) {
     auto P =
         proj_create_crs_to_crs(m_ctxt, "EPSG:4979",
@@ -46,6 +46,13 @@
 #define DEFORMATON_MODEL_NAMESPACE TestDeformationModel
 #include "transformations/defmodel.hpp"
 
+#include <cstdio>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
 using namespace DEFORMATON_MODEL_NAMESPACE;
 
 namespace {
@@ -1513,6 +1520,66 @@ TEST(defmodel, evaluator_projected_crs) {
     }
 }
 
+// ---------------------------------------------------------------------------
+
+#if !defined(_WIN32)
+TEST(defmodel, master_file_cache) {
+    const char *tempdir = getenv("TEMP");
+    if (!tempdir) {
+        tempdir = getenv("TMP");
+    }
+    if (!tempdir) {
+        tempdir = "/tmp";
+    }
+    const std::string filename(std::string(tempdir) +
+                               "/test_defmodel_master_file_cache.json");
+    const std::string projString("+proj=defmodel +model=" + filename);
+
+    const auto writeFile = [&filename](const std::string &content) {
+        FILE *f = fopen(filename.c_str(), "wb");
+        ASSERT_TRUE(f != nullptr);
+        fwrite(content.data(), 1, content.size(), f);
+        fclose(f);
+    };
+    const auto setMTime = [&filename](time_t mtime) {
+        struct utimbuf times;
+        times.actime = mtime;
+        times.modtime = mtime;
+        ASSERT_EQ(utime(filename.c_str(), &times), 0);
+    };
+
+    proj_cleanup();
+    const auto content = getMinValidContent().dump();
+    writeFile(content);
+    struct stat sb;
+    ASSERT_EQ(stat(filename.c_str(), &sb), 0);
+
+    auto ctx = proj_context_create();
+    proj_log_level(ctx, PJ_LOG_NONE);
+    auto P = proj_create(ctx, projString.c_str());
+    EXPECT_NE(P, nullptr);
+    proj_destroy(P);
+
+    // Replace the content of the file by something invalid, with the same
+    // size and modification time: the cached parsed model is still used.
+    writeFile(std::string(content.size(), ' '));
+    setMTime(sb.st_mtime);
+    P = proj_create(ctx, projString.c_str());
+    EXPECT_NE(P, nullptr);
+    proj_destroy(P);
+
+    // With another modification time, the file is read again
+    setMTime(sb.st_mtime + 10);
+    P = proj_create(ctx, projString.c_str());
+    EXPECT_EQ(P, nullptr);
+    proj_destroy(P);
+
+    proj_context_destroy(ctx);
+    proj_cleanup();
+    std::remove(filename.c_str());
+}
+#endif
+
 } // namespace
 
 #ifdef _MSC_VER
@@ -3913,6 +3913,54 @@ TEST(factory, createObjectsFromName) {
 
 // ---------------------------------------------------------------------------
 
+TEST(factory, createObjectsFromName_name_index) {
+    const auto getCodes = [](const std::list<IdentifiedObjectNNPtr> &list) {
+        std::vector<std::string> codes;
+        for (const auto &obj : list) {
+            const auto &id = obj->identifiers().front();
+            codes.push_back(*(id->codeSpace()) + ':' + id->code());
+        }
+        return codes;
+    };
+    const std::vector<AuthorityFactory::ObjectType> types{
+        AuthorityFactory::ObjectType::GEOGRAPHIC_2D_CRS};
+
+    auto ctxtRef = DatabaseContext::create();
+    auto factoryRef = AuthorityFactory::create(ctxtRef, "EPSG");
+    const auto exactRef =
+        getCodes(factoryRef->createObjectsFromName("wgs 84", types, false));
+    ASSERT_EQ(exactRef.size(), 1U);
+    EXPECT_EQ(exactRef.front(), "EPSG:4326");
+
+    auto ctxt = DatabaseContext::create();
+    auto factory = AuthorityFactory::create(ctxt, "EPSG");
+    // The approximate search builds the index on names...
+    const auto approx =
+        getCodes(factory->createObjectsFromName("WGS84", types, true));
+    EXPECT_EQ(approx, getCodes(factoryRef->createObjectsFromName(
+                          "WGS84", types, true)));
+    // ... which is then used by the exact search
+    EXPECT_EQ(getCodes(factory->createObjectsFromName("wgs 84", types, false)),
+              exactRef);
+    EXPECT_TRUE(
+        factory->createObjectsFromName("i_dont_exist", types, false).empty());
+    EXPECT_TRUE(
+        factory->createObjectsFromName("i_dont_exist", types, true).empty());
+
+    // Substring shorter than a trigram
+    EXPECT_EQ(
+        getCodes(factory->createObjectsFromName("84", types, true, 5)),
+        getCodes(factoryRef->createObjectsFromName("84", types, true, 5)));
+
+    // Repeated searches do not run queries any longer
+    const auto queryCounterBefore = ctxt->getQueryCounter();
+    EXPECT_EQ(getCodes(factory->createObjectsFromName("WGS84", types, true)),
+              approx);
+    EXPECT_EQ(ctxt->getQueryCounter(), queryCounterBefore);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(factory, getMetadata) {
     auto ctxt = DatabaseContext::create();
     EXPECT_EQ(ctxt->getMetadata("i_do_not_exist"), nullptr);
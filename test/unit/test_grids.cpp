@@ -28,6 +28,10 @@
 
 #include "gtest_include.h"
 
+#include <cstdio>
+#include <cstring>
+
+#include "filemanager.hpp"
 #include "grids.hpp"
 
 #include "proj_internal.h" // M_PI
@@ -59,6 +63,52 @@ class GridTest : public ::testing::Test {
 
 // ---------------------------------------------------------------------------
 
+// Read-only file API going through stdio, so that grids are read through
+// File::read() instead of being memory-mapped.
+static void setStdioFileApi(PJ_CONTEXT *ctx) {
+    struct PROJ_FILE_API api;
+    api.version = 1;
+    api.open_cbk = [](PJ_CONTEXT *, const char *filename, PROJ_OPEN_ACCESS,
+                      void *) -> PROJ_FILE_HANDLE * {
+        return reinterpret_cast<PROJ_FILE_HANDLE *>(fopen(filename, "rb"));
+    };
+    api.read_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, void *buffer,
+                      size_t sizeBytes, void *) -> size_t {
+        return fread(buffer, 1, sizeBytes, reinterpret_cast<FILE *>(handle));
+    };
+    api.write_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *, const void *, size_t,
+                       void *) -> size_t { return 0; };
+    api.seek_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, long long offset,
+                      int whence, void *) -> int {
+        return fseek(reinterpret_cast<FILE *>(handle),
+                     static_cast<long>(offset), whence) == 0;
+    };
+    api.tell_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle,
+                      void *) -> unsigned long long {
+        return ftell(reinterpret_cast<FILE *>(handle));
+    };
+    api.close_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, void *) {
+        fclose(reinterpret_cast<FILE *>(handle));
+    };
+    api.exists_cbk = [](PJ_CONTEXT *, const char *filename, void *) -> int {
+        FILE *f = fopen(filename, "rb");
+        if (f)
+            fclose(f);
+        return f != nullptr;
+    };
+    api.mkdir_cbk = [](PJ_CONTEXT *, const char *, void *) -> int {
+        return false;
+    };
+    api.unlink_cbk = [](PJ_CONTEXT *, const char *, void *) -> int {
+        return false;
+    };
+    api.rename_cbk = [](PJ_CONTEXT *, const char *, const char *,
+                        void *) -> int { return false; };
+    ASSERT_TRUE(proj_context_set_fileapi(ctx, &api, nullptr));
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, VerticalShiftGridSet_null) {
     auto gridSet = NS_PROJ::VerticalShiftGridSet::open(m_ctxt, "null");
     ASSERT_NE(gridSet, nullptr);
@@ -96,6 +146,89 @@ TEST_F(GridTest, VerticalShiftGridSet_gtx) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(GridTest, File_mappedData) {
+    const auto info = proj_grid_info("tests/test_nodata.gtx");
+    ASSERT_NE(info.filename[0], '\0');
+
+    // Not mapped by default
+    auto fpNotMapped = NS_PROJ::FileManager::open(
+        m_ctxt, info.filename, NS_PROJ::FileAccess::READ_ONLY);
+    ASSERT_NE(fpNotMapped, nullptr);
+    unsigned long long size = 0;
+    EXPECT_EQ(fpNotMapped->mappedData(size), nullptr);
+    EXPECT_EQ(size, 0U);
+
+    proj_context_set_enable_grid_memory_mapping(m_ctxt, true);
+    auto fp = NS_PROJ::FileManager::open(m_ctxt, info.filename,
+                                         NS_PROJ::FileAccess::READ_ONLY);
+    ASSERT_NE(fp, nullptr);
+    const unsigned char *data = fp->mappedData(size);
+#ifndef _WIN32
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(size, 104U);
+    unsigned char header[40];
+    ASSERT_EQ(fp->read(header, sizeof(header)), sizeof(header));
+    EXPECT_EQ(memcmp(header, data, sizeof(header)), 0);
+#else
+    EXPECT_EQ(data, nullptr);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, mapped_and_read_grids_identical) {
+    proj_context_set_enable_grid_memory_mapping(m_ctxt, true);
+    setStdioFileApi(m_ctxt2);
+
+    auto hgridSetMapped = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(hgridSetMapped, nullptr);
+    auto hgridSetRead = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt2, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(hgridSetRead, nullptr);
+    auto hgridMapped =
+        hgridSetMapped->gridAt(-80.0 / 180 * M_PI, 45.0 / 180 * M_PI);
+    ASSERT_NE(hgridMapped, nullptr);
+    auto hgridRead =
+        hgridSetRead->gridAt(-80.0 / 180 * M_PI, 45.0 / 180 * M_PI);
+    ASSERT_NE(hgridRead, nullptr);
+    ASSERT_EQ(hgridMapped->width(), hgridRead->width());
+    ASSERT_EQ(hgridMapped->height(), hgridRead->height());
+    for (int y = 0; y < hgridRead->height(); ++y) {
+        for (int x = 0; x < hgridRead->width(); ++x) {
+            float longShiftMapped = 0, latShiftMapped = 0;
+            float longShiftRead = 0, latShiftRead = 0;
+            ASSERT_TRUE(hgridMapped->valueAt(x, y, true, longShiftMapped,
+                                             latShiftMapped));
+            ASSERT_TRUE(hgridRead->valueAt(x, y, true, longShiftRead,
+                                           latShiftRead));
+            ASSERT_EQ(longShiftMapped, longShiftRead);
+            ASSERT_EQ(latShiftMapped, latShiftRead);
+        }
+    }
+
+    auto vgridSetMapped = NS_PROJ::VerticalShiftGridSet::open(
+        m_ctxt, "tests/egm96_15_downsampled.gtx");
+    ASSERT_NE(vgridSetMapped, nullptr);
+    auto vgridSetRead = NS_PROJ::VerticalShiftGridSet::open(
+        m_ctxt2, "tests/egm96_15_downsampled.gtx");
+    ASSERT_NE(vgridSetRead, nullptr);
+    auto vgridMapped = vgridSetMapped->gridAt(0, 0);
+    ASSERT_NE(vgridMapped, nullptr);
+    auto vgridRead = vgridSetRead->gridAt(0, 0);
+    ASSERT_NE(vgridRead, nullptr);
+    for (int y = 0; y < vgridRead->height(); ++y) {
+        for (int x = 0; x < vgridRead->width(); ++x) {
+            float valMapped = 0, valRead = 0;
+            ASSERT_TRUE(vgridMapped->valueAt(x, y, valMapped));
+            ASSERT_TRUE(vgridRead->valueAt(x, y, valRead));
+            ASSERT_EQ(valMapped, valRead);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, HorizontalShiftGridSet_null) {
     auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, "null");
     ASSERT_NE(gridSet, nullptr);
@@ -117,6 +250,158 @@ TEST_F(GridTest, HorizontalShiftGridSet_null) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(GridTest, SharedGridCache_ntv2) {
+    // Memory-mapped grids do not need any cache
+    setStdioFileApi(m_ctxt);
+    setStdioFileApi(m_ctxt2);
+    proj_grid_shared_cache_clear();
+
+    const double lon = -80.0 / 180 * M_PI;
+    const double lat = 45.0 / 180 * M_PI;
+    auto gridSetRef = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(gridSetRef, nullptr);
+    auto gridRef = gridSetRef->gridAt(lon, lat);
+    ASSERT_NE(gridRef, nullptr);
+    float refLong[3] = {0, 0, 0};
+    float refLat[3] = {0, 0, 0};
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(gridRef->valueAt(1, i, false, refLong[i], refLat[i]));
+    }
+
+    PJ_GRID_SHARED_CACHE_STATS stats;
+    proj_grid_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.max_size, 0U);
+    EXPECT_EQ(stats.entry_count, 0U);
+
+    proj_grid_shared_cache_set_max_size(10 * 1024 * 1024);
+
+    auto gridSet1 = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(gridSet1, nullptr);
+    auto gridSet2 = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt2, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(gridSet2, nullptr);
+    auto grid1 = gridSet1->gridAt(lon, lat);
+    ASSERT_NE(grid1, nullptr);
+    auto grid2 = gridSet2->gridAt(lon, lat);
+    ASSERT_NE(grid2, nullptr);
+
+    float longShift = 0;
+    float latShift = 0;
+    ASSERT_TRUE(grid1->valueAt(1, 0, false, longShift, latShift));
+    EXPECT_EQ(longShift, refLong[0]);
+    EXPECT_EQ(latShift, refLat[0]);
+    proj_grid_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.max_size, 10U * 1024 * 1024);
+    EXPECT_EQ(stats.entry_count, 1U);
+    EXPECT_GT(stats.size, 0U);
+    EXPECT_EQ(stats.hit_count, 0U);
+    EXPECT_EQ(stats.miss_count, 1U);
+
+    // Read from another context: the decoded line is shared
+    ASSERT_TRUE(grid2->valueAt(1, 0, false, longShift, latShift));
+    EXPECT_EQ(longShift, refLong[0]);
+    EXPECT_EQ(latShift, refLat[0]);
+    ASSERT_TRUE(grid2->valueAt(1, 1, false, longShift, latShift));
+    EXPECT_EQ(longShift, refLong[1]);
+    EXPECT_EQ(latShift, refLat[1]);
+    proj_grid_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.entry_count, 2U);
+    EXPECT_EQ(stats.hit_count, 1U);
+    EXPECT_EQ(stats.miss_count, 2U);
+
+    // Shrinking the cache evicts entries, and grids remain usable
+    proj_grid_shared_cache_set_max_size(1);
+    proj_grid_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.entry_count, 0U);
+    EXPECT_EQ(stats.size, 0U);
+    EXPECT_EQ(stats.eviction_count, 2U);
+    ASSERT_TRUE(grid1->valueAt(1, 2, false, longShift, latShift));
+    EXPECT_EQ(longShift, refLong[2]);
+    EXPECT_EQ(latShift, refLat[2]);
+
+    proj_grid_shared_cache_set_max_size(0);
+    proj_grid_shared_cache_clear();
+    proj_grid_shared_cache_get_stats(&stats);
+    EXPECT_EQ(stats.max_size, 0U);
+    EXPECT_EQ(stats.hit_count, 0U);
+    EXPECT_EQ(stats.miss_count, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, HorizontalShiftGrid_precomputed_inverse) {
+    proj_context_set_enable_precomputed_inverse_grids(m_ctxt, true);
+    const char *projString =
+        "+proj=hgridshift +grids=tests/ntv2_0_downsampled.gsb";
+    auto P = proj_create(m_ctxt, projString);
+    ASSERT_NE(P, nullptr);
+    auto Pref = proj_create(m_ctxt2, projString);
+    ASSERT_NE(Pref, nullptr);
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+        m_ctxt, "tests/ntv2_0_downsampled.gsb");
+    ASSERT_NE(gridSet, nullptr);
+
+    int accurateCount = 0;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10; ++j) {
+            PJ_COORD c;
+            c.lpzt.lam = proj_torad(-82.0 + 0.37 * i);
+            c.lpzt.phi = proj_torad(43.0 + 0.29 * j);
+            c.lpzt.z = 0;
+            c.lpzt.t = HUGE_VAL;
+            const PJ_COORD ref = proj_trans(Pref, PJ_INV, c);
+            const PJ_COORD res = proj_trans(P, PJ_INV, c);
+            ASSERT_NE(ref.lpzt.lam, HUGE_VAL);
+            EXPECT_NEAR(res.lpzt.lam, ref.lpzt.lam, 1e-11);
+            EXPECT_NEAR(res.lpzt.phi, ref.lpzt.phi, 1e-11);
+
+            // Round trip
+            const PJ_COORD back = proj_trans(P, PJ_FWD, res);
+            EXPECT_NEAR(back.lpzt.lam, c.lpzt.lam, 1e-11);
+            EXPECT_NEAR(back.lpzt.phi, c.lpzt.phi, 1e-11);
+
+            // Whether the inverse shift is a single interpolation of the
+            // inverse grid, followed by a single step of the iteration
+            auto grid = gridSet->gridAt(c.lpzt.lam, c.lpzt.phi);
+            ASSERT_NE(grid, nullptr);
+            const auto &extent = grid->extentAndRes();
+            double longShift = 0;
+            double latShift = 0;
+            bool accurate = false;
+            if (grid->inverseShiftAt(c.lpzt.lam - extent.west,
+                                     c.lpzt.phi - extent.south, longShift,
+                                     latShift, accurate) &&
+                accurate) {
+                ++accurateCount;
+                PJ_COORD estimate = c;
+                estimate.lpzt.lam -= longShift;
+                estimate.lpzt.phi -= latShift;
+                const PJ_COORD fwd = proj_trans(Pref, PJ_FWD, estimate);
+                estimate.lpzt.lam -= fwd.lpzt.lam - c.lpzt.lam;
+                estimate.lpzt.phi -= fwd.lpzt.phi - c.lpzt.phi;
+                EXPECT_NEAR(estimate.lpzt.lam, ref.lpzt.lam, 1e-11);
+                EXPECT_NEAR(estimate.lpzt.phi, ref.lpzt.phi, 1e-11);
+            }
+        }
+    }
+    EXPECT_GE(accurateCount, 90);
+
+    // Outside of the grid
+    PJ_COORD c;
+    c.lpzt.lam = 0;
+    c.lpzt.phi = 0;
+    c.lpzt.z = 0;
+    c.lpzt.t = HUGE_VAL;
+    EXPECT_EQ(proj_trans(P, PJ_INV, c).lpzt.lam, HUGE_VAL);
+
+    proj_destroy(P);
+    proj_destroy(Pref);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, GenericShiftGridSet_null) {
     auto gridSet = NS_PROJ::GenericShiftGridSet::open(m_ctxt, "null");
     ASSERT_NE(gridSet, nullptr);
@@ -292,6 +577,47 @@ TEST_F(GridTest, GenericShiftGridSet_gtiff_valuesAt_tiled_optim) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_read_ahead) {
+    // Tiled DEFLATE compressed grid, with 16x32 tiles
+    const char *gridName = "tests/test_hgrid_tiled.tif";
+    auto gridSetRef = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, gridName);
+    ASSERT_NE(gridSetRef, nullptr);
+
+    proj_context_set_grid_read_ahead_threads(m_ctxt2, 2);
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt2, gridName);
+    ASSERT_NE(gridSet, nullptr);
+
+    auto gridRef = gridSetRef->gridAt(0, 0);
+    ASSERT_NE(gridRef, nullptr);
+    auto grid = gridSet->gridAt(0, 0);
+    ASSERT_NE(grid, nullptr);
+
+    // Sweep the grid line by line, moving from tile to tile
+    for (int y = 0; y < grid->height(); y += 7) {
+        for (int x = 0; x < grid->width(); x += 3) {
+            float lonRef = 0, latRef = 0, lon = 0, lat = 0;
+            ASSERT_TRUE(gridRef->valueAt(x, y, false, lonRef, latRef));
+            ASSERT_TRUE(grid->valueAt(x, y, false, lon, lat));
+            EXPECT_EQ(lon, lonRef) << x << " " << y;
+            EXPECT_EQ(lat, latRef) << x << " " << y;
+        }
+    }
+
+    PJ_GRID_READ_AHEAD_STATS stats;
+    proj_context_get_grid_read_ahead_stats(m_ctxt2, &stats);
+    EXPECT_GT(stats.scheduled_count, 0U);
+    EXPECT_GT(stats.hit_count, 0U);
+    EXPECT_GT(stats.miss_count, 0U);
+
+    PJ_GRID_READ_AHEAD_STATS statsRef;
+    proj_context_get_grid_read_ahead_stats(m_ctxt, &statsRef);
+    EXPECT_EQ(statsRef.scheduled_count, 0U);
+    EXPECT_EQ(statsRef.hit_count, 0U);
+    EXPECT_EQ(statsRef.miss_count, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, GenericShiftGridSet_gtiff_with_subgrid) {
     auto gridSet = NS_PROJ::GenericShiftGridSet::open(
         m_ctxt, "tests/test_hgrid_with_subgrid.tif");
@@ -163,6 +163,46 @@ TEST(io, wkt_parsing_with_printed_quotes) {
 
 // ---------------------------------------------------------------------------
 
+TEST(io, wkt_parsing_with_printed_quotes_and_double_quotes_inside) {
+    static const std::string startPrintedQuote("\xE2\x80\x9C");
+    static const std::string endPrintedQuote("\xE2\x80\x9D");
+
+    auto n = WKTNode::createFrom("A[" + startPrintedQuote + "x\"y" +
+                                 endPrintedQuote + ",B[" + startPrintedQuote +
+                                 "]" + endPrintedQuote + "]]");
+    ASSERT_EQ(n->children().size(), 2U);
+    EXPECT_EQ(n->children()[0]->value(), "\"x\"y\"");
+    ASSERT_EQ(n->children()[1]->children().size(), 1U);
+    EXPECT_EQ(n->children()[1]->children()[0]->value(), "\"]\"");
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(wkt_parse, validate_grammar) {
+    const char *wkt =
+        "GEOGCS[\"WGS 84\",\n"
+        "    DATUM[\"WGS_1984\",\n"
+        "        SPHEROID[\"WGS 84\",6378137,298.257223563,\"unused\"]],\n"
+        "    PRIMEM[\"Greenwich\",0],\n"
+        "    UNIT[\"degree\",0.0174532925199433]]";
+
+    EXPECT_THROW(WKTParser().createFromWKT(wkt), ParsingException);
+    {
+        WKTParser parser;
+        parser.setStrict(false);
+        EXPECT_NO_THROW(parser.createFromWKT(wkt));
+        EXPECT_EQ(parser.grammarErrorList().size(), 1U);
+    }
+    {
+        WKTParser parser;
+        parser.setValidateGrammar(false);
+        EXPECT_NO_THROW(parser.createFromWKT(wkt));
+        EXPECT_TRUE(parser.grammarErrorList().empty());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(wkt_parse, sphere) {
     auto obj = WKTParser().createFromWKT(
         "ELLIPSOID[\"Sphere\",6378137,0,LENGTHUNIT[\"metre\",1]]");
@@ -29,9 +29,11 @@
 #include "gtest_include.h"
 
 #include <memory>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "filemanager.hpp"
 #include "proj_internal.h"
 #include <proj.h>
 
@@ -2285,4 +2287,112 @@ TEST(networking, do_not_attempt_network_access_known_available_network_on) {
 
 #endif
 
+// ---------------------------------------------------------------------------
+
+// Serves an in-memory file, and records the requested ranges
+struct InMemoryServer {
+    std::vector<unsigned char> content{};
+    std::mutex mutex{};
+    std::vector<std::pair<unsigned long long, size_t>> requests{};
+    std::string contentRange{};
+
+    size_t serve(unsigned long long offset, size_t size, void *buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.emplace_back(offset, size);
+        if (offset >= content.size())
+            return 0;
+        const size_t n = static_cast<size_t>(
+            std::min<unsigned long long>(size, content.size() - offset));
+        memcpy(buffer, content.data() + offset, n);
+        return n;
+    }
+};
+
+static PROJ_NETWORK_HANDLE *
+in_memory_open_cbk(PJ_CONTEXT *, const char *, unsigned long long offset,
+                   size_t size_to_read, void *buffer, size_t *out_size_read,
+                   size_t, char *, void *user_data) {
+    auto server = static_cast<InMemoryServer *>(user_data);
+    *out_size_read = server->serve(offset, size_to_read, buffer);
+    return reinterpret_cast<PROJ_NETWORK_HANDLE *>(new int(0));
+}
+
+static void in_memory_close_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *handle,
+                                void *) {
+    delete reinterpret_cast<int *>(handle);
+}
+
+static const char *in_memory_get_header_value_cbk(PJ_CONTEXT *,
+                                                  PROJ_NETWORK_HANDLE *,
+                                                  const char *header_name,
+                                                  void *user_data) {
+    auto server = static_cast<InMemoryServer *>(user_data);
+    if (strcmp(header_name, "Content-Range") == 0)
+        return server->contentRange.c_str();
+    return nullptr;
+}
+
+static size_t in_memory_read_range_cbk(PJ_CONTEXT *,
+                                       PROJ_NETWORK_HANDLE *,
+                                       unsigned long long offset,
+                                       size_t size_to_read, void *buffer,
+                                       size_t, char *, void *user_data) {
+    auto server = static_cast<InMemoryServer *>(user_data);
+    return server->serve(offset, size_to_read, buffer);
+}
+
+TEST(networking, file_prefetch) {
+    auto ctx = proj_context_create();
+    proj_grid_cache_set_enable(ctx, false);
+    proj_context_set_enable_network(ctx, true);
+
+    InMemoryServer server;
+    server.content.resize(1000 * 1000);
+    for (size_t i = 0; i < server.content.size(); ++i)
+        server.content[i] = static_cast<unsigned char>(i * 7 + i / 256);
+    server.contentRange = "bytes 0-16383/" +
+                          std::to_string(server.content.size());
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, in_memory_open_cbk, in_memory_close_cbk,
+        in_memory_get_header_value_cbk, in_memory_read_range_cbk, &server));
+
+    auto fp = NS_PROJ::FileManager::open(ctx, "https://foo/prefetch.bin",
+                                         NS_PROJ::FileAccess::READ_ONLY);
+    ASSERT_NE(fp, nullptr);
+    ASSERT_EQ(server.requests.size(), 1U);
+    server.requests.clear();
+
+    // Chunks 6 to 9, 18 and 19, and 60 and 61 (the last one, as the range
+    // goes beyond the end of file). Chunk 0 is already cached.
+    fp->prefetch({{100000, 50000},
+                  {300000, 20000},
+                  {0, 1000},
+                  {999000, 100000},
+                  {2000000, 10}});
+    std::sort(server.requests.begin(), server.requests.end());
+    const std::vector<std::pair<unsigned long long, size_t>> expected{
+        {6 * 16384, 4 * 16384}, {18 * 16384, 2 * 16384}, {60 * 16384, 2 * 16384}};
+    EXPECT_EQ(server.requests, expected);
+    server.requests.clear();
+
+    // Reading the prefetched ranges must not trigger network requests
+    std::vector<unsigned char> buffer(50000);
+    ASSERT_TRUE(fp->seek(100000));
+    ASSERT_EQ(fp->read(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(),
+                           server.content.begin() + 100000));
+    ASSERT_TRUE(fp->seek(999000));
+    ASSERT_EQ(fp->read(buffer.data(), buffer.size()), 1000U);
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + 1000,
+                           server.content.begin() + 999000));
+    EXPECT_TRUE(server.requests.empty());
+
+    // Already cached chunks are not requested again
+    fp->prefetch({{100000, 50000}});
+    EXPECT_TRUE(server.requests.empty());
+
+    fp.reset();
+    proj_context_destroy(ctx);
+}
+
 } // namespace
@@ -139,6 +139,38 @@ TEST(operation, geogCRS_to_geogCRS_context_default) {
 
 // ---------------------------------------------------------------------------
 
+TEST(operation, geogCRS_to_geogCRS_context_thread_count) {
+    auto authFactory =
+        AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    const auto getResults = [&authFactory](int threadCount) {
+        auto ctxt =
+            CoordinateOperationContext::create(authFactory, nullptr, 0.0);
+        ctxt->setSpatialCriterion(
+            CoordinateOperationContext::SpatialCriterion::PARTIAL_INTERSECTION);
+        ctxt->setGridAvailabilityUse(
+            CoordinateOperationContext::GridAvailabilityUse::
+                IGNORE_GRID_AVAILABILITY);
+        ctxt->setThreadCount(threadCount);
+        EXPECT_EQ(ctxt->getThreadCount(), threadCount);
+        auto list = CoordinateOperationFactory::create()->createOperations(
+            authFactory->createCoordinateReferenceSystem("4267"), // NAD27
+            authFactory->createCoordinateReferenceSystem("4326"), // WGS 84
+            ctxt);
+        std::vector<std::string> res;
+        for (const auto &op : list) {
+            res.emplace_back(op->nameStr());
+        }
+        return res;
+    };
+
+    const auto resSerial = getResults(1);
+    EXPECT_GT(resSerial.size(), 10U);
+    EXPECT_EQ(getResults(4), resSerial);
+    EXPECT_EQ(getResults(0), resSerial);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(operation, geogCRS_to_geogCRS_context_match_by_name) {
     auto authFactory =
         AuthorityFactory::create(DatabaseContext::create(), "EPSG");
@@ -275,4 +275,209 @@ TEST(tinshift, basic) {
     }
 }
 
+// ---------------------------------------------------------------------------
+
+TEST(tinshift, binary) {
+    auto jMinValid(getMinValidContent());
+    jMinValid["format_version"] = "1.1";
+    jMinValid["fallback_strategy"] = "nearest_centroid";
+    jMinValid["name"] = "my name";
+    jMinValid["authority"]["name"] = "my authority";
+    jMinValid["links"] = {{{"href", "https://example.com"}, {"rel", "about"}}};
+    jMinValid["transformed_components"] = {"horizontal", "vertical"};
+    jMinValid["vertices_columns"] = {"source_x", "source_y", "target_x",
+                                     "target_y", "offset_z"};
+    jMinValid["vertices"] = {
+        {0, 0, 101, 101, 10}, {0, 1, 100, 101, 20}, {1, 1, 100, 100, 30}};
+
+    const auto jsonStr = jMinValid.dump();
+    const auto binary = TINShiftFile::parse(jsonStr)->toBinary();
+    EXPECT_TRUE(TINShiftFile::isBinary(binary.data(), binary.size()));
+    EXPECT_FALSE(TINShiftFile::isBinary(jsonStr.data(), jsonStr.size()));
+
+    auto f = TINShiftFile::parseBinary(binary.data(), binary.size());
+    EXPECT_EQ(f->fileType(), "triangulation_file");
+    EXPECT_EQ(f->formatVersion(), "1.1");
+    EXPECT_EQ(f->name(), "my name");
+    EXPECT_EQ(f->authority().name, "my authority");
+    ASSERT_EQ(f->links().size(), 1U);
+    EXPECT_EQ(f->links()[0].href, "https://example.com");
+    EXPECT_EQ(f->inputCRS(), "EPSG:2393");
+    EXPECT_EQ(f->outputCRS(), "EPSG:3067");
+    EXPECT_EQ(f->fallbackStrategy(), FALLBACK_NEAREST_CENTROID);
+    EXPECT_TRUE(f->transformHorizontalComponent());
+    EXPECT_TRUE(f->transformVerticalComponent());
+    EXPECT_EQ(f->verticesColumnCount(), 5U);
+    EXPECT_EQ(f->vertices().size(), 15U);
+    EXPECT_EQ(f->vertices()[14], 30.0);
+    ASSERT_EQ(f->triangles().size(), 1U);
+    EXPECT_EQ(f->triangles()[0].idx3, 2U);
+    EXPECT_EQ(f->toBinary(), binary);
+
+    Evaluator eval(std::move(f));
+    eval.buildSpatialIndices();
+    // A copy shares the file and spatial indices
+    Evaluator evalCopy(eval);
+    double x_out = 0;
+    double y_out = 0;
+    double z_out = 0;
+    EXPECT_TRUE(evalCopy.forward(0.5, 0.75, 1000.0, x_out, y_out, z_out));
+    EXPECT_EQ(x_out, 100.25);
+    EXPECT_EQ(y_out, 100.5);
+    EXPECT_EQ(z_out, 1000.0 + 0.25 * 10 + 0.25 * 20 + 0.5 * 30);
+    EXPECT_TRUE(evalCopy.inverse(100.25, 100.5, z_out, x_out, y_out, z_out));
+    EXPECT_NEAR(x_out, 0.5, 1e-12);
+    EXPECT_NEAR(y_out, 0.75, 1e-12);
+    EXPECT_NEAR(z_out, 1000.0, 1e-9);
+
+    // Truncated content
+    EXPECT_THROW(TINShiftFile::parseBinary(binary.data(), 20),
+                 ParsingException);
+    EXPECT_THROW(TINShiftFile::parseBinary(binary.data(), binary.size() - 1),
+                 ParsingException);
+
+    // Extra content
+    {
+        auto modified(binary);
+        modified += std::string(12, '\0');
+        EXPECT_THROW(
+            TINShiftFile::parseBinary(modified.data(), modified.size()),
+            ParsingException);
+    }
+
+    // Invalid vertex index
+    {
+        auto modified(binary);
+        modified[modified.size() - 4] = 3;
+        EXPECT_THROW(
+            TINShiftFile::parseBinary(modified.data(), modified.size()),
+            ParsingException);
+    }
+
+    // Unsupported version
+    {
+        auto modified(binary);
+        modified[8] = 2;
+        EXPECT_THROW(
+            TINShiftFile::parseBinary(modified.data(), modified.size()),
+            ParsingException);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(tinshift, fallback_large_triangulation) {
+    // Regular triangulation of [0,20]x[0,20], with target = 2 * source + 1,
+    // so that any triangle extrapolates to the same value
+    constexpr int N = 20;
+    json j;
+    j["file_type"] = "triangulation_file";
+    j["format_version"] = "1.1";
+    j["transformed_components"] = {"horizontal"};
+    j["vertices_columns"] = {"source_x", "source_y", "target_x", "target_y"};
+    j["triangles_columns"] = {"idx_vertex1", "idx_vertex2", "idx_vertex3"};
+    json jVertices = json::array();
+    for (int iy = 0; iy <= N; ++iy) {
+        for (int ix = 0; ix <= N; ++ix) {
+            jVertices.push_back({ix, iy, 2 * ix + 1, 2 * iy + 1});
+        }
+    }
+    json jTriangles = json::array();
+    for (int iy = 0; iy < N; ++iy) {
+        for (int ix = 0; ix < N; ++ix) {
+            const int idx = iy * (N + 1) + ix;
+            jTriangles.push_back({idx, idx + 1, idx + N + 2});
+            jTriangles.push_back({idx, idx + N + 2, idx + N + 1});
+        }
+    }
+    j["vertices"] = jVertices;
+    j["triangles"] = jTriangles;
+
+    for (const char *strategy : {"nearest_side", "nearest_centroid"}) {
+        j["fallback_strategy"] = strategy;
+        Evaluator eval(TINShiftFile::parse(j.dump()));
+        for (const auto &xy : std::vector<std::pair<double, double>>{
+                 {-1, -1}, {10.5, -3}, {25, 7.25}, {-0.5, 30}, {21, 21}}) {
+            double x_out = 0;
+            double y_out = 0;
+            double z_out = 0;
+            EXPECT_TRUE(
+                eval.forward(xy.first, xy.second, 0, x_out, y_out, z_out))
+                << strategy;
+            EXPECT_NEAR(x_out, 2 * xy.first + 1, 1e-9) << strategy;
+            EXPECT_NEAR(y_out, 2 * xy.second + 1, 1e-9) << strategy;
+            EXPECT_TRUE(eval.inverse(x_out, y_out, 0, x_out, y_out, z_out))
+                << strategy;
+            EXPECT_NEAR(x_out, xy.first, 1e-9) << strategy;
+            EXPECT_NEAR(y_out, xy.second, 1e-9) << strategy;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(quadtree, searchNearest) {
+    using NS_PROJ::QuadTree::QuadTree;
+    using NS_PROJ::QuadTree::RectObj;
+
+    // Small squares on a 10x10 grid, with a gap at (5,5)
+    RectObj globalBounds;
+    globalBounds.maxx = 10;
+    globalBounds.maxy = 10;
+    QuadTree<unsigned> quadtree(globalBounds);
+    std::vector<RectObj> rects;
+    for (unsigned i = 0; i < 100; ++i) {
+        if (i == 55)
+            continue;
+        RectObj rect;
+        rect.minx = (i % 10) + 0.25;
+        rect.miny = (i / 10) + 0.25;
+        rect.maxx = rect.minx + 0.5;
+        rect.maxy = rect.miny + 0.5;
+        quadtree.insert(i, rect);
+        rects.push_back(rect);
+    }
+
+    std::vector<std::pair<unsigned, double>> results;
+    quadtree.searchNearestBounds(5.5, 5.5, 1, results);
+    ASSERT_EQ(results.size(), 1U);
+    // 4 squares are at the same distance: the smallest index wins
+    EXPECT_EQ(results[0].first, 45U);
+    EXPECT_EQ(results[0].second, 0.75 * 0.75);
+
+    quadtree.searchNearestBounds(5.5, 5.5, 4, results);
+    ASSERT_EQ(results.size(), 4U);
+    EXPECT_EQ(results[0].first, 45U);
+    EXPECT_EQ(results[1].first, 54U);
+    EXPECT_EQ(results[2].first, 56U);
+    EXPECT_EQ(results[3].first, 65U);
+
+    quadtree.searchNearestBounds(-10, -10, 3, results);
+    ASSERT_EQ(results.size(), 3U);
+    EXPECT_EQ(results[0].first, 0U);
+    EXPECT_EQ(results[1].first, 1U);
+    EXPECT_EQ(results[2].first, 10U);
+
+    quadtree.searchNearestBounds(0, 0, 1000, results);
+    EXPECT_EQ(results.size(), 99U);
+    for (size_t i = 1; i < results.size(); ++i) {
+        EXPECT_LE(results[i - 1].second, results[i].second);
+    }
+
+    // Custom distance: distance to center, ignoring odd features
+    quadtree.searchNearest(
+        9.9, 0.1, 2,
+        [](unsigned feature, const RectObj &rect) {
+            if ((feature % 2) != 0)
+                return std::numeric_limits<double>::infinity();
+            const double dx = (rect.minx + rect.maxx) / 2 - 9.9;
+            const double dy = (rect.miny + rect.maxy) / 2 - 0.1;
+            return dx * dx + dy * dy;
+        },
+        results);
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0].first, 8U);
+    EXPECT_EQ(results[1].first, 18U);
+}
+
 } // namespace
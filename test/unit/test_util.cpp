@@ -28,10 +28,16 @@
 
 #include "gtest_include.h"
 
+#include "proj/internal/snapshot_map.hpp"
 #include "proj/util.hpp"
 
+#include <atomic>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
+using namespace osgeo::proj::internal;
 using namespace osgeo::proj::util;
 
 // ---------------------------------------------------------------------------
@@ -61,3 +67,89 @@ TEST(util, NameFactory2) {
     EXPECT_EQ(fullyqualifiedNS->scope()->name()->scope()->isGlobal(), true);
     EXPECT_EQ(localname->toFullyQualifiedName()->toString(), "bar/foo");
 }
+
+// ---------------------------------------------------------------------------
+
+TEST(util, SnapshotMap) {
+    SnapshotMap<std::string, int> map;
+    int value = 0;
+    EXPECT_FALSE(map.contains("a"));
+    EXPECT_FALSE(map.find("a", value));
+    map.insert("a", 1);
+    const auto snapshot = map.snapshot();
+    map.insert("a", 2);
+    EXPECT_TRUE(map.find("a", value));
+    EXPECT_EQ(value, 2);
+    map.clear();
+    EXPECT_FALSE(map.contains("a"));
+    // Snapshots are immutable
+    ASSERT_EQ(snapshot->size(), 1U);
+    EXPECT_EQ(snapshot->at("a"), 1);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifndef __MINGW32__
+// We need std::thread support
+
+TEST(util, SnapshotMap_concurrent) {
+    // Values are always key * 10, so that readers can check that they never
+    // see a partially inserted entry.
+    SnapshotMap<int, int> map;
+    constexpr int N_KEYS = 200;
+    std::atomic<bool> stop{false};
+    std::atomic<int> nBadValues{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&map, &stop, &nBadValues, i] {
+            int iter = 0;
+            while (!stop) {
+                const int key = (iter++ * 7 + i) % N_KEYS;
+                int value = -1;
+                if (map.find(key, value) && value != key * 10)
+                    ++nBadValues;
+                const auto snapshot = map.snapshot();
+                for (const auto &pair : *snapshot) {
+                    if (pair.second != pair.first * 10)
+                        ++nBadValues;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([&map, i] {
+            for (int iter = 0; iter < 20; iter++) {
+                for (int key = i; key < N_KEYS; key += 2) {
+                    map.insert(key, key * 10);
+                }
+                if (i == 0 && iter % 5 == 4)
+                    map.clear();
+            }
+        });
+    }
+    for (size_t i = 4; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    stop = true;
+    for (size_t i = 0; i < 4; i++) {
+        threads[i].join();
+    }
+    EXPECT_EQ(nBadValues, 0);
+
+    // No insertion is lost once writers are done
+    for (int key = 0; key < N_KEYS; key++) {
+        map.insert(key, key * 10);
+    }
+    for (int i = 0; i < 2; i++) {
+        threads[i] = std::thread([&map, i] {
+            for (int key = i; key < N_KEYS; key += 2) {
+                map.insert(key + N_KEYS, (key + N_KEYS) * 10);
+            }
+        });
+    }
+    for (int i = 0; i < 2; i++) {
+        threads[i].join();
+    }
+    EXPECT_EQ(map.snapshot()->size(), static_cast<size_t>(2 * N_KEYS));
+}
+#endif // __MINGW32__